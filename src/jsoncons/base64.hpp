@@ -0,0 +1,372 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_BASE64_HPP
+#define JSONCONS_BASE64_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "jsoncons/jsoncons_config.hpp"
+#if defined(JSONCONS_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(JSONCONS_HAS_SSSE3)
+#include <tmmintrin.h>
+#endif
+
+namespace jsoncons {
+
+// Number of characters base64_encode writes for length bytes
+inline
+size_t base64_encoded_length(size_t length)
+{
+    return (length + 2) / 3 * 4;
+}
+
+#if defined(JSONCONS_HAS_SSSE3)
+
+// Splits the first 12 bytes of x into 16 six bit values, one per byte
+inline
+__m128i base64_encode_split(__m128i x)
+{
+    x = _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    __m128i t1 = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t0, t1);
+}
+
+// Maps six bit values to base64 characters by adding an offset, picked from a 
+// 16 entry table by the range the value falls in
+inline
+__m128i base64_encode_lookup(__m128i values)
+{
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    __m128i row = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    row = _mm_or_si128(row, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), values), _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, row), values);
+}
+
+#if defined(JSONCONS_HAS_AVX2)
+inline
+__m256i base64_encode_split(__m256i x)
+{
+    x = _mm256_shuffle_epi8(x, _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)));
+    __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t0, t1);
+}
+
+inline
+__m256i base64_encode_lookup(__m256i values)
+{
+    const __m256i offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                                      '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0));
+    __m256i row = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    row = _mm256_or_si256(row, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values), _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, row), values);
+}
+#endif
+
+// Encodes whole blocks of 12 bytes (24 with AVX2) while a full vector can be 
+// loaded, and returns the number of bytes consumed
+inline
+size_t base64_encode_blocks(const uint8_t* p, size_t length, char* out)
+{
+    size_t i = 0;
+#if defined(JSONCONS_HAS_AVX2)
+    for (; length - i >= 28; i += 24, out += 32)
+    {
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 12)), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), base64_encode_lookup(base64_encode_split(x)));
+    }
+#endif
+    for (; length - i >= 16; i += 12, out += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64_encode_lookup(base64_encode_split(x)));
+    }
+    return i;
+}
+
+#endif
+
+// Encodes length bytes (the low 8 bits of each Byte) as padded base64 at out,
+// and returns the end of the output. Input is consumed a 24 bit group at a time,
+// with four groups per iteration, each looked up without branches. Byte sized
+// input and output go through base64_encode_blocks first where SSSE3 is available.
+template <typename Byte, typename Char>
+Char* base64_encode(const Byte* p, size_t length, Char* out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const Byte* end = p + length;
+#if defined(JSONCONS_HAS_SSSE3)
+    if (sizeof(Byte) == 1 && sizeof(Char) == 1)
+    {
+        size_t n = base64_encode_blocks(reinterpret_cast<const uint8_t*>(p), length, reinterpret_cast<char*>(out));
+        p += n;
+        out += n / 3 * 4;
+    }
+#endif
+    while (end - p >= 12)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t v = (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+                         (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+                          static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+            out[0] = alphabet[v >> 18];
+            out[1] = alphabet[(v >> 12) & 0x3f];
+            out[2] = alphabet[(v >> 6) & 0x3f];
+            out[3] = alphabet[v & 0x3f];
+            p += 3;
+            out += 4;
+        }
+    }
+    while (end - p >= 3)
+    {
+        uint32_t v = (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+                     (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+                      static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+        out[0] = alphabet[v >> 18];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = alphabet[(v >> 6) & 0x3f];
+        out[3] = alphabet[v & 0x3f];
+        p += 3;
+        out += 4;
+    }
+    if (end - p == 1)
+    {
+        uint32_t v = static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16;
+        out[0] = alphabet[v >> 18];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = '=';
+        out[3] = '=';
+        out += 4;
+    }
+    else if (end - p == 2)
+    {
+        uint32_t v = (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+                     (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8);
+        out[0] = alphabet[v >> 18];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = alphabet[(v >> 6) & 0x3f];
+        out[3] = '=';
+        out += 4;
+    }
+    return out;
+}
+
+// Upper bound on the number of bytes base64_decode writes for length characters
+inline
+size_t base64_decoded_length_bound(size_t length)
+{
+    return length / 4 * 3 + 2;
+}
+
+// The 6 bit value of a base64 character, or 0xff for characters outside the alphabet
+template <typename Char>
+uint32_t base64_value(Char c)
+{
+    static const uint8_t values[256] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+        0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+        0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+        0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+    };
+    typedef typename std::make_unsigned<Char>::type unsigned_type;
+    unsigned_type u = static_cast<unsigned_type>(c);
+    return u <= 0xff ? values[u] : 0xff;
+}
+
+#if defined(JSONCONS_HAS_SSSE3)
+
+// Maps 16 base64 characters to their six bit values. Returns false, leaving
+// values unspecified, if any character is outside the alphabet.
+inline
+bool base64_decode_lookup(__m128i x, __m128i& values)
+{
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), x));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), x));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), x));
+    __m128i plus = _mm_cmpeq_epi8(x, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(x, _mm_set1_epi8('/'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+    if (_mm_movemask_epi8(valid) != 0xffff)
+    {
+        return false;
+    }
+    __m128i shift = _mm_or_si128(_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+                                 _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')), 
+                                              _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')), _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+    values = _mm_add_epi8(x, shift);
+    return true;
+}
+
+// Packs 16 six bit values into 12 bytes at the start of the result
+inline
+__m128i base64_decode_pack(__m128i values)
+{
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+#if defined(JSONCONS_HAS_AVX2)
+inline
+bool base64_decode_lookup(__m256i x, __m256i& values)
+{
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), x));
+    __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), x));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), x));
+    __m256i plus = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('+'));
+    __m256i slash = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/'));
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, plus)), slash);
+    if (_mm256_movemask_epi8(valid) != -1)
+    {
+        return false;
+    }
+    __m256i shift = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')), _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+                                    _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')), 
+                                                    _mm256_or_si256(_mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')), _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')))));
+    values = _mm256_add_epi8(x, shift);
+    return true;
+}
+
+// Packs 32 six bit values into 24 bytes at the start of the result
+inline
+__m256i base64_decode_pack(__m256i values)
+{
+    __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    __m256i bytes = _mm256_shuffle_epi8(groups, _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+    return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+}
+#endif
+
+// Decodes whole blocks of 16 characters (32 with AVX2), stopping at the first
+// block with a character outside the alphabet, and returns the number of 
+// characters consumed. Writes only the bytes decoded.
+inline
+size_t base64_decode_blocks(const char* p, size_t length, uint8_t* out)
+{
+    size_t i = 0;
+#if defined(JSONCONS_HAS_AVX2)
+    for (; length - i >= 32; i += 32, out += 24)
+    {
+        __m256i values;
+        if (!base64_decode_lookup(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), values))
+        {
+            break;
+        }
+        __m256i bytes = base64_decode_pack(values);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(bytes, 1));
+    }
+#endif
+    for (; length - i >= 16; i += 16, out += 12)
+    {
+        __m128i values;
+        if (!base64_decode_lookup(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), values))
+        {
+            break;
+        }
+        __m128i bytes = base64_decode_pack(values);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+        uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+        std::memcpy(out + 8, &last, sizeof(last));
+    }
+    return i;
+}
+
+#endif
+
+// Decodes base64 text, padded or unpadded, writing the bytes at out, which must have 
+// room for base64_decoded_length_bound(length). Returns false, with out_length
+// unspecified, if the text is not base64. Whitespace is not accepted.
+// Four characters are combined per step and validated together with one test,
+// after byte sized text goes through base64_decode_blocks where SSSE3 is available.
+template <typename Char, typename Byte>
+bool base64_decode(const Char* p, size_t length, Byte* out, size_t& out_length)
+{
+    if (length > 0 && p[length - 1] == '=')
+    {
+        if (length % 4 != 0)
+        {
+            return false;
+        }
+        --length;
+        if (p[length - 1] == '=')
+        {
+            --length;
+        }
+    }
+    if (length % 4 == 1)
+    {
+        return false;
+    }
+
+    const Char* end = p + length;
+    Byte* first = out;
+    uint32_t invalid = 0;
+#if defined(JSONCONS_HAS_SSSE3)
+    if (sizeof(Char) == 1 && sizeof(Byte) == 1)
+    {
+        size_t n = base64_decode_blocks(reinterpret_cast<const char*>(p), length, reinterpret_cast<uint8_t*>(out));
+        p += n;
+        out += n / 4 * 3;
+    }
+#endif
+    while (end - p >= 4)
+    {
+        uint32_t a = base64_value(p[0]);
+        uint32_t b = base64_value(p[1]);
+        uint32_t c = base64_value(p[2]);
+        uint32_t d = base64_value(p[3]);
+        invalid |= a | b | c | d;
+        uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = static_cast<Byte>(static_cast<uint8_t>(v >> 16));
+        out[1] = static_cast<Byte>(static_cast<uint8_t>(v >> 8));
+        out[2] = static_cast<Byte>(static_cast<uint8_t>(v));
+        p += 4;
+        out += 3;
+    }
+    if (end - p >= 2)
+    {
+        uint32_t a = base64_value(p[0]);
+        uint32_t b = base64_value(p[1]);
+        uint32_t c = end - p == 3 ? base64_value(p[2]) : 0;
+        invalid |= a | b | c;
+        uint32_t v = (a << 18) | (b << 12) | (c << 6);
+        *out++ = static_cast<Byte>(static_cast<uint8_t>(v >> 16));
+        if (end - p == 3)
+        {
+            *out++ = static_cast<Byte>(static_cast<uint8_t>(v >> 8));
+        }
+    }
+    out_length = static_cast<size_t>(out - first);
+    return (invalid & 0x80) == 0;
+}
+
+}
+
+#endif
@@ -17,6 +17,10 @@
 #include <ostream>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <type_traits>
 #include "jsoncons/jsoncons.hpp"
 #include "jsoncons/json_output_handler.hpp"
 #include "jsoncons/output_format.hpp"
@@ -26,13 +30,17 @@ namespace jsoncons {
 template <typename Char,class T> inline
 void serialize(basic_json_output_handler<Char>& os, const T&)
 {
-    os.do_null_value();
+    os.value(null_type());
 }
 
 template <typename Char>
 class json_any_impl
 {
 public:
+    // Storage inside basic_json::any for small values
+    static const size_t small_object_size = 4*sizeof(void*);
+    typedef typename std::aligned_storage<small_object_size>::type small_object_storage;
+
     virtual ~json_any_impl()
     {
     }
@@ -44,6 +52,29 @@ public:
     virtual void to_stream(basic_json_output_handler<Char>& os) const = 0;
 
     virtual json_any_impl<Char>* clone() const = 0;
+
+    // Copies into storage if the value fits there, otherwise onto the heap
+    virtual json_any_impl<Char>* clone_to(small_object_storage*) const
+    {
+        return clone();
+    }
+
+    // Heap bytes taken by this object, zero if unknown
+    virtual size_t memory_usage() const
+    {
+        return 0;
+    }
+};
+
+template <typename Char, class T>
+class typed_json_any;
+
+template <typename Char, class T>
+struct is_small_json_any
+{
+    static const bool value = std::is_trivially_copyable<T>::value &&
+                              sizeof(typed_json_any<Char,T>) <= sizeof(typename json_any_impl<Char>::small_object_storage) &&
+                              std::alignment_of<typed_json_any<Char,T>>::value <= std::alignment_of<typename json_any_impl<Char>::small_object_storage>::value;
 };
 
 template <typename Char, class T>
@@ -57,6 +88,11 @@ public:
     {
     }
 
+    static json_any_impl<Char>* create(const T& value, typename json_any_impl<Char>::small_object_storage* storage)
+    {
+        return create(value, storage, std::integral_constant<bool,is_small_json_any<Char,T>::value>());
+    }
+
     virtual void* data() 
     {
         return &data_;
@@ -72,12 +108,32 @@ public:
         return new typed_json_any<Char,T>(data_);
     }
 
+    virtual json_any_impl<Char>* clone_to(typename json_any_impl<Char>::small_object_storage* storage) const
+    {
+        return create(data_, storage);
+    }
+
     virtual void to_stream(basic_json_output_handler<Char>& os) const
     {
         serialize(os,data_);
     }
 
+    virtual size_t memory_usage() const
+    {
+        return sizeof(typed_json_any<Char,T>);
+    }
+
     T data_;
+private:
+    static json_any_impl<Char>* create(const T& value, typename json_any_impl<Char>::small_object_storage* storage, std::true_type)
+    {
+        return ::new(storage) typed_json_any<Char,T>(value);
+    }
+
+    static json_any_impl<Char>* create(const T& value, typename json_any_impl<Char>::small_object_storage*, std::false_type)
+    {
+        return new typed_json_any<Char,T>(value);
+    }
 };
 
 template <typename Char, class Alloc>
@@ -98,6 +154,11 @@ class json_array;
 template <typename Char>
 class basic_output_format;
 
+struct dynamic_serializer_options;
+
+template <typename Char, class Options = dynamic_serializer_options>
+class basic_json_serializer;
+
 template <typename Char>
 std::basic_string<Char> escape_string(const std::basic_string<Char>& s, const basic_output_format<Char>& format);
 
@@ -133,7 +194,9 @@ namespace value_type
         ulonglong_t,
         bool_t,
         null_t,
-        any_t
+        any_t,
+        number_t,
+        small_number_t
     };
 }
 
@@ -165,22 +228,25 @@ public:
         any(const any& val)
             : content_(nullptr)
         {
-			content_ = val.content_->clone();
+            if (val.content_ != nullptr)
+            {
+                content_ = val.content_->clone_to(&storage_);
+            }
         }
         any(any&& val)
-            : content_(val.content_)
+            : content_(nullptr)
         {
-            val.content_ = nullptr;
+            move_from(val);
         }
 
         template<typename T>
         explicit any(T val, typename std::enable_if<!std::is_same<any, typename std::decay<T>::type>::value,int>::type* = 0)
         {
-    		content_ = new typed_json_any<Char,T>(val);
+    		content_ = typed_json_any<Char,T>::create(val, &storage_);
         }
     	~any()
     	{
-    		delete content_;
+    		destroy();
     	}
         template <typename T>
         const T& cast() const
@@ -197,7 +263,8 @@ public:
 
         any& operator=(any rhs)
         {
-            std::swap(content_,rhs.content_);
+            destroy();
+            move_from(rhs);
             return *this;
         }
 
@@ -206,7 +273,47 @@ public:
             content_->to_stream(os);
         }
 
+        // Heap bytes of the contained value, zero when it is stored inline
+        size_t memory_usage() const
+        {
+            return content_ == nullptr || is_small() ? 0 : content_->memory_usage();
+        }
+
     	json_any_impl<Char>* content_;
+    private:
+        // Small trivially copyable values live in storage_ rather than on the heap
+        bool is_small() const
+        {
+            return static_cast<const void*>(content_) == static_cast<const void*>(&storage_);
+        }
+
+        void destroy()
+        {
+            if (is_small())
+            {
+                content_->~json_any_impl<Char>();
+            }
+            else
+            {
+                delete content_;
+            }
+            content_ = nullptr;
+        }
+
+        void move_from(any& val)
+        {
+            if (val.is_small())
+            {
+                content_ = val.content_->clone_to(&storage_);
+            }
+            else
+            {
+                content_ = val.content_;
+                val.content_ = nullptr;
+            }
+        }
+
+        typename json_any_impl<Char>::small_object_storage storage_;
     };
 
     // Deprecated
@@ -267,6 +374,102 @@ public:
 
     typedef member_type name_value_pair;
 
+    class key
+    {
+    public:
+        friend class json_object_impl<Char,Alloc>;
+
+        explicit key(const std::basic_string<Char>& name)
+            : name_(name), length_(name.length()), hash_(hash_value(name.data(),name.length())), hint_(0)
+        {
+        }
+        explicit key(const Char* p)
+            : name_(p), length_(name_.length()), hash_(hash_value(name_.data(),name_.length())), hint_(0)
+        {
+        }
+        explicit key(const Char* p, size_t length)
+            : name_(p,length), length_(length), hash_(hash_value(p,length)), hint_(0)
+        {
+        }
+        key(const key& other)
+            : name_(other.name_), length_(other.length_), hash_(other.hash_), hint_(other.hint())
+        {
+        }
+
+        key& operator=(const key& other)
+        {
+            name_ = other.name_;
+            length_ = other.length_;
+            hash_ = other.hash_;
+            hint(other.hint());
+            return *this;
+        }
+
+        const std::basic_string<Char>& name() const
+        {
+            return name_;
+        }
+
+        const Char* data() const
+        {
+            return name_.data();
+        }
+
+        size_t length() const
+        {
+            return length_;
+        }
+
+        size_t hash() const
+        {
+            return hash_;
+        }
+
+        bool equals(const Char* p, size_t length) const
+        {
+            // Lengths are compared first, most candidates are rejected there
+            return length == length_ && std::char_traits<Char>::compare(p,name_.data(),length) == 0;
+        }
+
+        friend bool operator==(const key& a, const key& b)
+        {
+            return a.hash_ == b.hash_ && a.equals(b.data(),b.length());
+        }
+
+        friend bool operator!=(const key& a, const key& b)
+        {
+            return !(a == b);
+        }
+
+        // FNV-1a
+        static size_t hash_value(const Char* p, size_t length)
+        {
+            uint64_t h = 14695981039346656037ULL;
+            for (size_t i = 0; i < length; ++i)
+            {
+                h ^= static_cast<uint64_t>(p[i]);
+                h *= 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+    private:
+        size_t hint() const
+        {
+            return hint_.load(std::memory_order_relaxed);
+        }
+
+        void hint(size_t index) const
+        {
+            hint_.store(index,std::memory_order_relaxed);
+        }
+
+        std::basic_string<Char> name_;
+        size_t length_;
+        size_t hash_;
+        // Position of the last match, objects with the same shape usually have the key at the same index
+        mutable std::atomic<size_t> hint_;
+    };
+
     static const basic_json<Char,Alloc> an_object;
     static const basic_json<Char,Alloc> an_array;
     static const basic_json<Char,Alloc> null;
@@ -1072,6 +1275,28 @@ public:
         return temp;
     }
 
+    // A number kept as its text, converted only when its value is requested.
+    // Text that fits in the value is kept there, longer text is allocated
+    // along with room for its converted value.
+    static basic_json<Char,Alloc> make_number(const Char *p, size_t length)
+    {
+        if (!is_number_text(p,length))
+        {
+            JSONCONS_THROW_EXCEPTION("Invalid number");
+        }
+        basic_json<Char,Alloc> temp(value_type::small_number_t);
+        if (length <= small_number_capacity)
+        {
+            std::memcpy(temp.value_.small_number_,p,length*sizeof(Char));
+        }
+        else
+        {
+            temp.type_ = value_type::number_t;
+            temp.value_.number_value_ = create_number_data(p,length);
+        }
+        return temp;
+    }
+
     static basic_json make_array()
     {
         return basic_json<Char, Alloc>(new json_array_impl<Char, Alloc>());
@@ -1131,7 +1356,7 @@ public:
 
     basic_json(const basic_json& val);
 
-    basic_json(basic_json&& val);
+    basic_json(basic_json&& val) JSONCONS_NOEXCEPT;
 
     explicit basic_json(any val);
 
@@ -1195,6 +1420,20 @@ public:
 
     bool operator==(const basic_json<Char,Alloc>& rhs) const;
 
+    bool parallel_equals(const basic_json<Char,Alloc>& rhs, size_t max_threads = std::thread::hardware_concurrency()) const;
+
+    size_t hash() const;
+
+    size_t parallel_hash(size_t max_threads = std::thread::hardware_concurrency()) const;
+
+    json_memory_usage memory_usage() const;
+
+    void memory_usage(json_memory_usage& usage) const;
+
+    void compact();
+
+    void parallel_compact(size_t max_threads = std::thread::hardware_concurrency());
+
     size_t size() const; 
 
     basic_json<Char,Alloc>& operator[](size_t i);
@@ -1222,6 +1461,8 @@ public:
 
     bool has_member(const std::basic_string<Char>& name) const;
 
+    bool has_member(const key& k) const;
+
     template<typename T>
     bool is() const
     {
@@ -1236,7 +1477,7 @@ public:
 
     bool is_numeric() const
     {
-        return type_ == value_type::double_t || type_ == value_type::longlong_t || type_ == value_type::ulonglong_t;
+        return type_ == value_type::double_t || type_ == value_type::longlong_t || type_ == value_type::ulonglong_t || is_lazy_number();
     }
 
     bool is_bool() const
@@ -1261,17 +1502,17 @@ public:
 
     bool is_longlong() const
     {
-        return type_ == value_type::longlong_t;
+        return type_ == value_type::longlong_t || (is_lazy_number() && parsed_number().type_ == value_type::longlong_t);
     }
 
     bool is_ulonglong() const
     {
-        return type_ == value_type::ulonglong_t;
+        return type_ == value_type::ulonglong_t || (is_lazy_number() && parsed_number().type_ == value_type::ulonglong_t);
     }
 
     bool is_double() const
     {
-        return type_ == value_type::double_t;
+        return type_ == value_type::double_t || (is_lazy_number() && parsed_number().type_ == value_type::double_t);
     }
 
     // Deprecated
@@ -1342,8 +1583,17 @@ public:
     basic_json<Char,Alloc>& at(size_t i);
     const basic_json<Char,Alloc>& at(size_t i) const;
 
+    basic_json<Char,Alloc>& at(const key& k);
+    const basic_json<Char,Alloc>& at(const key& k) const;
+
     const basic_json<Char,Alloc>& get(const std::basic_string<Char>& name) const;
 
+    const basic_json<Char,Alloc>& get(const key& k) const;
+
+    // The member with key k, or null if this is not an object or has no such member
+    basic_json<Char,Alloc>* find(const key& k);
+    const basic_json<Char,Alloc>* find(const key& k) const;
+
     template <typename T>
     const_val_proxy get(const std::basic_string<Char>& name, T default_val) const;
 
@@ -1358,6 +1608,13 @@ public:
     void remove_member(const std::basic_string<Char>& name);
     // Removes a member from an object value
 
+    void remove_members(std::vector<std::basic_string<Char>> names);
+    // Removes the members with the names from an object value, in one pass
+
+    void set_members(std::vector<std::pair<std::basic_string<Char>,basic_json<Char,Alloc>>> members);
+    // Sets the members of an object value, moving their values in, with one merge of the 
+    // new names rather than one insertion each. Of members with the same name, the last is kept.
+
     template <typename T>
     void set(const std::basic_string<Char>& name, T value)
     {
@@ -1441,6 +1698,17 @@ public:
 
     void to_stream(basic_json_output_handler<Char>& handler) const;
 
+    // As to_stream(handler), with the event functions of Handler called directly,
+    // so that they can be inlined when Handler is a concrete class such as basic_json_serializer.
+    // Handler must derive from basic_json_output_handler<Char>, through which any values are written.
+    template <class Handler>
+    void walk(Handler& handler) const;
+
+    void parallel_to_stream(std::basic_ostream<Char>& os, const basic_output_format<Char>& format, bool indenting,
+                            size_t max_threads = std::thread::hardware_concurrency()) const;
+
+    void parallel_to_stream(basic_json_serializer<Char>& serializer, size_t max_threads = std::thread::hardware_concurrency()) const;
+
     void swap(basic_json<Char,Alloc>& b)
     {
         using std::swap;
@@ -1452,7 +1720,12 @@ public:
     template <class T>
     std::vector<T> as_vector() const
     {
-        std::vector<T> v(size());
+        std::vector<T> v;
+        if (type_ == value_type::array_t && value_.array_->copy_numbers_to(v))
+        {
+            return v;
+        }
+        v.resize(size());
         json_type_traits<Char,Alloc,T> adapter;
         for (size_t i = 0; i < v.size(); ++i)
         {
@@ -1562,8 +1835,55 @@ public:
     };
 
 private:
+    // The text of a number_t value, and the value it converts to once that has been requested
+    struct number_data
+    {
+        size_t length;
+        Char* p;
+        // One more than the number_text_value kind of the converted value, zero before
+        std::atomic<int> kind;
+        std::atomic<uint64_t> bits;
+    };
+
+    // Characters of number text a small_number_t keeps in place, zero filled after the text
+    static const size_t small_number_capacity = sizeof(double)/sizeof(Char);
+
 	basic_json(value_type::value_type_t t);
 
+    bool is_lazy_number() const
+    {
+        return type_ == value_type::number_t || type_ == value_type::small_number_t;
+    }
+
+    const Char* number_text_data() const
+    {
+        return type_ == value_type::small_number_t ? value_.small_number_ : value_.number_value_->p;
+    }
+
+    size_t number_text_length() const
+    {
+        if (type_ == value_type::number_t)
+        {
+            return value_.number_value_->length;
+        }
+        size_t length = 0;
+        while (length < small_number_capacity && value_.small_number_[length] != 0)
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    basic_json<Char,Alloc> parsed_number() const;
+
+    size_t structural_hash(size_t max_threads) const;
+
+    void destroy_tree();
+
+    basic_json<Char,Alloc>* last_value();
+
+    void drop_last_value();
+
     template<typename Char2, typename Allocator2, size_t size>
     class build_array
     {};
@@ -1630,6 +1950,7 @@ private:
     {
         size_t size = sizeof(string_data) + (other->length+1)*sizeof(Char);
         char* buffer = (char*)::operator new(size);
+        json_allocation_counter::add(size);
         string_data* env = new(buffer)string_data;
         env->length = other->length;
         env->p = new(buffer+sizeof(string_data))Char[other->length+1];
@@ -1642,6 +1963,7 @@ private:
     {
         size_t size = sizeof(string_data) + (s.length()+1)*sizeof(Char);
         char* buffer = (char*)::operator new(size);
+        json_allocation_counter::add(size);
         string_data* env = new(buffer)string_data;
         env->length = s.length();
         env->p = new(buffer+sizeof(string_data))Char[s.length()+1];
@@ -1659,6 +1981,7 @@ private:
     {
         size_t size = sizeof(string_data) + (length+1)*sizeof(Char);
         char* buffer = (char*)::operator new(size);
+        json_allocation_counter::add(size);
         string_data* env = new(buffer)string_data;
         env->length = length;
         env->p = new(buffer+sizeof(string_data))Char[length+1];
@@ -1671,6 +1994,7 @@ private:
     {
         size_t size = sizeof(string_data) + sizeof(Char);
         char* buffer = (char*)::operator new(size);
+        json_allocation_counter::add(size);
         string_data* env = new(buffer)string_data;
         env->length = 0;
         env->p = new(buffer+sizeof(string_data))Char[1];
@@ -1683,6 +2007,36 @@ private:
         return create_string_env(&c,1);
     }
 
+    static number_data* create_number_data(const Char* p, size_t length)
+    {
+        size_t size = sizeof(number_data) + (length+1)*sizeof(Char);
+        char* buffer = (char*)::operator new(size);
+        json_allocation_counter::add(size);
+        number_data* data = new(buffer)number_data;
+        data->length = length;
+        data->p = new(buffer+sizeof(number_data))Char[length+1];
+        memcpy(data->p,p,length*sizeof(Char));
+        data->p[length] = 0;
+        data->kind.store(0, std::memory_order_relaxed);
+        data->bits.store(0, std::memory_order_relaxed);
+        return data;
+    }
+
+    static number_data* create_number_data(const number_data* other)
+    {
+        number_data* data = create_number_data(other->p,other->length);
+        int kind = other->kind.load(std::memory_order_acquire);
+        data->bits.store(other->bits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        data->kind.store(kind, std::memory_order_relaxed);
+        return data;
+    }
+
+    static void delete_number_data(number_data* data)
+    {
+        data->~number_data();
+        ::operator delete((void*)data);
+    }
+
     value_type::value_type_t type_;
     union
     {
@@ -1694,6 +2048,8 @@ private:
         json_array_impl<Char,Alloc>* array_;
         any* any_value_;
         string_data* string_value_;
+        number_data* number_value_;
+        Char small_number_[sizeof(double)/sizeof(Char)];
     } value_;
 };
 
@@ -17,12 +17,24 @@
 #include <algorithm>
 #include <fstream>
 #include <limits>
+#include <type_traits>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 #include "jsoncons/json1.hpp"
+#include "jsoncons/output_sink.hpp"
+#include "jsoncons/base64.hpp"
 #include "jsoncons/json_type_traits.hpp"
 #include "jsoncons/json_structures.hpp"
 #include "jsoncons/json_reader.hpp"
 #include "jsoncons/json_deserializer.hpp"
 #include "jsoncons/json_serializer.hpp"
+#if defined(JSONCONS_HAS_SSE2)
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -89,12 +101,16 @@ basic_json<Char, Alloc>::basic_json(const basic_json<Char, Alloc>& val)
     case value_type::longlong_t:
     case value_type::ulonglong_t:
     case value_type::bool_t:
+    case value_type::small_number_t:
         value_ = val.value_;
         break;
     case value_type::string_t:
     case value_type::binary_t:
         value_.string_value_ = create_string_env(val.value_.string_value_);
         break;
+    case value_type::number_t:
+        value_.number_value_ = create_number_data(val.value_.number_value_);
+        break;
     case value_type::array_t:
         value_.array_ = val.value_.array_->clone();
         break;
@@ -238,6 +254,15 @@ basic_json<Char, Alloc>::basic_json(value_type::value_type_t t)
     case value_type::binary_t:
         value_.string_value_ = create_string_env();
         break;
+    case value_type::number_t:
+        {
+            Char c = 0;
+            value_.number_value_ = create_number_data(&c,0);
+        }
+        break;
+    case value_type::small_number_t:
+        std::memset(value_.small_number_,0,sizeof(value_.small_number_));
+        break;
     case value_type::array_t:
         value_.array_ = new json_array_impl<Char, Alloc>();
         break;
@@ -250,6 +275,64 @@ basic_json<Char, Alloc>::basic_json(value_type::value_type_t t)
     }
 }
 
+// Text kept in place is short enough to convert each time, the conversion of
+// longer text is cached with it the first time. Threads that convert at once
+// store the same value.
+template<typename Char, typename Alloc>
+basic_json<Char, Alloc> basic_json<Char, Alloc>::parsed_number() const
+{
+    number_data* data = type_ == value_type::number_t ? value_.number_value_ : nullptr;
+    if (data != nullptr)
+    {
+        int kind = data->kind.load(std::memory_order_acquire);
+        if (kind != 0)
+        {
+            uint64_t bits = data->bits.load(std::memory_order_relaxed);
+            switch (kind - 1)
+            {
+            case number_text_value::longlong_kind:
+                return make_integer(static_cast<long long>(bits));
+            case number_text_value::ulonglong_kind:
+                return make_unsigned(bits);
+            default:
+                {
+                    double d;
+                    std::memcpy(&d,&bits,sizeof(double));
+                    return make_float(d);
+                }
+            }
+        }
+    }
+    number_text_value val = parse_number_text(number_text_data(),number_text_length());
+    uint64_t bits;
+    switch (val.kind)
+    {
+    case number_text_value::longlong_kind:
+        bits = static_cast<uint64_t>(val.longlong_value);
+        break;
+    case number_text_value::ulonglong_kind:
+        bits = val.ulonglong_value;
+        break;
+    default:
+        std::memcpy(&bits,&val.double_value,sizeof(double));
+        break;
+    }
+    if (data != nullptr)
+    {
+        data->bits.store(bits, std::memory_order_relaxed);
+        data->kind.store(static_cast<int>(val.kind) + 1, std::memory_order_release);
+    }
+    switch (val.kind)
+    {
+    case number_text_value::longlong_kind:
+        return make_integer(val.longlong_value);
+    case number_text_value::ulonglong_kind:
+        return make_unsigned(val.ulonglong_value);
+    default:
+        return make_float(val.double_value);
+    }
+}
+
 template<typename Char, typename Alloc>
 basic_json<Char, Alloc>::~basic_json()
 {
@@ -267,11 +350,12 @@ basic_json<Char, Alloc>::~basic_json()
         //delete value_.string_wrapper_;
         delete_string_env(value_.string_value_);
         break;
-    case value_type::array_t:
-        delete value_.array_;
+    case value_type::number_t:
+        delete_number_data(value_.number_value_);
         break;
+    case value_type::array_t:
     case value_type::object_t:
-        delete value_.object_;
+        destroy_tree();
         break;
     case value_type::any_t:
         delete value_.any_value_;
@@ -279,6 +363,91 @@ basic_json<Char, Alloc>::~basic_json()
     }
 }
 
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::destroy_tree()
+{
+    // Destroys nested arrays and objects without recursion and without
+    // allocating. The walk goes down through the last value of each container,
+    // keeping the way back up in the slot it came from, and drops values from
+    // the end once they are leaves, so each delete only frees leaves.
+    if (last_value() == nullptr)
+    {
+        if (type_ == value_type::array_t)
+        {
+            delete value_.array_;
+        }
+        else
+        {
+            delete value_.object_;
+        }
+        return;
+    }
+    basic_json<Char,Alloc> current(std::move(*this));
+    basic_json<Char,Alloc> parent;
+    size_t depth = 0;
+    for (;;)
+    {
+        basic_json<Char,Alloc>* last = current.last_value();
+        if (last != nullptr)
+        {
+            if (last->last_value() == nullptr)
+            {
+                current.drop_last_value();
+            }
+            else
+            {
+                basic_json<Char,Alloc> child(std::move(*last));
+                last->swap(parent);
+                parent.swap(current);
+                current.swap(child);
+                ++depth;
+            }
+        }
+        else if (depth > 0)
+        {
+            basic_json<Char,Alloc> done(std::move(current));
+            current.swap(parent);
+            parent.swap(*current.last_value());
+            current.drop_last_value();
+            --depth;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+template<typename Char, typename Alloc>
+basic_json<Char,Alloc>* basic_json<Char, Alloc>::last_value()
+{
+    switch (type_)
+    {
+    case value_type::array_t:
+        return value_.array_->last_value();
+    case value_type::object_t:
+        return value_.object_->last_value();
+    default:
+        return nullptr;
+    }
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::drop_last_value()
+{
+    switch (type_)
+    {
+    case value_type::array_t:
+        value_.array_->drop_last_value();
+        break;
+    case value_type::object_t:
+        value_.object_->drop_last_value();
+        break;
+    default:
+        break;
+    }
+}
+
 template<typename Char, class Alloc>
 void basic_json<Char, Alloc>::assign_any(const typename basic_json<Char,Alloc>::any& rhs)
 {
@@ -487,9 +656,134 @@ bool basic_json<Char, Alloc>::operator!=(const basic_json<Char, Alloc>& rhs) con
     return !(*this == rhs);
 }
 
+template<typename Char, typename Alloc>
+bool basic_json<Char, Alloc>::parallel_equals(const basic_json<Char, Alloc>& rhs, size_t max_threads) const
+{
+    if (type_ == value_type::array_t && rhs.type_ == value_type::array_t)
+    {
+        return value_.array_->equals(*(rhs.value_.array_), max_threads);
+    }
+    if (type_ == value_type::object_t && rhs.type_ == value_type::object_t)
+    {
+        return value_.object_->equals(*(rhs.value_.object_), max_threads);
+    }
+    return *this == rhs;
+}
+
+template<typename Char, typename Alloc>
+json_memory_usage basic_json<Char, Alloc>::memory_usage() const
+{
+    json_memory_usage usage;
+    memory_usage(usage);
+    return usage;
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::memory_usage(json_memory_usage& usage) const
+{
+    switch (type_)
+    {
+    case value_type::string_t:
+    case value_type::binary_t:
+        usage.strings += sizeof(string_data) + (value_.string_value_->length+1)*sizeof(Char);
+        break;
+    case value_type::number_t:
+        usage.strings += sizeof(number_data) + (value_.number_value_->length+1)*sizeof(Char);
+        break;
+    case value_type::array_t:
+        value_.array_->memory_usage(usage);
+        break;
+    case value_type::object_t:
+        value_.object_->memory_usage(usage);
+        break;
+    case value_type::any_t:
+        usage.anys += sizeof(any) + value_.any_value_->memory_usage();
+        break;
+    default:
+        break;
+    }
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::compact()
+{
+    parallel_compact(1);
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::parallel_compact(size_t max_threads)
+{
+    switch (type_)
+    {
+    case value_type::array_t:
+        value_.array_->compact(max_threads);
+        break;
+    case value_type::object_t:
+        value_.object_->compact(max_threads);
+        break;
+    default:
+        break;
+    }
+}
+
+template<typename Char, typename Alloc>
+size_t basic_json<Char, Alloc>::hash() const
+{
+    return structural_hash(1);
+}
+
+template<typename Char, typename Alloc>
+size_t basic_json<Char, Alloc>::parallel_hash(size_t max_threads) const
+{
+    return structural_hash(max_threads);
+}
+
+template<typename Char, typename Alloc>
+size_t basic_json<Char, Alloc>::structural_hash(size_t max_threads) const
+{
+    switch (type_)
+    {
+    case value_type::string_t:
+        return static_cast<size_t>(mix_hash(key::hash_value(value_.string_value_->p,value_.string_value_->length)));
+    case value_type::binary_t:
+        return static_cast<size_t>(mix_hash(key::hash_value(value_.string_value_->p,value_.string_value_->length) + 1));
+    case value_type::double_t:
+        return hash_number(value_.float_value_);
+    case value_type::longlong_t:
+        return hash_number(static_cast<double>(value_.si_value_));
+    case value_type::ulonglong_t:
+        return hash_number(static_cast<double>(value_.ui_value_));
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().structural_hash(max_threads);
+    case value_type::bool_t:
+        return value_.bool_value_ ? 0x74727565 : 0x66616c73;
+    case value_type::null_t:
+        return 0x6e756c6c;
+    case value_type::empty_object_t:
+        return json_object_impl<Char, Alloc>::empty_hash();
+    case value_type::object_t:
+        return static_cast<const json_object_impl<Char, Alloc>*>(value_.object_)->hash(max_threads);
+    case value_type::array_t:
+        return static_cast<const json_array_impl<Char, Alloc>*>(value_.array_)->hash(max_threads);
+    default:
+        return 0x616e79;
+    }
+}
+
 template<typename Char, typename Alloc>
 bool basic_json<Char, Alloc>::operator==(const basic_json<Char, Alloc>& rhs) const
 {
+    if (is_lazy_number() || rhs.is_lazy_number())
+    {
+        if (is_lazy_number() && rhs.is_lazy_number() && number_text_length() == rhs.number_text_length() && 
+            std::char_traits<Char>::compare(number_text_data(),rhs.number_text_data(),number_text_length()) == 0)
+        {
+            return true;
+        }
+        return (is_lazy_number() ? parsed_number() : *this) == 
+               (rhs.is_lazy_number() ? rhs.parsed_number() : rhs);
+    }
     if (is_number() && rhs.is_number())
     {
         switch (type_)
@@ -577,7 +871,7 @@ const basic_json<Char, Alloc>& basic_json<Char, Alloc>::at(size_t i) const
     switch (type_)
     {
     case value_type::array_t:
-        return value_.array_->at(i);
+        return static_cast<const json_array_impl<Char, Alloc>*>(value_.array_)->at(i);
     default:
         JSONCONS_THROW_EXCEPTION("Index on non-array value not supported");
     }
@@ -615,6 +909,78 @@ const basic_json<Char, Alloc>& basic_json<Char, Alloc>::at(const std::basic_stri
     }
 }
 
+template<typename Char, typename Alloc>
+basic_json<Char, Alloc>& basic_json<Char, Alloc>::at(const key& k)
+{
+    switch (type_)
+    {
+    case value_type::empty_object_t:
+        JSONCONS_THROW_EXCEPTION_1("%s not found", k.name());
+    case value_type::object_t:
+        return value_.object_->get(k);
+    default:
+        {
+            JSONCONS_THROW_EXCEPTION_1("Attempting to get %s from a value that is not an object", k.name());
+        }
+    }
+}
+
+template<typename Char, typename Alloc>
+const basic_json<Char, Alloc>& basic_json<Char, Alloc>::at(const key& k) const
+{
+    switch (type_)
+    {
+    case value_type::empty_object_t:
+        JSONCONS_THROW_EXCEPTION_1("%s not found", k.name());
+    case value_type::object_t:
+        {
+            const json_object_impl<Char,Alloc>* obj = value_.object_;
+            return obj->get(k);
+        }
+    default:
+        {
+            JSONCONS_THROW_EXCEPTION_1("Attempting to get %s from a value that is not an object", k.name());
+        }
+    }
+}
+
+template<typename Char, typename Alloc>
+const basic_json<Char, Alloc>& basic_json<Char, Alloc>::get(const key& k) const
+{
+    switch (type_)
+    {
+    case value_type::empty_object_t:
+        return basic_json<Char, Alloc>::null;
+    case value_type::object_t:
+        {
+            const json_object_impl<Char,Alloc>* obj = value_.object_;
+            const basic_json<Char, Alloc>* val = obj->find_value(k);
+            return val != nullptr ? *val : basic_json<Char, Alloc>::null;
+        }
+    default:
+        {
+            JSONCONS_THROW_EXCEPTION_1("Attempting to get %s from a value that is not an object", k.name());
+        }
+    }
+}
+
+template<typename Char, typename Alloc>
+basic_json<Char, Alloc>* basic_json<Char, Alloc>::find(const key& k)
+{
+    return type_ == value_type::object_t ? value_.object_->find_value(k) : nullptr;
+}
+
+template<typename Char, typename Alloc>
+const basic_json<Char, Alloc>* basic_json<Char, Alloc>::find(const key& k) const
+{
+    if (type_ != value_type::object_t)
+    {
+        return nullptr;
+    }
+    const json_object_impl<Char,Alloc>* obj = value_.object_;
+    return obj->find_value(k);
+}
+
 template<typename Char, typename Alloc>
 const basic_json<Char, Alloc>& basic_json<Char, Alloc>::get(const std::basic_string<Char>& name) const
 {
@@ -682,7 +1048,7 @@ void basic_json<Char, Alloc>::set(const std::basic_string<Char>& name, const bas
 }
 
 template<typename Char, typename Alloc>
-basic_json<Char, Alloc>::basic_json(basic_json&& other){
+basic_json<Char, Alloc>::basic_json(basic_json&& other) JSONCONS_NOEXCEPT{
     type_ = other.type_;
     value_ = other.value_;
     other.type_ = value_type::null_t;
@@ -792,6 +1158,57 @@ void basic_json<Char, Alloc>::remove_member(const std::basic_string<Char>& name)
     }
 }
 
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::remove_members(std::vector<std::basic_string<Char>> names)
+{
+    switch (type_)
+    {
+    case value_type::object_t:
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        value_.object_->remove_sorted(names);
+        break;
+    default:
+        break;
+    }
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::set_members(std::vector<std::pair<std::basic_string<Char>,basic_json<Char,Alloc>>> members)
+{
+    switch (type_)
+    {
+    case value_type::empty_object_t:
+        type_ = value_type::object_t;
+        value_.object_ = new json_object_impl<Char,Alloc>();
+        // Falls through
+    case value_type::object_t:
+        {
+            std::stable_sort(members.begin(), members.end(), member_compare<Char,Alloc>());
+            // Keep the last of each run of equal names
+            size_t k = 0;
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                if (i + 1 < members.size() && members[i].first == members[i+1].first)
+                {
+                    continue;
+                }
+                if (k != i)
+                {
+                    members[k].first.swap(members[i].first);
+                    members[k].second.swap(members[i].second);
+                }
+                ++k;
+            }
+            members.resize(k);
+            value_.object_->set_sorted(members);
+        }
+        break;
+    default:
+        JSONCONS_THROW_EXCEPTION("Attempting to set members on a value that is not an object");
+    }
+}
+
 template<typename Char, typename Alloc>
 void basic_json<Char, Alloc>::add(const basic_json<Char, Alloc>& value)
 {
@@ -898,26 +1315,55 @@ const basic_json<Char, Alloc>& basic_json<Char, Alloc>::operator[](size_t i) con
     return at(i);
 }
 
+// Serializes val with the serializer compiled for the escape and indenting choices.
+// Output is a std::basic_ostream<Char> or a basic_output_sink<Char>
+template <typename Char, class Alloc, class Output>
+void serialize_with_options(const basic_json<Char,Alloc>& val, Output& out, const basic_output_format<Char>& format, bool indenting)
+{
+    if (format.escape_solidus() || format.escape_all_non_ascii())
+    {
+        basic_json_serializer<Char> serializer(out, format, indenting);
+        val.walk(serializer);
+    }
+    else if (indenting)
+    {
+        basic_json_serializer<Char,static_serializer_options<true>> serializer(out, format);
+        val.walk(serializer);
+    }
+    else
+    {
+        basic_json_serializer<Char,static_serializer_options<false>> serializer(out, format);
+        val.walk(serializer);
+    }
+}
+
 template<typename Char, typename Alloc>
 std::basic_string<Char> basic_json<Char, Alloc>::to_string() const
 {
-    std::basic_ostringstream<Char> os;
-    basic_json_serializer<Char> serializer(os);
-    to_stream(serializer);
-    return os.str();
+    std::basic_string<Char> s;
+    basic_string_sink<Char> sink(s);
+    serialize_with_options(*this, sink, basic_output_format<Char>(), false);
+    return s;
 }
 
 template<typename Char, typename Alloc>
 std::basic_string<Char> basic_json<Char, Alloc>::to_string(const basic_output_format<Char>& format) const
 {
-    std::basic_ostringstream<Char> os;
-    basic_json_serializer<Char> serializer(os, format);
-    to_stream(serializer);
-    return os.str();
+    std::basic_string<Char> s;
+    basic_string_sink<Char> sink(s);
+    serialize_with_options(*this, sink, format, false);
+    return s;
 }
 
 template<typename Char, typename Alloc>
 void basic_json<Char, Alloc>::to_stream(basic_json_output_handler<Char>& handler) const
+{
+    walk(handler);
+}
+
+template<typename Char, typename Alloc>
+template<class Handler>
+void basic_json<Char, Alloc>::walk(Handler& handler) const
 {
     switch (type_)
     {
@@ -927,6 +1373,10 @@ void basic_json<Char, Alloc>::to_stream(basic_json_output_handler<Char>& handler
     case value_type::binary_t:
         handler.binary(value_.string_value_->p,value_.string_value_->length);
         break;
+    case value_type::number_t:
+    case value_type::small_number_t:
+        handler.number(number_text_data(),number_text_length());
+        break;
     case value_type::double_t:
         handler.value(value_.float_value_);
         break;
@@ -953,20 +1403,23 @@ void basic_json<Char, Alloc>::to_stream(basic_json_output_handler<Char>& handler
             for (const_object_iterator it = o->begin(); it != o->end(); ++it)
             {
                 handler.name((it->name()).c_str(),it->name().length());
-                it->value().to_stream(handler);
+                it->value().walk(handler);
             }
             handler.end_object();
         }
         break;
     case value_type::array_t:
         {
-            handler.begin_array();
-            json_array_impl<Char, Alloc> *o = value_.array_;
-            for (const_array_iterator it = o->begin(); it != o->end(); ++it)
+            const json_array_impl<Char, Alloc> *o = value_.array_;
+            if (!o->numbers_to_stream(handler))
             {
-                it->to_stream(handler);
+                handler.begin_array();
+                for (const_array_iterator it = o->begin(); it != o->end(); ++it)
+                {
+                    it->walk(handler);
+                }
+                handler.end_array();
             }
-            handler.end_array();
         }
         break;
     case value_type::any_t:
@@ -978,25 +1431,212 @@ void basic_json<Char, Alloc>::to_stream(basic_json_output_handler<Char>& handler
     }
 }
 
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::parallel_to_stream(std::basic_ostream<Char>& os, const basic_output_format<Char>& format, bool indenting, size_t max_threads) const
+{
+    basic_json_serializer<Char> serializer(os, format, indenting);
+    parallel_to_stream(serializer, max_threads);
+}
+
+template<typename Char, typename Alloc>
+void basic_json<Char, Alloc>::parallel_to_stream(basic_json_serializer<Char>& serializer, size_t max_threads) const
+{
+    const bool is_obj = type_ == value_type::object_t;
+    const bool is_arr = type_ == value_type::array_t && !value_.array_->has_contiguous_numbers();
+    if (!is_obj && !is_arr)
+    {
+        to_stream(serializer);
+        return;
+    }
+    const size_t n = is_obj ? value_.object_->size() : value_.array_->size();
+    const size_t min_chunk_size = 1024;
+    const size_t threads = (std::min)(max_threads, n / min_chunk_size);
+    if (threads <= 1)
+    {
+        to_stream(serializer);
+        return;
+    }
+
+    // The elements or members are split into many more chunks than threads. This 
+    // thread writes the first chunk straight to serializer, while worker threads 
+    // format the others, each into its own string. The strings are written out in 
+    // order as they complete, and a worker waits rather than start a chunk more 
+    // than window chunks ahead of the last one written, which bounds the memory held.
+    const size_t chunk_size = (std::max)(min_chunk_size, n / (threads * 32));
+    const size_t chunks = (n + chunk_size - 1) / chunk_size;
+    const size_t window = 2 * threads;
+
+    struct fragment
+    {
+        fragment()
+            : ready(false), content_indented(false)
+        {
+        }
+        bool ready;
+        bool content_indented;
+        std::basic_string<Char> text;
+    };
+    std::vector<fragment> fragments(window);
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next = 1;
+    size_t written = 1;
+    bool stop = false;
+    std::exception_ptr error;
+
+    const json_object_impl<Char,Alloc>* o = value_.object_;
+    const json_array_impl<Char,Alloc>* a = value_.array_;
+    auto write_chunk = [=](basic_json_serializer<Char>& s, size_t i)
+    {
+        const size_t last = (std::min)(n, (i + 1) * chunk_size);
+        for (size_t j = i * chunk_size; j < last; ++j)
+        {
+            if (is_obj)
+            {
+                const auto& member = o->get(j);
+                s.name(member.first.data(), member.first.length());
+                member.second.walk(s);
+            }
+            else
+            {
+                a->at(j).walk(s);
+            }
+        }
+    };
+
+    if (is_obj)
+    {
+        serializer.begin_object();
+    }
+    else
+    {
+        serializer.begin_array();
+    }
+
+    // The state of serializer inside the structure, for the workers to start 
+    // their fragments from while serializer itself moves on
+    std::basic_string<Char> unused;
+    basic_string_sink<Char> unused_sink(unused);
+    basic_json_serializer<Char> parent(unused_sink, serializer.format_, serializer.indenting_);
+    parent.begin_fragment(serializer, 0);
+
+    auto work = [&]()
+    {
+        for (;;)
+        {
+            size_t i;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]{return stop || next >= chunks || next < written + window;});
+                if (stop || next >= chunks)
+                {
+                    return;
+                }
+                i = next++;
+            }
+            std::basic_string<Char> text;
+            bool content_indented = false;
+            try
+            {
+                basic_string_sink<Char> sink(text);
+                basic_json_serializer<Char> fragment_serializer(sink, parent.format_, parent.indenting_);
+                fragment_serializer.begin_fragment(parent, i * chunk_size);
+                write_chunk(fragment_serializer, i);
+                content_indented = fragment_serializer.end_fragment();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                stop = true;
+                changed.notify_all();
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            fragment& frag = fragments[i % window];
+            frag.text.swap(text);
+            frag.content_indented = content_indented;
+            frag.ready = true;
+            changed.notify_all();
+        }
+    };
+    std::vector<std::future<void>> workers;
+    try
+    {
+        for (size_t k = 1; k < threads; ++k)
+        {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+        write_chunk(serializer, 0);
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            fragment& frag = fragments[i % window];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]{return frag.ready || stop;});
+                if (!frag.ready)
+                {
+                    break;
+                }
+            }
+            size_t count = (std::min)(n, (i + 1) * chunk_size) - i * chunk_size;
+            serializer.append_fragment(frag.text, count, frag.content_indented);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::basic_string<Char>().swap(frag.text);
+            frag.ready = false;
+            written = i + 1;
+            changed.notify_all();
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            changed.notify_all();
+        }
+        for (size_t k = 0; k < workers.size(); ++k)
+        {
+            workers[k].wait();
+        }
+        throw;
+    }
+    for (size_t k = 0; k < workers.size(); ++k)
+    {
+        workers[k].get();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    if (is_obj)
+    {
+        serializer.end_object();
+    }
+    else
+    {
+        serializer.end_array();
+    }
+}
+
 template<typename Char, typename Alloc>
 void basic_json<Char, Alloc>::to_stream(std::basic_ostream<Char>& os) const
 {
-    basic_json_serializer<Char> serializer(os);
-    to_stream(serializer);
+    serialize_with_options(*this, os, basic_output_format<Char>(), false);
 }
 
 template<typename Char, typename Alloc>
 void basic_json<Char, Alloc>::to_stream(std::basic_ostream<Char>& os, const basic_output_format<Char>& format) const
 {
-    basic_json_serializer<Char> serializer(os, format);
-    to_stream(serializer);
+    serialize_with_options(*this, os, format, false);
 }
 
 template<typename Char, typename Alloc>
 void basic_json<Char, Alloc>::to_stream(std::basic_ostream<Char>& os, const basic_output_format<Char>& format, bool indenting) const
 {
-    basic_json_serializer<Char> serializer(os, format, indenting);
-    to_stream(serializer);
+    serialize_with_options(*this, os, format, indenting);
 }
 
 template<typename Char, typename Alloc>
@@ -1084,7 +1724,7 @@ template<typename Char, typename Alloc>
 basic_json<Char, Alloc> basic_json<Char, Alloc>::parse(std::basic_istream<Char>& is)
 {
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1096,7 +1736,7 @@ basic_json<Char, Alloc> basic_json<Char, Alloc>::parse(std::basic_istream<Char>&
                                                        basic_parse_error_handler<Char>& err_handler)
 {
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler, err_handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler, err_handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1108,7 +1748,7 @@ basic_json<Char, Alloc> basic_json<Char, Alloc>::parse_string(const std::basic_s
 {
     std::basic_istringstream<Char> is(s);
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1121,7 +1761,7 @@ basic_json<Char, Alloc> basic_json<Char, Alloc>::parse_string(const std::basic_s
 {
     std::basic_istringstream<Char> is(s);
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler, err_handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler, err_handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1138,7 +1778,7 @@ basic_json<Char, Alloc> basic_json<Char, Alloc>::parse_file(const std::string& f
     }
 
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1156,7 +1796,7 @@ basic_json<Char, Alloc> basic_json<Char, Alloc>::parse_file(const std::string& f
     }
 
     basic_json_deserializer<Char, Alloc> handler;
-    basic_json_reader<Char> reader(is, handler, err_handler);
+    basic_json_reader<Char,basic_json_deserializer<Char,Alloc>> reader(is, handler, err_handler);
     reader.read();
     basic_json<Char, Alloc> val;
     handler.root().swap(val);
@@ -1239,7 +1879,7 @@ typename basic_json<Char, Alloc>::const_array_iterator basic_json<Char, Alloc>::
     switch (type_)
     {
     case value_type::array_t:
-        return value_.array_->begin();
+        return static_cast<const json_array_impl<Char, Alloc>*>(value_.array_)->begin();
     default:
         JSONCONS_THROW_EXCEPTION("Not an array");
     }
@@ -1272,7 +1912,7 @@ typename basic_json<Char, Alloc>::const_array_iterator basic_json<Char, Alloc>::
     switch (type_)
     {
     case value_type::array_t:
-        return value_.array_->end();
+        return static_cast<const json_array_impl<Char, Alloc>*>(value_.array_)->end();
     default:
         JSONCONS_THROW_EXCEPTION("Not an array");
     }
@@ -1369,6 +2009,21 @@ bool basic_json<Char, Alloc>::has_member(const std::basic_string<Char>& name) co
     }
 }
 
+template<typename Char, typename Alloc>
+bool basic_json<Char, Alloc>::has_member(const key& k) const
+{
+    switch (type_)
+    {
+    case value_type::object_t:
+        {
+            const json_object_impl<Char,Alloc>* obj = value_.object_;
+            return obj->find_value(k) != nullptr;
+        }
+    default:
+        return false;
+    }
+}
+
 template<typename Char, typename Alloc>
 bool basic_json<Char, Alloc>::as_bool() const
 {
@@ -1386,6 +2041,9 @@ long long basic_json<Char, Alloc>::as_longlong() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_longlong();
     case value_type::double_t:
         return static_cast<long long>(value_.float_value_);
     case value_type::longlong_t:
@@ -1404,6 +2062,9 @@ unsigned long long basic_json<Char, Alloc>::as_ulonglong() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_ulonglong();
     case value_type::double_t:
         return static_cast<unsigned long long>(value_.float_value_);
     case value_type::longlong_t:
@@ -1422,6 +2083,9 @@ double basic_json<Char, Alloc>::as_double() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_double();
     case value_type::double_t:
         return value_.float_value_;
     case value_type::longlong_t:
@@ -1440,6 +2104,9 @@ int basic_json<Char, Alloc>::as_int() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_int();
     case value_type::double_t:
         return static_cast<int>(value_.float_value_);
     case value_type::longlong_t:
@@ -1458,6 +2125,9 @@ unsigned int basic_json<Char, Alloc>::as_uint() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_uint();
     case value_type::double_t:
         return static_cast<unsigned int>(value_.float_value_);
     case value_type::longlong_t:
@@ -1476,6 +2146,9 @@ long basic_json<Char, Alloc>::as_long() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_long();
     case value_type::double_t:
         return static_cast<long>(value_.float_value_);
     case value_type::longlong_t:
@@ -1494,6 +2167,9 @@ unsigned long basic_json<Char, Alloc>::as_ulong() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_ulong();
     case value_type::double_t:
         return static_cast<unsigned long>(value_.float_value_);
     case value_type::longlong_t:
@@ -1598,6 +2274,9 @@ Char basic_json<Char, Alloc>::as_char() const
 {
     switch (type_)
     {
+    case value_type::number_t:
+    case value_type::small_number_t:
+        return parsed_number().as_char();
     case value_type::string_t:
         return value_.string_value_->length > 0 ? value_.string_value_->p[0] : '\0';
     case value_type::longlong_t:
@@ -1682,167 +2361,214 @@ bool is_non_ascii_character(uint32_t c)
     return c >= 0x80;
 }
 
+// True if c must be written as an escape sequence, see find_escape
 template<typename Char>
-void escape_string_orig(const Char* s,
-                   size_t length,
-                   const basic_output_format<Char>& format,
-                   std::basic_ostream<Char>& os)
+bool needs_escape(Char c, bool escape_solidus, bool escape_all_non_ascii)
 {
-    const Char* begin = s;
-    const Char* end = s + length;
-    for (const Char* it = begin; it != end; ++it)
+    uint32_t u = static_cast<typename std::make_unsigned<Char>::type>(c);
+    return u < 0x20 || u == 0x7f || c == '"' || c == '\\' || 
+           (escape_solidus && c == '/') || (escape_all_non_ascii && u >= 0x80);
+}
+
+// Returns the first character in [it,end) that must be escaped
+template<typename Char>
+const Char* find_escape(const Char* it, const Char* end, bool escape_solidus, bool escape_all_non_ascii)
+{
+    while (it != end && !needs_escape(*it, escape_solidus, escape_all_non_ascii))
     {
-        Char c = *it;
-        switch (c)
+        ++it;
+    }
+    return it;
+}
+
+// Checks 16 bytes at a time for quotes, backslashes, control characters,
+// and depending on the format solidus and non-ASCII bytes
+inline
+const char* find_escape(const char* it, const char* end, bool escape_solidus, bool escape_all_non_ascii)
+{
+#if defined(JSONCONS_HAS_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i max_control = _mm_set1_epi8(0x1f);
+    const __m128i solidus = _mm_set1_epi8(escape_solidus ? '/' : '"');
+    const int non_ascii_mask = escape_all_non_ascii ? 0xffff : 0;
+    while (end - it >= 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(x, del), _mm_cmpeq_epi8(x, solidus)));
+        // x <= 0x1f as unsigned bytes
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_min_epu8(x, max_control), x));
+        int mask = _mm_movemask_epi8(hits) | (_mm_movemask_epi8(x) & non_ascii_mask);
+        if (mask != 0)
         {
-        case '\\':
-            os << '\\' << '\\';
-            break;
-        case '"':
-            os << '\\' << '\"';
-            break;
-        case '\b':
-            os << '\\' << 'b';
-            break;
-        case '\f':
-            os << '\\';
-            os << 'f';
-            break;
-        case '\n':
-            os << '\\';
-            os << 'n';
-            break;
-        case '\r':
-            os << '\\';
-            os << 'r';
-            break;
-        case '\t':
-            os << '\\';
-            os << 't';
-            break;
-        default:
-            uint32_t u(c >= 0 ? c : 256 + c);
-            if (format.escape_solidus() && c == '/')
-            {
-                os << '\\';
-                os << '/';
-            }
-            else if (is_control_character(u) || format.escape_all_non_ascii())
-            {
-                // convert utf8 to codepoint
-                uint32_t cp = json_char_traits<Char, sizeof(Char)>::convert_char_to_codepoint(it, end);
-                if (is_non_ascii_character(cp) || is_control_character(u))
-                {
-                    if (cp > 0xFFFF)
-                    {
-                        cp -= 0x10000;
-                        uint32_t first = (cp >> 10) + 0xD800;
-                        uint32_t second = ((cp & 0x03FF) + 0xDC00);
-
-                        os << '\\';
-                        os << 'u';
-                        os << to_hex_character(first >> 12 & 0x000F);
-                        os << to_hex_character(first >> 8  & 0x000F);
-                        os << to_hex_character(first >> 4  & 0x000F);
-                        os << to_hex_character(first     & 0x000F);
-                        os << '\\';
-                        os << 'u';
-                        os << to_hex_character(second >> 12 & 0x000F);
-                        os << to_hex_character(second >> 8  & 0x000F);
-                        os << to_hex_character(second >> 4  & 0x000F);
-                        os << to_hex_character(second     & 0x000F);
-                    }
-                    else
-                    {
-                        os << '\\';
-                        os << 'u';
-                        os << to_hex_character(cp >> 12 & 0x000F);
-                        os << to_hex_character(cp >> 8  & 0x000F);
-                        os << to_hex_character(cp >> 4  & 0x000F);
-                        os << to_hex_character(cp     & 0x000F);
-                    }
-                }
-                else
-                {
-                    os << c;
-                }
-            }
-            else if (format.escape_solidus() && c == '/')
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, static_cast<unsigned long>(mask));
+            return it + index;
+#else
+            return it + __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+        }
+        it += 16;
+    }
+#endif
+    while (it != end && !needs_escape(*it, escape_solidus, escape_all_non_ascii))
+    {
+        ++it;
+    }
+    return it;
+}
+
+// Writes the escape sequence for the character at it, advancing it 
+// to the last unit of a multi-unit character
+template<typename Char, class Writer>
+void write_escape(const Char*& it, const Char* end, Writer& os)
+{
+    Char c = *it;
+    switch (c)
+    {
+    case '\\':
+        os.put('\\');
+        os.put('\\');
+        break;
+    case '"':
+        os.put('\\');
+        os.put('\"');
+        break;
+    case '\b':
+        os.put('\\');
+        os.put('b');
+        break;
+    case '\f':
+        os.put('\\');
+        os.put('f');
+        break;
+    case '\n':
+        os.put('\\');
+        os.put('n');
+        break;
+    case '\r':
+        os.put('\\');
+        os.put('r');
+        break;
+    case '\t':
+        os.put('\\');
+        os.put('t');
+        break;
+    case '/':
+        os.put('\\');
+        os.put('/');
+        break;
+    default:
+        {
+            uint32_t cp = json_char_traits<Char, sizeof(Char)>::convert_char_to_codepoint(it, end);
+            if (cp > 0xFFFF)
             {
-                os << '\\';
-                os << '/';
+                cp -= 0x10000;
+                uint32_t first = (cp >> 10) + 0xD800;
+                uint32_t second = ((cp & 0x03FF) + 0xDC00);
+
+                os.put('\\');
+                os.put('u');
+                os.put(to_hex_character(first >> 12 & 0x000F));
+                os.put(to_hex_character(first >> 8  & 0x000F));
+                os.put(to_hex_character(first >> 4  & 0x000F));
+                os.put(to_hex_character(first     & 0x000F));
+                os.put('\\');
+                os.put('u');
+                os.put(to_hex_character(second >> 12 & 0x000F));
+                os.put(to_hex_character(second >> 8  & 0x000F));
+                os.put(to_hex_character(second >> 4  & 0x000F));
+                os.put(to_hex_character(second     & 0x000F));
             }
             else
             {
-                os << c;
+                os.put('\\');
+                os.put('u');
+                os.put(to_hex_character(cp >> 12 & 0x000F));
+                os.put(to_hex_character(cp >> 8  & 0x000F));
+                os.put(to_hex_character(cp >> 4  & 0x000F));
+                os.put(to_hex_character(cp     & 0x000F));
             }
+        }
+        break;
+    }
+}
+
+// Writer is a std::basic_ostream<Char> or a basic_output_buffer<Char>.
+// Runs of characters that need no escaping are written with one call.
+template<typename Char, class Writer>
+void write_escaped_string(const Char* s,
+                          size_t length,
+                          bool escape_solidus,
+                          bool escape_all_non_ascii,
+                          Writer& os)
+{
+    const Char* it = s;
+    const Char* end = s + length;
+    while (it != end)
+    {
+        const Char* next = find_escape(it, end, escape_solidus, escape_all_non_ascii);
+        if (next != it)
+        {
+            os.write(it, next - it);
+        }
+        if (next == end)
+        {
             break;
         }
+        it = next;
+        write_escape(it, end, os);
+        ++it;
     }
 }
 
+template<typename Char, class Writer>
+void write_escaped_string(const Char* s,
+                          size_t length,
+                          const basic_output_format<Char>& format,
+                          Writer& os)
+{
+    write_escaped_string(s, length, format.escape_solidus(), format.escape_all_non_ascii(), os);
+}
+
 template<typename Char>
 void escape_string(const Char* s,
                    size_t length,
                    const basic_output_format<Char>& format,
                    std::basic_ostream<Char>& os)
 {
-    escape_string_orig<char>( s, length, format, os );
+    write_escaped_string(s, length, format, os);
 }
 
-template<>
-inline void escape_string< char >(const char* s,
+template<typename Char>
+void escape_string(const Char* s,
                    size_t length,
-                   const basic_output_format<char>& format,
-                   std::basic_ostream<char>& os)
+                   const basic_output_format<Char>& format,
+                   basic_output_buffer<Char>& os)
 {
-    std::basic_string<char> str( s, length );
-    const static std::basic_string<char> safe = " !#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[]^_'abcdefghijklmnopqrstuvwxyz{|}~";
-    
-    if( str.find_first_not_of( safe ) == std::basic_string<char>::npos ) {
-        os << str;
-    } else {
-        escape_string_orig<char>( s, length, format, os );
-    }
+    write_escaped_string(s, length, format, os);
 }
 
-template<typename Char>
+// Writer is a std::basic_ostream<Char> or a basic_output_buffer<Char>.
+// The text is encoded into a local block and written a block at a time.
+template<typename Char, class Writer>
 void base64_string(const Char* s,
                    size_t length,
-                   const basic_output_format<Char>& format,
-                   std::basic_ostream<Char>& os)
+                   const basic_output_format<Char>&,
+                   Writer& os)
 {
-    size_t main_length = length / 3 * 3;
-    Char lookup[] = {
-      'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
-      'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-      'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X',
-      'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-      'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n',
-      'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-      'w', 'x', 'y', 'z', '0', '1', '2', '3',
-      '4', '5', '6', '7', '8', '9', '+', '/'
-    };
-    
-    for( size_t i = 0; i < main_length; i += 3 ) {
-      os << lookup[(s[i] & 0xfc) >> 2];
-      os << lookup[((s[i] & 0x03) << 4) | ((s[i+1] & 0xf0) >> 4)];
-      os << lookup[((s[i+1] & 0x0f) << 2) | ((s[i+2] & 0xc0) >> 6)];
-      os << lookup[s[i+2] & 0x3f];
-    }
-    
-    if( length - main_length == 1 ) {
-      os << lookup[(s[main_length] & 0xfc) >> 2];
-      os << lookup[(s[main_length] & 0x03) << 4];
-      os << '=';
-      os << '=';
-    }
-    
-    if( length - main_length == 2 ) {
-      os << lookup[(s[main_length] & 0xfc) >> 2];
-      os << lookup[((s[main_length] & 0x03) << 4) | ((s[main_length+1] & 0xf0) >> 4)];
-      os << lookup[(s[main_length+1] & 0x0f) << 2];
-      os << '=';
+    const size_t block_length = 768;
+    Char buf[1024];
+    while (length > 0)
+    {
+        size_t n = (std::min)(length, block_length);
+        Char* last = base64_encode(s, n, buf);
+        os.write(buf, last - buf);
+        s += n;
+        length -= n;
     }
 }
 
@@ -1852,4 +2578,16 @@ void base64_string(const Char* s,
 #pragma GCC diagnostic pop
 #endif
 
+namespace std
+{
+    template<typename Char, typename Alloc>
+    struct hash<jsoncons::basic_json<Char,Alloc>>
+    {
+        size_t operator()(const jsoncons::basic_json<Char,Alloc>& val) const
+        {
+            return val.hash();
+        }
+    };
+}
+
 #endif
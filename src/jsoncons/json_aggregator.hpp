@@ -0,0 +1,604 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_AGGREGATOR_HPP
+#define JSONCONS_JSON_AGGREGATOR_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json_pointer_tokens.hpp"
+
+namespace jsoncons {
+
+// Computes counts, sums, minimums and maximums of the values at paths as input
+// events arrive, without building the values. Paths are JSON Pointers, in which
+// a "*" segment stands for any array element or member, relative to the records
+// at the record path: the top level value by default, or for example "/*" for
+// each element of a top level array, as the csv_reader reports rows. An
+// aggregate may be grouped by the first scalar at a key path in each record.
+// Memory is one state per aggregate and group, and one stack item per level.
+template <typename Char>
+class basic_json_aggregator : public basic_json_input_handler<Char>
+{
+    static const size_t npos = static_cast<size_t>(-1);
+
+    enum aggregate_kind {count_kind, sum_kind, min_kind, max_kind};
+
+    struct number
+    {
+        number()
+            : is_integer_(true), integer_(0), double_(0)
+        {
+        }
+
+        bool less(const number& other) const
+        {
+            return is_integer_ && other.is_integer_ ? integer_ < other.integer_ : double_ < other.double_;
+        }
+
+        bool is_integer_;
+        long long integer_;
+        double double_;
+    };
+
+    struct state
+    {
+        state()
+            : count_(0), exact_(true), integer_sum_(0), double_sum_(0)
+        {
+        }
+
+        void add(const number& n)
+        {
+            if (count_ == 0 || n.less(min_))
+            {
+                min_ = n;
+            }
+            if (count_ == 0 || max_.less(n))
+            {
+                max_ = n;
+            }
+            add_to_sum(n.is_integer_, n.integer_, n.double_);
+            ++count_;
+        }
+
+        void merge(const state& other)
+        {
+            if (other.count_ == 0)
+            {
+                return;
+            }
+            if (count_ == 0 || other.min_.less(min_))
+            {
+                min_ = other.min_;
+            }
+            if (count_ == 0 || max_.less(other.max_))
+            {
+                max_ = other.max_;
+            }
+            add_to_sum(other.exact_, other.integer_sum_, other.double_sum_);
+            count_ += other.count_;
+        }
+
+        void add_to_sum(bool is_integer, long long integer, double d)
+        {
+            double_sum_ += d;
+            if (exact_ && is_integer &&
+                !(integer > 0 && integer_sum_ > (std::numeric_limits<long long>::max)() - integer) &&
+                !(integer < 0 && integer_sum_ < (std::numeric_limits<long long>::min)() - integer))
+            {
+                integer_sum_ += integer;
+            }
+            else
+            {
+                exact_ = false;
+            }
+        }
+
+        size_t count_;
+        bool exact_;
+        long long integer_sum_;
+        double double_sum_;
+        number min_;
+        number max_;
+    };
+
+    struct aggregate
+    {
+        aggregate(aggregate_kind kind)
+            : kind_(kind), grouped_(false), has_key_(false)
+        {
+        }
+
+        aggregate_kind kind_;
+        bool grouped_;
+        state total_;
+        // The current record's values and group key, merged into groups_ at the end of the record
+        state partial_;
+        bool has_key_;
+        std::basic_string<Char> key_;
+        std::unordered_map<std::basic_string<Char>,state> groups_;
+    };
+
+    struct target
+    {
+        target(size_t index, bool is_key)
+            : index_(index), is_key_(is_key)
+        {
+        }
+
+        size_t index_;
+        bool is_key_;
+    };
+
+    struct node
+    {
+        node()
+            : any_(npos), record_(false), key_(false)
+        {
+        }
+
+        std::unordered_map<std::basic_string<Char>,size_t> children_;
+        size_t any_;
+        bool record_;
+        // A group key path of some aggregate
+        bool key_;
+        std::vector<target> targets_;
+    };
+
+    struct stack_item
+    {
+        stack_item(bool is_object, size_t node)
+           : is_object_(is_object), node_(node), child_(npos)
+        {
+        }
+
+        bool is_object_;
+        size_t node_;
+        // Node of the member being read
+        size_t child_;
+    };
+public:
+    // Each value at record_path is a record
+    basic_json_aggregator(const std::basic_string<Char>& record_path = std::basic_string<Char>())
+        : record_path_(record_path), max_groups_(npos), in_record_(false), record_depth_(0)
+    {
+        nodes_.push_back(node());
+        nodes_[find_or_add(record_path_)].record_ = true;
+    }
+
+    // Number of values at path, of any type. Returns the index of the aggregate.
+    size_t count(const std::basic_string<Char>& path)
+    {
+        return add(count_kind, path);
+    }
+
+    // Sum of the numbers at path, and of strings there that are JSON numbers
+    size_t sum(const std::basic_string<Char>& path)
+    {
+        return add(sum_kind, path);
+    }
+
+    size_t minimum(const std::basic_string<Char>& path)
+    {
+        return add(min_kind, path);
+    }
+
+    size_t maximum(const std::basic_string<Char>& path)
+    {
+        return add(max_kind, path);
+    }
+
+    // The same, for each value of the first scalar at group_path in a record.
+    // Records without a scalar there are left out.
+    size_t count(const std::basic_string<Char>& path, const std::basic_string<Char>& group_path)
+    {
+        return add(count_kind, path, group_path);
+    }
+
+    size_t sum(const std::basic_string<Char>& path, const std::basic_string<Char>& group_path)
+    {
+        return add(sum_kind, path, group_path);
+    }
+
+    size_t minimum(const std::basic_string<Char>& path, const std::basic_string<Char>& group_path)
+    {
+        return add(min_kind, path, group_path);
+    }
+
+    size_t maximum(const std::basic_string<Char>& path, const std::basic_string<Char>& group_path)
+    {
+        return add(max_kind, path, group_path);
+    }
+
+    // Limits the number of groups of each aggregate, a json_exception is thrown
+    // when a record would add one more
+    void max_groups(size_t n)
+    {
+        max_groups_ = n;
+    }
+
+    size_t max_groups() const
+    {
+        return max_groups_;
+    }
+
+    size_t size() const
+    {
+        return aggregates_.size();
+    }
+
+    // The value of aggregate i: a number, or null for the minimum or maximum
+    // of no numbers. For a grouped aggregate, an object with a member for each group.
+    basic_json<Char> result(size_t i) const
+    {
+        const aggregate& a = aggregates_.at(i);
+        if (!a.grouped_)
+        {
+            return value_of(a.kind_, a.total_);
+        }
+        basic_json<Char> val;
+        for (auto it = a.groups_.begin(); it != a.groups_.end(); ++it)
+        {
+            val.set(it->first, value_of(a.kind_, it->second));
+        }
+        return val;
+    }
+
+    // Clears the computed values, keeping the aggregates
+    void reset()
+    {
+        for (size_t i = 0; i < aggregates_.size(); ++i)
+        {
+            aggregate& a = aggregates_[i];
+            a.total_ = state();
+            a.partial_ = state();
+            a.has_key_ = false;
+            a.groups_.clear();
+        }
+        stack_.clear();
+        in_record_ = false;
+    }
+
+private:
+    size_t add(aggregate_kind kind, const std::basic_string<Char>& path)
+    {
+        size_t index = aggregates_.size();
+        aggregates_.push_back(aggregate(kind));
+        nodes_[find_or_add(record_path_ + path)].targets_.push_back(target(index, false));
+        return index;
+    }
+
+    size_t add(aggregate_kind kind, const std::basic_string<Char>& path, const std::basic_string<Char>& group_path)
+    {
+        size_t index = add(kind, path);
+        aggregates_[index].grouped_ = true;
+        node& key_node = nodes_[find_or_add(record_path_ + group_path)];
+        key_node.targets_.push_back(target(index, true));
+        key_node.key_ = true;
+        return index;
+    }
+
+    size_t find_or_add(const std::basic_string<Char>& path)
+    {
+        return find_or_add_path(nodes_, path);
+    }
+
+    static basic_json<Char> value_of(aggregate_kind kind, const state& s)
+    {
+        switch (kind)
+        {
+        case count_kind:
+            return basic_json<Char>(static_cast<unsigned long long>(s.count_));
+        case sum_kind:
+            return s.exact_ ? basic_json<Char>(s.integer_sum_) : basic_json<Char>(s.double_sum_);
+        default:
+            if (s.count_ == 0)
+            {
+                return basic_json<Char>(null_type());
+            }
+            const number& n = kind == min_kind ? s.min_ : s.max_;
+            return n.is_integer_ ? basic_json<Char>(n.integer_) : basic_json<Char>(n.double_);
+        }
+    }
+
+    state& state_of(aggregate& a)
+    {
+        return a.grouped_ ? a.partial_ : a.total_;
+    }
+
+    // The node of the value about to start, or npos
+    size_t value_node() const
+    {
+        if (stack_.empty())
+        {
+            return 0;
+        }
+        const stack_item& parent = stack_.back();
+        if (parent.node_ == npos)
+        {
+            return npos;
+        }
+        return parent.is_object_ ? parent.child_ : nodes_[parent.node_].any_;
+    }
+
+    void begin_record()
+    {
+        in_record_ = true;
+        record_depth_ = stack_.size();
+        for (size_t i = 0; i < aggregates_.size(); ++i)
+        {
+            aggregate& a = aggregates_[i];
+            if (a.grouped_)
+            {
+                a.partial_ = state();
+                a.has_key_ = false;
+            }
+        }
+    }
+
+    void end_record()
+    {
+        in_record_ = false;
+        for (size_t i = 0; i < aggregates_.size(); ++i)
+        {
+            aggregate& a = aggregates_[i];
+            if (a.grouped_ && a.has_key_)
+            {
+                auto it = a.groups_.find(a.key_);
+                if (it == a.groups_.end())
+                {
+                    if (a.groups_.size() >= max_groups_)
+                    {
+                        JSONCONS_THROW_EXCEPTION("Too many groups");
+                    }
+                    it = a.groups_.insert(std::make_pair(a.key_, state())).first;
+                }
+                it->second.merge(a.partial_);
+            }
+        }
+    }
+
+    // Called at the start of every value, returns its node
+    size_t begin_value()
+    {
+        size_t n = value_node();
+        if (n != npos)
+        {
+            if (nodes_[n].record_)
+            {
+                begin_record();
+            }
+            const std::vector<target>& targets = nodes_[n].targets_;
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                aggregate& a = aggregates_[targets[i].index_];
+                if (!targets[i].is_key_ && a.kind_ == count_kind)
+                {
+                    ++state_of(a).count_;
+                }
+            }
+        }
+        return n;
+    }
+
+    // Called for a scalar at node n that has targets, value is null if it is not a number
+    void add_value(size_t n, const number* value)
+    {
+        const std::vector<target>& targets = nodes_[n].targets_;
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            aggregate& a = aggregates_[targets[i].index_];
+            if (targets[i].is_key_)
+            {
+                if (in_record_ && !a.has_key_)
+                {
+                    a.has_key_ = true;
+                    a.key_ = key_buffer_;
+                }
+            }
+            else if (value != nullptr && a.kind_ != count_kind)
+            {
+                state_of(a).add(*value);
+            }
+        }
+    }
+
+    void end_scalar(size_t n)
+    {
+        if (n != npos && nodes_[n].record_)
+        {
+            end_record();
+        }
+    }
+
+    template <class T>
+    void typed_value(T value, const number* num)
+    {
+        size_t n = begin_value();
+        if (has_targets(n))
+        {
+            if (nodes_[n].key_)
+            {
+                key_buffer_ = basic_json<Char>(value).as_string();
+            }
+            add_value(n, num);
+        }
+        end_scalar(n);
+    }
+
+    bool has_targets(size_t n) const
+    {
+        return n != npos && !nodes_[n].targets_.empty();
+    }
+
+    void end_structure()
+    {
+        stack_.pop_back();
+        if (in_record_ && stack_.size() == record_depth_)
+        {
+            end_record();
+        }
+    }
+
+    virtual void do_begin_json()
+    {
+    }
+
+    virtual void do_end_json()
+    {
+    }
+
+    virtual void do_begin_object(const basic_parsing_context<Char>&)
+    {
+        stack_.push_back(stack_item(true, begin_value()));
+    }
+
+    virtual void do_end_object(const basic_parsing_context<Char>&)
+    {
+        end_structure();
+    }
+
+    virtual void do_begin_array(const basic_parsing_context<Char>&)
+    {
+        stack_.push_back(stack_item(false, begin_value()));
+    }
+
+    virtual void do_end_array(const basic_parsing_context<Char>&)
+    {
+        end_structure();
+    }
+
+    virtual void do_name(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        stack_item& item = stack_.back();
+        if (item.node_ == npos)
+        {
+            return;
+        }
+        const node& parent = nodes_[item.node_];
+        item.child_ = parent.any_;
+        if (!parent.children_.empty())
+        {
+            name_buffer_.assign(p, length);
+            auto it = parent.children_.find(name_buffer_);
+            if (it != parent.children_.end())
+            {
+                item.child_ = it->second;
+            }
+        }
+    }
+
+    virtual void do_string_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        size_t n = begin_value();
+        if (has_targets(n))
+        {
+            key_buffer_.assign(p, length);
+            if (is_number_text(p, length))
+            {
+                number value = to_number(parse_number_text(p, length));
+                add_value(n, &value);
+            }
+            else
+            {
+                add_value(n, nullptr);
+            }
+        }
+        end_scalar(n);
+    }
+
+    virtual void do_binary_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        size_t n = begin_value();
+        if (has_targets(n))
+        {
+            key_buffer_.assign(p, length);
+            add_value(n, nullptr);
+        }
+        end_scalar(n);
+    }
+
+    virtual void do_double_value(double value, const basic_parsing_context<Char>&)
+    {
+        number num;
+        num.is_integer_ = false;
+        num.double_ = value;
+        typed_value(value, &num);
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>&)
+    {
+        number num;
+        num.integer_ = value;
+        num.double_ = static_cast<double>(value);
+        typed_value(value, &num);
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>&)
+    {
+        number num;
+        num.is_integer_ = value <= static_cast<unsigned long long>((std::numeric_limits<long long>::max)());
+        num.integer_ = static_cast<long long>(value);
+        num.double_ = static_cast<double>(value);
+        typed_value(value, &num);
+    }
+
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>&)
+    {
+        typed_value(value, nullptr);
+    }
+
+    virtual void do_null_value(const basic_parsing_context<Char>&)
+    {
+        typed_value(null_type(), nullptr);
+    }
+
+    static number to_number(const number_text_value& val)
+    {
+        number num;
+        switch (val.kind)
+        {
+        case number_text_value::longlong_kind:
+            num.integer_ = val.longlong_value;
+            num.double_ = static_cast<double>(val.longlong_value);
+            break;
+        case number_text_value::ulonglong_kind:
+            num.is_integer_ = val.ulonglong_value <= static_cast<unsigned long long>((std::numeric_limits<long long>::max)());
+            num.integer_ = static_cast<long long>(val.ulonglong_value);
+            num.double_ = static_cast<double>(val.ulonglong_value);
+            break;
+        default:
+            num.is_integer_ = false;
+            num.double_ = val.double_value;
+            break;
+        }
+        return num;
+    }
+
+    std::basic_string<Char> record_path_;
+    std::vector<node> nodes_;
+    std::vector<aggregate> aggregates_;
+    std::vector<stack_item> stack_;
+    size_t max_groups_;
+    bool in_record_;
+    size_t record_depth_;
+    std::basic_string<Char> name_buffer_;
+    std::basic_string<Char> key_buffer_;
+};
+
+typedef basic_json_aggregator<char> json_aggregator;
+typedef basic_json_aggregator<wchar_t> wjson_aggregator;
+
+}
+
+#endif
@@ -0,0 +1,626 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_CANONICAL_SERIALIZER_HPP
+#define JSONCONS_JSON_CANONICAL_SERIALIZER_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdlib>
+#include <cmath>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/output_sink.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_output_handler.hpp"
+
+namespace jsoncons {
+
+// The position of code unit c in UTF-16 code unit order, so that names compare
+// as RFC 8785 requires. UTF-8 and UTF-32 order characters by code point, which
+// differs only in placing U+E000 to U+FFFF before the characters above U+FFFF, 
+// that UTF-16 writes as surrogates D800 to DFFF. moved(c) is true for the code
+// units whose rank is not in code point order.
+template <typename Char, size_t Size = sizeof(Char)>
+struct utf16_order
+{
+    static uint32_t rank(Char c)
+    {
+        return static_cast<uint32_t>(c);
+    }
+
+    static bool moved(Char)
+    {
+        return false;
+    }
+};
+
+template <typename Char>
+struct utf16_order<Char,1>
+{
+    // Lead bytes F0 to F4 start characters above U+FFFF, EE and EF start U+E000 to U+FFFF
+    static uint32_t rank(Char c)
+    {
+        uint32_t b = static_cast<uint8_t>(c);
+        return b >= 0xf0 ? b - 2 : (b >= 0xee ? b + 8 : b);
+    }
+
+    static bool moved(Char c)
+    {
+        uint32_t b = static_cast<uint8_t>(c);
+        return b == 0xee || b == 0xef;
+    }
+};
+
+template <typename Char>
+struct utf16_order<Char,4>
+{
+    static uint32_t rank(Char c)
+    {
+        uint32_t u = static_cast<uint32_t>(c);
+        return u < 0xd800 ? u : (u >= 0x10000 ? 0xd800 + (u - 0x10000) : u + 0x100000);
+    }
+
+    static bool moved(Char c)
+    {
+        uint32_t u = static_cast<uint32_t>(c);
+        return u >= 0xd800 && u < 0x10000;
+    }
+};
+
+// Writes the JSON Canonicalization Scheme (RFC 8785) form of a value:
+// no whitespace, members sorted by their names' UTF-16 code units, strings
+// with only the mandatory escapes, and numbers as their shortest round trip
+// double text. 
+//
+// Names must arrive in code unit order, as basic_json keeps them, and members
+// are written as they arrive. The two orders differ only where a name has
+// U+E000 to U+FFFF, so only members with such a character in their name are
+// held, until a name that sorts after them in UTF-16 order or the end of the
+// object.
+template<typename Char>
+class basic_json_canonical_serializer : public basic_json_output_handler<Char>
+{
+    struct member
+    {
+        std::basic_string<Char> name_;
+        std::basic_string<Char> text_;
+    };
+
+    struct stack_item
+    {
+        stack_item(bool is_object, std::basic_string<Char>* text)
+           : is_object_(is_object), count_(0), written_(0), text_(text)
+        {
+        }
+        bool is_object() const
+        {
+            return is_object_;
+        }
+
+        bool is_object_;
+        size_t count_;
+        size_t written_;
+        std::basic_string<Char>* text_; // where the object is written
+        std::basic_string<Char> name_;  // the last name received
+        std::vector<member> held_;
+    };
+
+    static bool name_less(const Char* a, size_t m, const Char* b, size_t n)
+    {
+        size_t length = (std::min)(m, n);
+        for (size_t i = 0; i < length; ++i)
+        {
+            uint32_t x = utf16_order<Char>::rank(a[i]);
+            uint32_t y = utf16_order<Char>::rank(b[i]);
+            if (x != y)
+            {
+                return x < y;
+            }
+        }
+        return m < n;
+    }
+
+    static bool member_less(const member& a, const member& b)
+    {
+        return name_less(a.name_.data(), a.name_.length(), b.name_.data(), b.name_.length());
+    }
+
+    // Sends output to the text of a held member, or otherwise to the buffer
+    class writer
+    {
+    public:
+        writer(basic_output_buffer<Char>& buffer)
+            : buffer_(buffer), text_(nullptr)
+        {
+        }
+
+        void put(Char c)
+        {
+            if (text_ != nullptr)
+            {
+                text_->push_back(c);
+            }
+            else
+            {
+                buffer_.put(c);
+            }
+        }
+
+        void write(const Char* s, size_t length)
+        {
+            if (text_ != nullptr)
+            {
+                text_->append(s, length);
+            }
+            else
+            {
+                buffer_.write(s, length);
+            }
+        }
+
+        void write(const std::basic_string<Char>& s)
+        {
+            write(s.data(), s.length());
+        }
+
+        void fill(Char c, size_t n)
+        {
+            if (text_ != nullptr)
+            {
+                text_->append(n, c);
+            }
+            else
+            {
+                buffer_.fill(c, n);
+            }
+        }
+
+        basic_output_buffer<Char>& buffer_;
+        std::basic_string<Char>* text_;
+    };
+public:
+    basic_json_canonical_serializer(std::basic_ostream<Char>& os)
+       : os_sink_(new basic_ostream_sink<Char>(os)), buffer_(*os_sink_), writer_(buffer_)
+    {
+    }
+
+    basic_json_canonical_serializer(basic_output_sink<Char>& sink)
+       : buffer_(sink), writer_(buffer_)
+    {
+    }
+
+    ~basic_json_canonical_serializer()
+    {
+        try
+        {
+            buffer_.flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void flush()
+    {
+        buffer_.flush();
+        buffer_.sink().flush();
+    }
+
+private:
+    virtual void do_begin_json()
+    {
+    }
+
+    virtual void do_end_json()
+    {
+        buffer_.flush();
+    }
+
+    virtual void do_begin_object()
+    {
+        begin_value();
+        stack_.push_back(stack_item(true, writer_.text_));
+        writer_.put('{');
+    }
+
+    virtual void do_end_object()
+    {
+        stack_item& item = stack_.back();
+        release_held(item, nullptr, 0);
+        writer_.text_ = item.text_;
+        writer_.put('}');
+        stack_.pop_back();
+        end_value();
+    }
+
+    virtual void do_begin_array()
+    {
+        begin_value();
+        stack_.push_back(stack_item(false, writer_.text_));
+        writer_.put('[');
+    }
+
+    virtual void do_end_array()
+    {
+        stack_.pop_back();
+        writer_.put(']');
+        end_value();
+    }
+
+    virtual void do_name(const Char* name, size_t length)
+    {
+        stack_item& item = stack_.back();
+        if (item.count_ > 0 && item.name_.compare(0, item.name_.length(), name, length) > 0)
+        {
+            JSONCONS_THROW_EXCEPTION("Member names must be given in order to the canonical serializer");
+        }
+        item.name_.assign(name, length);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (utf16_order<Char>::moved(name[i]))
+            {
+                item.held_.push_back(member());
+                item.held_.back().name_.assign(name, length);
+                writer_.text_ = &item.held_.back().text_;
+                return;
+            }
+        }
+        release_held(item, name, length);
+        begin_member(item, name, length);
+    }
+
+    // Writes the held members that sort before name, or all of them when name is null.
+    // A later name without U+E000 to U+FFFF never sorts before a member written here.
+    void release_held(stack_item& item, const Char* name, size_t length)
+    {
+        if (item.held_.empty())
+        {
+            return;
+        }
+        std::stable_sort(item.held_.begin(), item.held_.end(), member_less);
+        size_t n = 0;
+        while (n < item.held_.size() && 
+               (name == nullptr || name_less(item.held_[n].name_.data(), item.held_[n].name_.length(), name, length)))
+        {
+            begin_member(item, item.held_[n].name_.data(), item.held_[n].name_.length());
+            writer_.write(item.held_[n].text_);
+            ++n;
+        }
+        item.held_.erase(item.held_.begin(), item.held_.begin() + n);
+    }
+
+    void begin_member(stack_item& item, const Char* name, size_t length)
+    {
+        writer_.text_ = item.text_;
+        if (item.written_ > 0)
+        {
+            writer_.put(',');
+        }
+        write_string(name, length);
+        writer_.put(':');
+        ++item.written_;
+    }
+
+    virtual void do_null_value()
+    {
+        begin_value();
+        writer_.write(json_char_traits<Char,sizeof(Char)>::null_literal());
+        end_value();
+    }
+
+    virtual void do_string_value(const Char* value, size_t length)
+    {
+        begin_value();
+        write_string(value, length);
+        end_value();
+    }
+
+    virtual void do_binary_value(const Char* value, size_t length)
+    {
+        begin_value();
+        writer_.put('\"');
+        base64_string<Char>(value, length, format_, writer_);
+        writer_.put('\"');
+        end_value();
+    }
+
+    virtual void do_double_value(double value)
+    {
+        begin_value();
+        write_number(value);
+        end_value();
+    }
+
+    virtual void do_longlong_value(long long value)
+    {
+        begin_value();
+        write_number(static_cast<double>(value));
+        end_value();
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value)
+    {
+        begin_value();
+        write_number(static_cast<double>(value));
+        end_value();
+    }
+
+    virtual void do_number_value(const Char* p, size_t length)
+    {
+        begin_value();
+        number_text_value n = parse_number_text(p, length);
+        switch (n.kind)
+        {
+        case number_text_value::longlong_kind:
+            write_number(static_cast<double>(n.longlong_value));
+            break;
+        case number_text_value::ulonglong_kind:
+            write_number(static_cast<double>(n.ulonglong_value));
+            break;
+        default:
+            write_number(n.double_value);
+            break;
+        }
+        end_value();
+    }
+
+    virtual void do_bool_value(bool value)
+    {
+        begin_value();
+        writer_.write(value ? json_char_traits<Char,sizeof(Char)>::true_literal() :  json_char_traits<Char,sizeof(Char)>::false_literal());
+        end_value();
+    }
+
+    // Only quotation mark, reverse solidus and control characters are escaped,
+    // with the two character forms where they exist and lowercase hex otherwise
+    void write_string(const Char* s, size_t length)
+    {
+        writer_.put('\"');
+        const Char* it = s;
+        const Char* end = s + length;
+        while (it != end)
+        {
+            const Char* next = find_escape(it, end, false, false);
+            if (next != it)
+            {
+                writer_.write(it, next - it);
+            }
+            if (next == end)
+            {
+                break;
+            }
+            it = next;
+            Char c = *it++;
+            switch (c)
+            {
+            case '\\':
+            case '\"':
+                writer_.put('\\');
+                writer_.put(c);
+                break;
+            case '\b':
+                writer_.put('\\');
+                writer_.put('b');
+                break;
+            case '\f':
+                writer_.put('\\');
+                writer_.put('f');
+                break;
+            case '\n':
+                writer_.put('\\');
+                writer_.put('n');
+                break;
+            case '\r':
+                writer_.put('\\');
+                writer_.put('r');
+                break;
+            case '\t':
+                writer_.put('\\');
+                writer_.put('t');
+                break;
+            default:
+                if (c == 0x7f)
+                {
+                    writer_.put(c);
+                }
+                else
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    writer_.put('\\');
+                    writer_.put('u');
+                    writer_.put('0');
+                    writer_.put('0');
+                    writer_.put(hex[(c >> 4) & 0xf]);
+                    writer_.put(hex[c & 0xf]);
+                }
+                break;
+            }
+        }
+        writer_.put('\"');
+    }
+
+    // ECMAScript Number.prototype.toString applied to value, as RFC 8785 requires
+    void write_number(double value)
+    {
+        if (!(value - value == 0))
+        {
+            JSONCONS_THROW_EXCEPTION("NaN and Infinity have no canonical JSON form");
+        }
+        if (value == 0)
+        {
+            writer_.put('0'); // also -0
+            return;
+        }
+        if (value < 0)
+        {
+            writer_.put('-');
+            value = -value;
+        }
+
+        // Shortest digits that read back as value. For normal doubles a correctly
+        // rounded 15 digit form is the shortest whenever any form of 15 digits 
+        // or fewer exists, subnormals have less precision and are searched fully.
+        // snprintf gives d.ddde[+-]xx with the locale's decimal point, only the 
+        // digits and exponent are taken from it, and they are read back as an
+        // integer with an exponent.
+        char digits[20];
+        int k = 0;
+        int n = 0; // value is 0.ddd times 10^n
+        int precision = value < (std::numeric_limits<double>::min)() ? 1 : 15;
+        for (; precision <= 17; ++precision)
+        {
+            char buf[40];
+            c99_snprintf(buf, sizeof(buf), "%.*e", precision - 1, value);
+            k = 0;
+            const char* p = buf;
+            for (; *p != 'e'; ++p)
+            {
+                if (*p >= '0' && *p <= '9')
+                {
+                    digits[k++] = *p;
+                }
+            }
+            n = std::atoi(p + 1) + 1;
+            if (precision == 17 || read_digits(digits, k, n) == value)
+            {
+                break;
+            }
+        }
+        while (k > 1 && digits[k - 1] == '0')
+        {
+            --k;
+        }
+
+        if (k <= n && n <= 21)
+        {
+            write_digits(digits, k);
+            writer_.fill('0', n - k);
+        }
+        else if (0 < n && n <= 21)
+        {
+            write_digits(digits, n);
+            writer_.put('.');
+            write_digits(digits + n, k - n);
+        }
+        else if (-6 < n && n <= 0)
+        {
+            writer_.put('0');
+            writer_.put('.');
+            writer_.fill('0', -n);
+            write_digits(digits, k);
+        }
+        else
+        {
+            writer_.put(digits[0]);
+            if (k > 1)
+            {
+                writer_.put('.');
+                write_digits(digits + 1, k - 1);
+            }
+            writer_.put('e');
+            writer_.put(n - 1 < 0 ? '-' : '+');
+            Char exponent[8];
+            Char* last = exponent + 8;
+            Char* first = format_unsigned(static_cast<unsigned long long>(n - 1 < 0 ? 1 - n : n - 1), last);
+            writer_.write(first, last - first);
+        }
+    }
+
+    // The double nearest to the k digits as 0.ddd times 10^n. The text has
+    // no decimal point, so strtod reads it the same in every locale.
+    static double read_digits(const char* digits, int k, int n)
+    {
+        char text[32];
+        std::memcpy(text, digits, k);
+        int exponent = n - k;
+        text[k] = 'e';
+        text[k + 1] = exponent < 0 ? '-' : '+';
+        char* last = text + sizeof(text);
+        char* first = format_unsigned(static_cast<unsigned long long>(exponent < 0 ? -exponent : exponent), last);
+        char* p = text + k + 2;
+        while (first != last)
+        {
+            *p++ = *first++;
+        }
+        *p = 0;
+        return std::strtod(text, nullptr);
+    }
+
+    void write_digits(const char* p, int length)
+    {
+        for (int i = 0; i < length; ++i)
+        {
+            writer_.put(p[i]);
+        }
+    }
+
+    void begin_value()
+    {
+        if (!stack_.empty() && !stack_.back().is_object() && stack_.back().count_ > 0)
+        {
+            writer_.put(',');
+        }
+    }
+
+    void end_value()
+    {
+        if (!stack_.empty())
+        {
+            ++stack_.back().count_;
+        }
+        else
+        {
+            buffer_.flush();
+        }
+    }
+
+    std::unique_ptr<basic_ostream_sink<Char>> os_sink_;
+    basic_output_buffer<Char> buffer_;
+    writer writer_;
+    basic_output_format<Char> format_;
+    std::vector<stack_item> stack_;
+};
+
+template<typename Char, class Alloc>
+std::basic_string<Char> to_canonical_string(const basic_json<Char,Alloc>& val)
+{
+    std::basic_string<Char> s;
+    basic_string_sink<Char> sink(s);
+    {
+        basic_json_canonical_serializer<Char> serializer(sink);
+        val.to_stream(serializer);
+    }
+    return s;
+}
+
+// xxhash64 of the canonical form of val, computed as the text is produced
+// without building it (only members with U+E000 to U+FFFF in their names are
+// held, see basic_json_canonical_serializer). Characters are hashed as their code units, so a value
+// hashes the same as its canonical string, but json and wjson values differ.
+template<typename Char, class Alloc>
+uint64_t canonical_hash(const basic_json<Char,Alloc>& val, uint64_t seed = 0)
+{
+    basic_hash_sink<Char> sink(seed);
+    {
+        basic_json_canonical_serializer<Char> serializer(sink);
+        val.to_stream(serializer);
+    }
+    return sink.hash();
+}
+
+typedef basic_json_canonical_serializer<char> json_canonical_serializer;
+typedef basic_json_canonical_serializer<wchar_t> wjson_canonical_serializer;
+
+}
+
+#endif
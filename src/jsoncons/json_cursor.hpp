@@ -0,0 +1,510 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_CURSOR_HPP
+#define JSONCONS_JSON_CURSOR_HPP
+
+#include <string>
+#include <vector>
+#include <istream>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_deserializer.hpp"
+
+namespace jsoncons {
+
+namespace json_event_type
+{
+    enum json_event_type_t
+    {
+        none,
+        begin_object,
+        end_object,
+        begin_array,
+        end_array,
+        name,
+        string_value,
+        binary_value,
+        number_value,
+        double_value,
+        longlong_value,
+        ulonglong_value,
+        bool_value,
+        null_value,
+        end_json
+    };
+}
+
+// Pull access to the events of a json text. next() runs the reader up to the
+// next event and pauses it there, so that a string or name is read straight
+// from the reader's buffer until the following call.
+template<typename Char, class Alloc = std::allocator<void>>
+class basic_json_cursor
+{
+    class cursor_handler : public basic_json_input_handler<Char>
+    {
+    public:
+        cursor_handler(basic_json_cursor<Char,Alloc>* owner)
+            : owner_(owner), capture_depth_(0)
+        {
+        }
+
+        // Passes events to the deserializer up to the end of the current object or array
+        void capture()
+        {
+            capture_depth_ = 1;
+        }
+
+    private:
+        basic_json_deserializer<Char,Alloc>& deserializer()
+        {
+            return owner_->deserializer_;
+        }
+
+        void event(json_event_type::json_event_type_t type, const basic_parsing_context<Char>& context)
+        {
+            owner_->event_ = type;
+            owner_->context_ = std::addressof(context);
+            owner_->reader_.pause();
+        }
+
+        void event(json_event_type::json_event_type_t type, const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            owner_->p_ = p;
+            owner_->length_ = length;
+            event(type, context);
+        }
+
+        virtual void do_begin_json()
+        {
+        }
+
+        virtual void do_end_json()
+        {
+            // Comes straight after the last event, which is reported first
+            owner_->ended_ = true;
+        }
+
+        virtual void do_begin_object(const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                ++capture_depth_;
+                deserializer().begin_object(context);
+                return;
+            }
+            ++owner_->depth_;
+            event(json_event_type::begin_object, context);
+        }
+
+        virtual void do_end_object(const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().end_object(context);
+                end_capture(json_event_type::end_object, context);
+                return;
+            }
+            --owner_->depth_;
+            event(json_event_type::end_object, context);
+        }
+
+        virtual void do_begin_array(const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                ++capture_depth_;
+                deserializer().begin_array(context);
+                return;
+            }
+            ++owner_->depth_;
+            event(json_event_type::begin_array, context);
+        }
+
+        virtual void do_end_array(const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().end_array(context);
+                end_capture(json_event_type::end_array, context);
+                return;
+            }
+            --owner_->depth_;
+            event(json_event_type::end_array, context);
+        }
+
+        void end_capture(json_event_type::json_event_type_t type, const basic_parsing_context<Char>& context)
+        {
+            if (--capture_depth_ == 0)
+            {
+                --owner_->depth_;
+                deserializer().end_json();
+                event(type, context);
+            }
+        }
+
+        virtual void do_name(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().name(p, length, context);
+                return;
+            }
+            event(json_event_type::name, p, length, context);
+        }
+
+        virtual void do_string_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(p, length, context);
+                return;
+            }
+            event(json_event_type::string_value, p, length, context);
+        }
+
+        virtual void do_binary_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().binary(p, length, context);
+                return;
+            }
+            event(json_event_type::binary_value, p, length, context);
+        }
+
+        virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().number(p, length, context);
+                return;
+            }
+            event(json_event_type::number_value, p, length, context);
+        }
+
+        virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(value, context);
+                return;
+            }
+            owner_->double_value_ = value;
+            event(json_event_type::double_value, context);
+        }
+
+        virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(value, context);
+                return;
+            }
+            owner_->longlong_value_ = value;
+            event(json_event_type::longlong_value, context);
+        }
+
+        virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(value, context);
+                return;
+            }
+            owner_->ulonglong_value_ = value;
+            event(json_event_type::ulonglong_value, context);
+        }
+
+        virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(value, context);
+                return;
+            }
+            owner_->bool_value_ = value;
+            event(json_event_type::bool_value, context);
+        }
+
+        virtual void do_null_value(const basic_parsing_context<Char>& context)
+        {
+            if (capture_depth_ > 0)
+            {
+                deserializer().value(null_type(), context);
+                return;
+            }
+            event(json_event_type::null_value, context);
+        }
+
+        basic_json_cursor<Char,Alloc>* owner_;
+        size_t capture_depth_;
+    };
+
+public:
+    basic_json_cursor(std::basic_istream<Char>& is)
+        : handler_(this), reader_(is, handler_)
+    {
+        init();
+    }
+
+    basic_json_cursor(std::basic_istream<Char>& is, basic_parse_error_handler<Char>& err_handler)
+        : handler_(this), reader_(is, handler_, err_handler)
+    {
+        init();
+    }
+
+    // Moves to the next event and returns it, end_json at the end of the text
+    json_event_type::json_event_type_t next()
+    {
+        if (event_ == json_event_type::end_json)
+        {
+            return event_;
+        }
+        if (ended_)
+        {
+            event_ = json_event_type::end_json;
+            return event_;
+        }
+        advance();
+        return event_;
+    }
+
+    json_event_type::json_event_type_t event() const
+    {
+        return event_;
+    }
+
+    // Number of objects and arrays open, including one that has just begun
+    size_t depth() const
+    {
+        return depth_;
+    }
+
+    bool done() const
+    {
+        return event_ == json_event_type::end_json;
+    }
+
+    // Passes over the value that starts with the current event, without
+    // reporting its events. At a name, passes over the member's value.
+    // The next event is the one after the value.
+    void skip()
+    {
+        if (event_ == json_event_type::name)
+        {
+            next();
+        }
+        if (event_ == json_event_type::begin_object || event_ == json_event_type::begin_array)
+        {
+            reader_.skip();
+            --depth_;
+        }
+    }
+
+    // Builds the value that starts with the current event into val. At a name,
+    // reads the member's value. The next event is the one after the value.
+    void read_to(basic_json<Char,Alloc>& val)
+    {
+        if (event_ == json_event_type::name)
+        {
+            next();
+        }
+        switch (event_)
+        {
+        case json_event_type::begin_object:
+        case json_event_type::begin_array:
+            deserializer_.begin_json();
+            if (event_ == json_event_type::begin_object)
+            {
+                deserializer_.begin_object(*context_);
+            }
+            else
+            {
+                deserializer_.begin_array(*context_);
+            }
+            handler_.capture();
+            advance();
+            val.swap(deserializer_.root());
+            deserializer_.root() = basic_json<Char,Alloc>();
+            break;
+        case json_event_type::string_value:
+            val = basic_json<Char,Alloc>(p_, length_);
+            break;
+        case json_event_type::binary_value:
+            val = basic_json<Char,Alloc>::make_binary(p_, length_);
+            break;
+        case json_event_type::number_value:
+            val = basic_json<Char,Alloc>::make_number(p_, length_);
+            break;
+        case json_event_type::double_value:
+            val = basic_json<Char,Alloc>(double_value_);
+            break;
+        case json_event_type::longlong_value:
+            val = basic_json<Char,Alloc>(longlong_value_);
+            break;
+        case json_event_type::ulonglong_value:
+            val = basic_json<Char,Alloc>(ulonglong_value_);
+            break;
+        case json_event_type::bool_value:
+            val = basic_json<Char,Alloc>(bool_value_);
+            break;
+        case json_event_type::null_value:
+            val = basic_json<Char,Alloc>(null_type());
+            break;
+        default:
+            JSONCONS_THROW_EXCEPTION("The cursor is not at the start of a value");
+        }
+    }
+
+    // The text of the current name, string, binary or number event
+    const Char* data() const
+    {
+        return p_;
+    }
+
+    size_t length() const
+    {
+        return length_;
+    }
+
+    std::basic_string<Char> string_value() const
+    {
+        return std::basic_string<Char>(p_, length_);
+    }
+
+    bool as_bool() const
+    {
+        if (event_ != json_event_type::bool_value)
+        {
+            JSONCONS_THROW_EXCEPTION("Not a bool");
+        }
+        return bool_value_;
+    }
+
+    double as_double() const
+    {
+        switch (event_)
+        {
+        case json_event_type::double_value:
+            return double_value_;
+        case json_event_type::longlong_value:
+            return static_cast<double>(longlong_value_);
+        case json_event_type::ulonglong_value:
+            return static_cast<double>(ulonglong_value_);
+        case json_event_type::number_value:
+            return basic_json<Char,Alloc>::make_number(p_, length_).as_double();
+        default:
+            JSONCONS_THROW_EXCEPTION("Not a number");
+        }
+    }
+
+    long long as_longlong() const
+    {
+        switch (event_)
+        {
+        case json_event_type::double_value:
+            return static_cast<long long>(double_value_);
+        case json_event_type::longlong_value:
+            return longlong_value_;
+        case json_event_type::ulonglong_value:
+            return static_cast<long long>(ulonglong_value_);
+        case json_event_type::number_value:
+            return basic_json<Char,Alloc>::make_number(p_, length_).as_longlong();
+        default:
+            JSONCONS_THROW_EXCEPTION("Not a number");
+        }
+    }
+
+    unsigned long long as_ulonglong() const
+    {
+        switch (event_)
+        {
+        case json_event_type::double_value:
+            return static_cast<unsigned long long>(double_value_);
+        case json_event_type::longlong_value:
+            return static_cast<unsigned long long>(longlong_value_);
+        case json_event_type::ulonglong_value:
+            return ulonglong_value_;
+        case json_event_type::number_value:
+            return basic_json<Char,Alloc>::make_number(p_, length_).as_ulonglong();
+        default:
+            JSONCONS_THROW_EXCEPTION("Not a number");
+        }
+    }
+
+    const basic_parsing_context<Char>& context() const
+    {
+        return *context_;
+    }
+
+    basic_json_reader<Char>& reader()
+    {
+        return reader_;
+    }
+
+private:
+    basic_json_cursor(const basic_json_cursor&); // noop
+    basic_json_cursor& operator=(const basic_json_cursor&); // noop
+
+    void init()
+    {
+        event_ = json_event_type::none;
+        depth_ = 0;
+        started_ = false;
+        ended_ = false;
+        context_ = nullptr;
+        p_ = nullptr;
+        length_ = 0;
+        double_value_ = 0;
+        longlong_value_ = 0;
+        ulonglong_value_ = 0;
+        bool_value_ = false;
+    }
+
+    void advance()
+    {
+        event_ = json_event_type::none;
+        if (!started_)
+        {
+            started_ = true;
+            reader_.read();
+        }
+        else
+        {
+            reader_.resume();
+        }
+        if (event_ == json_event_type::none)
+        {
+            event_ = json_event_type::end_json;
+        }
+    }
+
+    basic_json_deserializer<Char,Alloc> deserializer_;
+    cursor_handler handler_;
+    basic_json_reader<Char> reader_;
+    json_event_type::json_event_type_t event_;
+    size_t depth_;
+    bool started_;
+    bool ended_;
+    const basic_parsing_context<Char>* context_;
+    const Char* p_;
+    size_t length_;
+    double double_value_;
+    long long longlong_value_;
+    unsigned long long ulonglong_value_;
+    bool bool_value_;
+};
+
+typedef basic_json_cursor<char> json_cursor;
+typedef basic_json_cursor<wchar_t> wjson_cursor;
+
+}
+
+#endif
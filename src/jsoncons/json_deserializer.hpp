@@ -22,7 +22,7 @@
 namespace jsoncons {
 
 template <typename Char,class Alloc>
-class basic_json_deserializer : public basic_json_input_handler<Char>
+class basic_json_deserializer final : public basic_json_input_handler<Char>
 {
     struct stack_item
     {
@@ -38,10 +38,30 @@ class basic_json_deserializer : public basic_json_input_handler<Char>
             else
             {
                 array_ = new json_array_impl<Char,Alloc>();
-                array_->reserve(minimum_structure_capacity);
             }
         }
 
+        // Array storage is reserved on the first element, so that an array
+        // of numbers can be given contiguous storage of the right type
+        void push_back(basic_json<Char,Alloc>&& val)
+        {
+            if (array_->size() == 0)
+            {
+                array_->reserve(minimum_structure_capacity_);
+            }
+            array_->push_back(std::move(val));
+        }
+
+        template <class T>
+        void push_back_number(T val)
+        {
+            if (array_->size() == 0)
+            {
+                array_->template reserve_numbers<T>(minimum_structure_capacity_);
+            }
+            array_->push_back_number(val);
+        }
+
         void destroy()
         {
             try
@@ -82,6 +102,11 @@ class basic_json_deserializer : public basic_json_input_handler<Char>
     };
 
 public:
+    basic_json_deserializer()
+        : shrink_to_fit_(false)
+    {
+    }
+
     virtual ~basic_json_deserializer()
     {
         for (size_t i = 0; i < stack_.size(); ++i)
@@ -95,6 +120,99 @@ public:
         return root_;
     }
 
+    bool shrink_to_fit() const
+    {
+        return shrink_to_fit_;
+    }
+
+    // When true, each array and object is trimmed to its size when it ends, 
+    // so that long lived documents do not keep the capacity reserved while parsing
+    void shrink_to_fit(bool value)
+    {
+        shrink_to_fit_ = value;
+    }
+
+    // The event functions of this class, called without virtual dispatch when the 
+    // static type is basic_json_deserializer, see basic_json_reader
+    // The class is final, so that no override of the do_ functions can be bypassed this way.
+    using basic_json_input_handler<Char>::name;
+    using basic_json_input_handler<Char>::value;
+
+    void begin_json()
+    {
+        basic_json_deserializer::do_begin_json();
+    }
+
+    void end_json()
+    {
+        basic_json_deserializer::do_end_json();
+    }
+
+    void begin_object(const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_begin_object(context);
+    }
+
+    void end_object(const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_end_object(context);
+    }
+
+    void begin_array(const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_begin_array(context);
+    }
+
+    void end_array(const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_end_array(context);
+    }
+
+    void name(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_name(p, length, context);
+    }
+
+    void value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_string_value(p, length, context);
+    }
+
+    void binary(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_binary_value(p, length, context);
+    }
+
+    void number(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_number_value(p, length, context);
+    }
+
+    void value(long long value, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_longlong_value(value, context);
+    }
+
+    void value(unsigned long long value, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_ulonglong_value(value, context);
+    }
+
+    void value(double value, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_double_value(value, context);
+    }
+
+    void value(bool value, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_bool_value(value, context);
+    }
+
+    void value(null_type, const basic_parsing_context<Char>& context)
+    {
+        basic_json_deserializer::do_null_value(context);
+    }
+
 private:
 
     virtual void do_begin_json()
@@ -113,6 +231,10 @@ private:
     virtual void do_end_object(const basic_parsing_context<Char>&)
     {
         stack_.back().object_->sort_members();
+        if (shrink_to_fit_)
+        {
+            stack_.back().object_->shrink_to_fit();
+        }
         basic_json<Char,Alloc> val(stack_.back().release_object());	    
         stack_.pop_back();
         if (stack_.size() > 0)
@@ -123,7 +245,7 @@ private:
             }
             else
             {
-                stack_.back().array_->push_back(std::move(val));
+                stack_.back().push_back(std::move(val));
             }
         }
         else
@@ -139,6 +261,10 @@ private:
 
     virtual void do_end_array(const basic_parsing_context<Char>&)
     {
+        if (shrink_to_fit_)
+        {
+            stack_.back().array_->shrink_to_fit();
+        }
         basic_json<Char,Alloc> val(stack_.back().release_array());	    
         stack_.pop_back();
         if (stack_.size() > 0)
@@ -149,7 +275,7 @@ private:
             }
             else
             {
-                stack_.back().array_->push_back(std::move(val));
+                stack_.back().push_back(std::move(val));
             }
         }
         else
@@ -171,7 +297,7 @@ private:
         } 
         else 
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>(p,length));
+            stack_.back().push_back(basic_json<Char,Alloc>(p,length));
         }
     }
 
@@ -183,7 +309,7 @@ private:
         } 
         else 
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>::make_binary(p,length));
+            stack_.back().push_back(basic_json<Char,Alloc>::make_binary(p,length));
         }
     }
 
@@ -195,7 +321,7 @@ private:
         } 
         else
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>::make_integer(value));
+            stack_.back().push_back_number(value);
         }
     }
 
@@ -207,7 +333,7 @@ private:
         } 
         else
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>::make_unsigned(value));
+            stack_.back().push_back_number(value);
         }
     }
 
@@ -219,7 +345,19 @@ private:
         } 
         else
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>::make_float(value));
+            stack_.back().push_back_number(value);
+        }
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        if (stack_.back().is_object())
+        {
+            stack_.back().object_->push_back(std::move(stack_.back().name_),basic_json<Char,Alloc>::make_number(p,length));
+        } 
+        else
+        {
+            stack_.back().push_back(basic_json<Char,Alloc>::make_number(p,length));
         }
     }
 
@@ -231,7 +369,7 @@ private:
         } 
         else
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>(value));
+            stack_.back().push_back(basic_json<Char,Alloc>(value));
         }
     }
 
@@ -243,12 +381,13 @@ private:
         } 
         else
         {
-            stack_.back().array_->push_back(basic_json<Char,Alloc>::null);
+            stack_.back().push_back(basic_json<Char,Alloc>(basic_json<Char,Alloc>::null));
         }
     }
 
 	basic_json<Char,Alloc> root_;
     std::vector<stack_item> stack_;
+    bool shrink_to_fit_;
 };
 
 typedef basic_json_deserializer<char,std::allocator<void>> json_deserializer;
@@ -0,0 +1,524 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_ELEMENT_READER_HPP
+#define JSONCONS_JSON_ELEMENT_READER_HPP
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <iterator>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_pointer_tokens.hpp"
+
+namespace jsoncons {
+
+// Reads the elements of an array one at a time, the top level array or one at
+// a JSON Pointer. Each element is built with a reused basic_json_deserializer,
+// and the reader is paused after it, so that only one element is in memory.
+template<typename Char, class Alloc = std::allocator<void>>
+class basic_json_element_reader
+{
+    class element_handler : public basic_json_input_handler<Char>
+    {
+        struct stack_item
+        {
+            stack_item(bool is_object)
+               : is_object_(is_object), index_(0)
+            {
+            }
+
+            bool is_object_;
+            size_t index_;
+            std::basic_string<Char> name_;
+        };
+    public:
+        element_handler(basic_json_element_reader<Char,Alloc>* owner)
+            : owner_(owner), array_depth_(0), element_depth_(0), scalar_(false), done_(false)
+        {
+        }
+
+        bool done() const
+        {
+            return done_;
+        }
+
+    private:
+        // Whether the array about to start, as a child of the top of the stack, is the one at the path
+        bool at_path() const
+        {
+            const std::vector<std::basic_string<Char>>& path = owner_->path_;
+            if (stack_.size() != path.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < path.size(); ++i)
+            {
+                const stack_item& item = stack_[i];
+                if (item.is_object_)
+                {
+                    if (item.name_ != path[i])
+                    {
+                        return false;
+                    }
+                }
+                else if (!is_index(path[i], item.index_))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool is_index(const std::basic_string<Char>& s, size_t index)
+        {
+            if (s.empty() || (s[0] == '0' && s.length() > 1))
+            {
+                return false;
+            }
+            size_t n = 0;
+            for (size_t i = 0; i < s.length(); ++i)
+            {
+                if (s[i] < '0' || s[i] > '9')
+                {
+                    return false;
+                }
+                n = n*10 + static_cast<size_t>(s[i] - '0');
+            }
+            return n == index;
+        }
+
+        // True if the value about to start is an element, or part of one
+        bool begin_value(const basic_parsing_context<Char>& context, bool is_scalar)
+        {
+            if (element_depth_ > 0)
+            {
+                return true;
+            }
+            if (array_depth_ == 0 || stack_.size() != array_depth_)
+            {
+                return false;
+            }
+            deserializer().begin_json();
+            scalar_ = is_scalar;
+            if (is_scalar)
+            {
+                // basic_json_deserializer builds containers, so a scalar is
+                // built as the only element of an array
+                deserializer().begin_array(context);
+            }
+            return true;
+        }
+
+        void end_element(const basic_parsing_context<Char>& context)
+        {
+            if (scalar_)
+            {
+                deserializer().end_array(context);
+            }
+            deserializer().end_json();
+            owner_->element_ready(scalar_);
+            end_value();
+        }
+
+        void end_value()
+        {
+            if (!stack_.empty() && !stack_.back().is_object_)
+            {
+                ++stack_.back().index_;
+            }
+        }
+
+        basic_json_deserializer<Char,Alloc>& deserializer()
+        {
+            return owner_->deserializer_;
+        }
+
+        virtual void do_begin_json()
+        {
+        }
+
+        virtual void do_end_json()
+        {
+            if (!done_)
+            {
+                done_ = true;
+                owner_->reader_.pause();
+            }
+        }
+
+        virtual void do_begin_object(const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, false))
+            {
+                ++element_depth_;
+                deserializer().begin_object(context);
+            }
+            else
+            {
+                stack_.push_back(stack_item(true));
+            }
+        }
+
+        virtual void do_end_object(const basic_parsing_context<Char>& context)
+        {
+            if (element_depth_ > 0)
+            {
+                deserializer().end_object(context);
+                if (--element_depth_ == 0)
+                {
+                    end_element(context);
+                }
+            }
+            else
+            {
+                stack_.pop_back();
+                end_value();
+            }
+        }
+
+        virtual void do_begin_array(const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, false))
+            {
+                ++element_depth_;
+                deserializer().begin_array(context);
+            }
+            else
+            {
+                if (array_depth_ == 0 && at_path())
+                {
+                    array_depth_ = stack_.size() + 1;
+                }
+                stack_.push_back(stack_item(false));
+            }
+        }
+
+        virtual void do_end_array(const basic_parsing_context<Char>& context)
+        {
+            if (element_depth_ > 0)
+            {
+                deserializer().end_array(context);
+                if (--element_depth_ == 0)
+                {
+                    end_element(context);
+                }
+            }
+            else
+            {
+                if (stack_.size() == array_depth_)
+                {
+                    // The rest of the text is not needed
+                    done_ = true;
+                    owner_->reader_.pause();
+                }
+                stack_.pop_back();
+                end_value();
+            }
+        }
+
+        virtual void do_name(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (element_depth_ > 0)
+            {
+                deserializer().name(p, length, context);
+            }
+            else
+            {
+                stack_.back().name_.assign(p, length);
+            }
+        }
+
+        virtual void do_null_value(const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(null_type(), context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_string_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(p, length, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_binary_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().binary(p, length, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().number(p, length, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(value, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(value, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(value, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+        {
+            if (begin_value(context, true))
+            {
+                deserializer().value(value, context);
+                end_scalar(context);
+            }
+            else
+            {
+                end_value();
+            }
+        }
+
+        void end_scalar(const basic_parsing_context<Char>& context)
+        {
+            if (element_depth_ == 0)
+            {
+                end_element(context);
+            }
+        }
+
+        basic_json_element_reader<Char,Alloc>* owner_;
+        std::vector<stack_item> stack_;
+        // Depth of the open containers within the array, and of the array itself
+        size_t array_depth_;
+        size_t element_depth_;
+        bool scalar_;
+        bool done_;
+    };
+
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef basic_json<Char,Alloc> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef basic_json<Char,Alloc>* pointer;
+        typedef basic_json<Char,Alloc>& reference;
+
+        iterator()
+            : reader_(nullptr)
+        {
+        }
+
+        explicit iterator(basic_json_element_reader<Char,Alloc>* reader)
+            : reader_(reader)
+        {
+            if (!reader_->next())
+            {
+                reader_ = nullptr;
+            }
+        }
+
+        reference operator*() const
+        {
+            return reader_->value();
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(reader_->value());
+        }
+
+        iterator& operator++()
+        {
+            if (!reader_->next())
+            {
+                reader_ = nullptr;
+            }
+            return *this;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b)
+        {
+            return a.reader_ == b.reader_;
+        }
+
+        friend bool operator!=(const iterator& a, const iterator& b)
+        {
+            return !(a == b);
+        }
+    private:
+        basic_json_element_reader<Char,Alloc>* reader_;
+    };
+
+    // Reads the elements of the top level array
+    basic_json_element_reader(std::basic_istream<Char>& is)
+        : handler_(this), reader_(is, handler_), started_(false), ready_(false), count_(0)
+    {
+    }
+
+    // Reads the elements of the array at path, a JSON Pointer
+    basic_json_element_reader(std::basic_istream<Char>& is, const std::basic_string<Char>& path)
+        : handler_(this), reader_(is, handler_), started_(false), ready_(false), count_(0)
+    {
+        parse_path(path);
+    }
+
+    basic_json_element_reader(std::basic_istream<Char>& is, const std::basic_string<Char>& path,
+                              basic_parse_error_handler<Char>& err_handler)
+        : handler_(this), reader_(is, handler_, err_handler), started_(false), ready_(false), count_(0)
+    {
+        parse_path(path);
+    }
+
+    // Reads the next element, returns false after the last one
+    bool next()
+    {
+        ready_ = false;
+        if (handler_.done())
+        {
+            return false;
+        }
+        if (!started_)
+        {
+            started_ = true;
+            reader_.read();
+        }
+        else if (reader_.paused())
+        {
+            reader_.resume();
+        }
+        return ready_;
+    }
+
+    // The element read by the last call to next(), which may be moved from
+    basic_json<Char,Alloc>& value()
+    {
+        return value_;
+    }
+
+    // Number of elements read
+    size_t count() const
+    {
+        return count_;
+    }
+
+    iterator begin()
+    {
+        return iterator(this);
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    basic_json_reader<Char>& reader()
+    {
+        return reader_;
+    }
+
+private:
+    basic_json_element_reader(const basic_json_element_reader&); // noop
+    basic_json_element_reader& operator=(const basic_json_element_reader&); // noop
+
+    void parse_path(const std::basic_string<Char>& path)
+    {
+        path_ = split_json_pointer(path);
+    }
+
+    void element_ready(bool scalar)
+    {
+        if (scalar)
+        {
+            value_.swap(deserializer_.root()[0]);
+        }
+        else
+        {
+            value_.swap(deserializer_.root());
+        }
+        deserializer_.root() = basic_json<Char,Alloc>();
+        ready_ = true;
+        ++count_;
+        reader_.pause();
+    }
+
+    std::vector<std::basic_string<Char>> path_;
+    basic_json_deserializer<Char,Alloc> deserializer_;
+    element_handler handler_;
+    basic_json_reader<Char> reader_;
+    basic_json<Char,Alloc> value_;
+    bool started_;
+    bool ready_;
+    size_t count_;
+};
+
+typedef basic_json_element_reader<char> json_element_reader;
+typedef basic_json_element_reader<wchar_t> wjson_element_reader;
+
+}
+
+#endif
@@ -0,0 +1,430 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_EVENT_TAPE_HPP
+#define JSONCONS_JSON_EVENT_TAPE_HPP
+
+#include <string>
+#include <vector>
+#include <future>
+#include <exception>
+#include <cstring>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json_input_handler.hpp"
+
+namespace jsoncons {
+
+// Input events recorded once in a compact byte form, to be replayed to any
+// number of handlers. Each event is a tag byte, followed for begin_object and
+// begin_array by a varint capacity hint, for names, strings, binary and
+// numbers in text by a varint length and the characters, for integers by a
+// varint (zigzag for long long), and for doubles by their 8 bytes. Line and
+// column numbers are not recorded, replayed events report zero.
+template <typename Char>
+class basic_json_event_tape
+{
+    enum tag_type : uint8_t
+    {
+        begin_json_tag, end_json_tag, begin_object_tag, end_object_tag,
+        begin_array_tag, end_array_tag, name_tag, string_tag, binary_tag,
+        number_tag, double_tag, longlong_tag, ulonglong_tag,
+        true_tag, false_tag, null_tag
+    };
+
+    class replay_context : public basic_parsing_context<Char>
+    {
+    public:
+        replay_context()
+            : minimum_structure_capacity_(0)
+        {
+        }
+
+        size_t minimum_structure_capacity_;
+    private:
+        virtual unsigned long do_line_number() const
+        {
+            return 0;
+        }
+        virtual unsigned long do_column_number() const
+        {
+            return 0;
+        }
+        virtual bool do_eof() const
+        {
+            return false;
+        }
+        virtual size_t do_minimum_structure_capacity() const
+        {
+            return minimum_structure_capacity_;
+        }
+        virtual Char do_last_char() const
+        {
+            return 0;
+        }
+    };
+public:
+    basic_json_event_tape()
+        : event_count_(0)
+    {
+    }
+
+    // Number of events recorded
+    size_t event_count() const
+    {
+        return event_count_;
+    }
+
+    // The recorded bytes
+    const std::vector<uint8_t>& data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return data_.size();
+    }
+
+    bool empty() const
+    {
+        return event_count_ == 0;
+    }
+
+    void clear()
+    {
+        data_.clear();
+        event_count_ = 0;
+    }
+
+    void reserve(size_t n)
+    {
+        data_.reserve(n);
+    }
+
+    // Sends the recorded events to handler
+    void replay(basic_json_input_handler<Char>& handler) const
+    {
+        replay_context context;
+        std::basic_string<Char> text;
+        size_t pos = 0;
+        while (pos < data_.size())
+        {
+            switch (static_cast<tag_type>(data_[pos++]))
+            {
+            case begin_json_tag:
+                handler.begin_json();
+                break;
+            case end_json_tag:
+                handler.end_json();
+                break;
+            case begin_object_tag:
+                context.minimum_structure_capacity_ = static_cast<size_t>(read_varint(pos));
+                handler.begin_object(context);
+                break;
+            case end_object_tag:
+                handler.end_object(context);
+                break;
+            case begin_array_tag:
+                context.minimum_structure_capacity_ = static_cast<size_t>(read_varint(pos));
+                handler.begin_array(context);
+                break;
+            case end_array_tag:
+                handler.end_array(context);
+                break;
+            case name_tag:
+                {
+                    size_t length;
+                    const Char* p = read_text(pos, text, length);
+                    handler.name(p, length, context);
+                }
+                break;
+            case string_tag:
+                {
+                    size_t length;
+                    const Char* p = read_text(pos, text, length);
+                    handler.value(p, length, context);
+                }
+                break;
+            case binary_tag:
+                {
+                    size_t length;
+                    const Char* p = read_text(pos, text, length);
+                    handler.binary(p, length, context);
+                }
+                break;
+            case number_tag:
+                {
+                    size_t length;
+                    const Char* p = read_text(pos, text, length);
+                    handler.number(p, length, context);
+                }
+                break;
+            case double_tag:
+                {
+                    double value;
+                    std::memcpy(&value, &data_[pos], sizeof(double));
+                    pos += sizeof(double);
+                    handler.value(value, context);
+                }
+                break;
+            case longlong_tag:
+                {
+                    uint64_t n = read_varint(pos);
+                    long long value = static_cast<long long>(n >> 1) ^ -static_cast<long long>(n & 1);
+                    handler.value(value, context);
+                }
+                break;
+            case ulonglong_tag:
+                handler.value(static_cast<unsigned long long>(read_varint(pos)), context);
+                break;
+            case true_tag:
+                handler.value(true, context);
+                break;
+            case false_tag:
+                handler.value(false, context);
+                break;
+            case null_tag:
+                handler.value(null_type(), context);
+                break;
+            default:
+                JSONCONS_THROW_EXCEPTION("Invalid event tape");
+            }
+        }
+    }
+
+    // Sends the recorded events to each handler, one after another, or each on
+    // its own thread if parallel is true. The tape is only read, so replays may
+    // run at the same time. Rethrows the first exception a handler threw, after
+    // every replay has finished.
+    void replay(const std::vector<basic_json_input_handler<Char>*>& handlers, bool parallel = false) const
+    {
+        if (!parallel || handlers.size() <= 1)
+        {
+            for (size_t i = 0; i < handlers.size(); ++i)
+            {
+                replay(*handlers[i]);
+            }
+            return;
+        }
+        std::vector<std::future<void>> futures;
+        for (size_t i = 1; i < handlers.size(); ++i)
+        {
+            basic_json_input_handler<Char>* handler = handlers[i];
+            futures.push_back(std::async(std::launch::async, [this,handler](){replay(*handler);}));
+        }
+        std::exception_ptr error;
+        try
+        {
+            replay(*handlers[0]);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        for (size_t i = 0; i < futures.size(); ++i)
+        {
+            try
+            {
+                futures[i].get();
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    template <typename C>
+    friend class basic_json_tape_recorder;
+
+    void write_tag(tag_type tag)
+    {
+        data_.push_back(tag);
+        ++event_count_;
+    }
+
+    void write_varint(uint64_t n)
+    {
+        while (n >= 0x80)
+        {
+            data_.push_back(static_cast<uint8_t>(n | 0x80));
+            n >>= 7;
+        }
+        data_.push_back(static_cast<uint8_t>(n));
+    }
+
+    void write_text(tag_type tag, const Char* p, size_t length)
+    {
+        write_tag(tag);
+        write_varint(length);
+        size_t n = length*sizeof(Char);
+        size_t pos = data_.size();
+        data_.resize(pos + n);
+        if (n > 0)
+        {
+            std::memcpy(&data_[pos], p, n);
+        }
+    }
+
+    uint64_t read_varint(size_t& pos) const
+    {
+        uint64_t n = 0;
+        unsigned shift = 0;
+        uint8_t b;
+        do
+        {
+            b = data_[pos++];
+            n |= static_cast<uint64_t>(b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        return n;
+    }
+
+    // Narrow text is passed straight from the tape, wider characters are
+    // copied out because the tape does not keep them aligned
+    const Char* read_text(size_t& pos, std::basic_string<Char>& text, size_t& length) const
+    {
+        length = static_cast<size_t>(read_varint(pos));
+        size_t n = length*sizeof(Char);
+        const uint8_t* p = data_.data() + pos;
+        pos += n;
+        if (sizeof(Char) == 1)
+        {
+            return reinterpret_cast<const Char*>(p);
+        }
+        text.resize(length);
+        if (n > 0)
+        {
+            std::memcpy(&text[0], p, n);
+        }
+        return text.data();
+    }
+
+    std::vector<uint8_t> data_;
+    size_t event_count_;
+};
+
+// Appends the events it receives to a basic_json_event_tape
+template <typename Char>
+class basic_json_tape_recorder : public basic_json_input_handler<Char>
+{
+public:
+    basic_json_tape_recorder(basic_json_event_tape<Char>& tape)
+        : tape_(std::addressof(tape))
+    {
+    }
+
+    basic_json_event_tape<Char>& tape()
+    {
+        return *tape_;
+    }
+
+private:
+    typedef basic_json_event_tape<Char> tape_type;
+
+    virtual void do_begin_json()
+    {
+        tape_->write_tag(tape_type::begin_json_tag);
+    }
+
+    virtual void do_end_json()
+    {
+        tape_->write_tag(tape_type::end_json_tag);
+    }
+
+    virtual void do_begin_object(const basic_parsing_context<Char>& context)
+    {
+        tape_->write_tag(tape_type::begin_object_tag);
+        tape_->write_varint(context.minimum_structure_capacity());
+    }
+
+    virtual void do_end_object(const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::end_object_tag);
+    }
+
+    virtual void do_begin_array(const basic_parsing_context<Char>& context)
+    {
+        tape_->write_tag(tape_type::begin_array_tag);
+        tape_->write_varint(context.minimum_structure_capacity());
+    }
+
+    virtual void do_end_array(const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::end_array_tag);
+    }
+
+    virtual void do_name(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        tape_->write_text(tape_type::name_tag, p, length);
+    }
+
+    virtual void do_string_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        tape_->write_text(tape_type::string_tag, p, length);
+    }
+
+    virtual void do_binary_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        tape_->write_text(tape_type::binary_tag, p, length);
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    {
+        tape_->write_text(tape_type::number_tag, p, length);
+    }
+
+    virtual void do_double_value(double value, const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::double_tag);
+        size_t pos = tape_->data_.size();
+        tape_->data_.resize(pos + sizeof(double));
+        std::memcpy(&tape_->data_[pos], &value, sizeof(double));
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::longlong_tag);
+        uint64_t n = static_cast<uint64_t>(value);
+        tape_->write_varint((n << 1) ^ (value < 0 ? ~uint64_t(0) : uint64_t(0)));
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::ulonglong_tag);
+        tape_->write_varint(value);
+    }
+
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(value ? tape_type::true_tag : tape_type::false_tag);
+    }
+
+    virtual void do_null_value(const basic_parsing_context<Char>&)
+    {
+        tape_->write_tag(tape_type::null_tag);
+    }
+
+    basic_json_event_tape<Char>* tape_;
+};
+
+typedef basic_json_event_tape<char> json_event_tape;
+typedef basic_json_event_tape<wchar_t> wjson_event_tape;
+typedef basic_json_tape_recorder<char> json_tape_recorder;
+typedef basic_json_tape_recorder<wchar_t> wjson_tape_recorder;
+
+}
+
+#endif
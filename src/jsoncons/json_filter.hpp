@@ -9,9 +9,12 @@
 #define JSONCONS_JSON_FILTER_HPP
 
 #include <string>
+#include <vector>
 
+#include "jsoncons/base64.hpp"
 #include "jsoncons/json_input_handler.hpp"
 #include "jsoncons/json_output_handler.hpp"
+#include "jsoncons/json_pointer_tokens.hpp"
 
 namespace jsoncons {
 
@@ -41,60 +44,72 @@ private:
         writer_->end_json();
     }
 
-    virtual void do_begin_object(const basic_parsing_context<Char>& context)
+    virtual void do_begin_object(const basic_parsing_context<Char>&)
     {
         writer_->begin_object();
     }
 
-    virtual void do_end_object(const basic_parsing_context<Char>& context)
+    virtual void do_end_object(const basic_parsing_context<Char>&)
     {
         writer_->end_object();
     }
 
-    virtual void do_begin_array(const basic_parsing_context<Char>& context)
+    virtual void do_begin_array(const basic_parsing_context<Char>&)
     {
         writer_->begin_array();
     }
 
-    virtual void do_end_array(const basic_parsing_context<Char>& context)
+    virtual void do_end_array(const basic_parsing_context<Char>&)
     {
         writer_->end_array();
     }
 
     virtual void do_name(const Char* name, size_t length, 
-                            const basic_parsing_context<Char>& context)
+                            const basic_parsing_context<Char>&)
     {
         writer_->name(name, length);
     }
 
     virtual void do_string_value(const Char* value, size_t length, 
-                              const basic_parsing_context<Char>& context)
+                              const basic_parsing_context<Char>&)
     {
         writer_->value(value, length);
     }
 
-    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+    virtual void do_binary_value(const Char* value, size_t length, 
+                                 const basic_parsing_context<Char>&)
+    {
+        writer_->binary(value, length);
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, 
+                                 const basic_parsing_context<Char>&)
+    {
+        writer_->number(p, length);
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>&)
     {
         writer_->value(value);
     }
 
     virtual void do_ulonglong_value(unsigned long long value, 
-                                 const basic_parsing_context<Char>& context)
+                                 const basic_parsing_context<Char>&)
     {
         writer_->value(value);
     }
 
-    virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+    virtual void do_double_value(double value, const basic_parsing_context<Char>&)
     {
         writer_->value(value);
     }
 
-    virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>&)
     {
         writer_->value(value);
     }
 
-    virtual void do_null_value(const basic_parsing_context<Char>& context)
+    virtual void do_null_value(const basic_parsing_context<Char>&)
     {
         writer_->value(null_type());
     }
@@ -102,6 +117,99 @@ private:
     basic_json_output_handler<Char>* writer_;
 };
 
+// The reverse of basic_json_input_output_adapter, passes output events on to an
+// input handler, with a parsing context given by the caller
+template <typename Char>
+class basic_json_output_input_adapter : public basic_json_output_handler<Char>
+{
+public:
+    basic_json_output_input_adapter(basic_json_input_handler<Char>& handler,
+                                    const basic_parsing_context<Char>& context)
+        : handler_(std::addressof(handler)), context_(std::addressof(context))
+    {
+    }
+
+private:
+
+    virtual void do_begin_json()
+    {
+        handler_->begin_json();
+    }
+
+    virtual void do_end_json()
+    {
+        handler_->end_json();
+    }
+
+    virtual void do_begin_object()
+    {
+        handler_->begin_object(*context_);
+    }
+
+    virtual void do_end_object()
+    {
+        handler_->end_object(*context_);
+    }
+
+    virtual void do_begin_array()
+    {
+        handler_->begin_array(*context_);
+    }
+
+    virtual void do_end_array()
+    {
+        handler_->end_array(*context_);
+    }
+
+    virtual void do_name(const Char* name, size_t length)
+    {
+        handler_->name(name, length, *context_);
+    }
+
+    virtual void do_string_value(const Char* value, size_t length)
+    {
+        handler_->value(value, length, *context_);
+    }
+
+    virtual void do_binary_value(const Char* value, size_t length)
+    {
+        handler_->binary(value, length, *context_);
+    }
+
+    virtual void do_number_value(const Char* p, size_t length)
+    {
+        handler_->number(p, length, *context_);
+    }
+
+    virtual void do_longlong_value(long long value)
+    {
+        handler_->value(value, *context_);
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value)
+    {
+        handler_->value(value, *context_);
+    }
+
+    virtual void do_double_value(double value)
+    {
+        handler_->value(value, *context_);
+    }
+
+    virtual void do_bool_value(bool value)
+    {
+        handler_->value(value, *context_);
+    }
+
+    virtual void do_null_value()
+    {
+        handler_->value(null_type(), *context_);
+    }
+
+    basic_json_input_handler<Char>* handler_;
+    const basic_parsing_context<Char>* context_;
+};
+
 template <typename Char>
 class basic_json_filter : public basic_json_input_handler<Char>
 {
@@ -184,6 +292,16 @@ private:
         handler_->value(value,length,context);
     }
 
+    virtual void do_binary_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        handler_->binary(value,length,context);
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        handler_->number(p,length,context);
+    }
+
     virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
     {
         handler_->value(value,context);
@@ -214,8 +332,201 @@ private:
     basic_parse_error_handler<Char>* err_handler_;
 };
 
+// Passes string values found at the given paths on as binary values, decoded from base64.
+// Paths are JSON Pointers in which a "*" segment matches any member name or array index,
+// e.g. "/thumbnails/*/data". Strings at those paths that are not valid base64 are passed on unchanged.
+template <typename Char>
+class basic_base64_decoding_filter : public basic_json_filter<Char>
+{
+    struct path_segment
+    {
+        bool any_;
+        bool is_index_;
+        size_t index_;
+        std::basic_string<Char> name_;
+    };
+
+    struct stack_item
+    {
+        stack_item(bool is_object)
+           : is_object_(is_object), index_(0)
+        {
+        }
+
+        bool is_object_;
+        size_t index_;
+        std::basic_string<Char> name_;
+    };
+public:
+    basic_base64_decoding_filter(basic_json_input_handler<Char>& handler,
+                                 const std::vector<std::basic_string<Char>>& paths)
+        : basic_json_filter<Char>(handler)
+    {
+        parse_paths(paths);
+    }
+
+    basic_base64_decoding_filter(basic_json_output_handler<Char>& output_handler,
+                                 const std::vector<std::basic_string<Char>>& paths)
+        : basic_json_filter<Char>(output_handler)
+    {
+        parse_paths(paths);
+    }
+
+private:
+    using basic_json_filter<Char>::input_handler;
+
+    void parse_paths(const std::vector<std::basic_string<Char>>& paths)
+    {
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            std::vector<std::basic_string<Char>> tokens = split_json_pointer(paths[i]);
+            std::vector<path_segment> segments(tokens.size());
+            for (size_t j = 0; j < tokens.size(); ++j)
+            {
+                path_segment& segment = segments[j];
+                segment.name_ = tokens[j];
+                segment.any_ = segment.name_.length() == 1 && segment.name_[0] == '*';
+                segment.index_ = 0;
+                segment.is_index_ = json_pointer_index(segment.name_, segment.index_);
+            }
+            paths_.push_back(segments);
+        }
+    }
+
+    bool at_path() const
+    {
+        for (size_t i = 0; i < paths_.size(); ++i)
+        {
+            const std::vector<path_segment>& segments = paths_[i];
+            if (segments.size() != stack_.size())
+            {
+                continue;
+            }
+            bool match = true;
+            for (size_t j = 0; match && j < segments.size(); ++j)
+            {
+                if (!segments[j].any_)
+                {
+                    match = stack_[j].is_object_ ? segments[j].name_ == stack_[j].name_
+                                                 : segments[j].is_index_ && segments[j].index_ == stack_[j].index_;
+                }
+            }
+            if (match)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void end_value()
+    {
+        if (!stack_.empty() && !stack_.back().is_object_)
+        {
+            ++stack_.back().index_;
+        }
+    }
+
+    virtual void do_begin_object(const basic_parsing_context<Char>& context)
+    {
+        stack_.push_back(stack_item(true));
+        input_handler().begin_object(context);
+    }
+
+    virtual void do_end_object(const basic_parsing_context<Char>& context)
+    {
+        stack_.pop_back();
+        input_handler().end_object(context);
+        end_value();
+    }
+
+    virtual void do_begin_array(const basic_parsing_context<Char>& context)
+    {
+        stack_.push_back(stack_item(false));
+        input_handler().begin_array(context);
+    }
+
+    virtual void do_end_array(const basic_parsing_context<Char>& context)
+    {
+        stack_.pop_back();
+        input_handler().end_array(context);
+        end_value();
+    }
+
+    virtual void do_name(const Char* name, size_t length, const basic_parsing_context<Char>& context)
+    {
+        stack_.back().name_.assign(name, length);
+        input_handler().name(name, length, context);
+    }
+
+    virtual void do_string_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        size_t decoded_length;
+        if (at_path())
+        {
+            buffer_.resize(base64_decoded_length_bound(length));
+            if (base64_decode(value, length, buffer_.data(), decoded_length))
+            {
+                input_handler().binary(buffer_.data(), decoded_length, context);
+                end_value();
+                return;
+            }
+        }
+        input_handler().value(value, length, context);
+        end_value();
+    }
+
+    virtual void do_binary_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        input_handler().binary(value, length, context);
+        end_value();
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        input_handler().number(p, length, context);
+        end_value();
+    }
+
+    virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+    {
+        input_handler().value(value, context);
+        end_value();
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+    {
+        input_handler().value(value, context);
+        end_value();
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context)
+    {
+        input_handler().value(value, context);
+        end_value();
+    }
+
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+    {
+        input_handler().value(value, context);
+        end_value();
+    }
+
+    virtual void do_null_value(const basic_parsing_context<Char>& context)
+    {
+        input_handler().value(null_type(), context);
+        end_value();
+    }
+
+    std::vector<std::vector<path_segment>> paths_;
+    std::vector<stack_item> stack_;
+    std::vector<Char> buffer_;
+};
+
 typedef basic_json_filter<char> json_filter;
 typedef basic_json_filter<wchar_t> wjson_filter;
+typedef basic_base64_decoding_filter<char> base64_decoding_filter;
+typedef basic_base64_decoding_filter<wchar_t> wbase64_decoding_filter;
 
 }
 
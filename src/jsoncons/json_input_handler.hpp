@@ -82,6 +82,16 @@ public:
         do_binary_value(value.data(), value.size(), context);
     }
 
+    void binary(const Char* p, size_t length, const basic_parsing_context<Char>& context) 
+    {
+        do_binary_value(p, length, context);
+    }
+
+    void number(const Char* p, size_t length, const basic_parsing_context<Char>& context) 
+    {
+        do_number_value(p, length, context);
+    }
+
     void value(int value, const basic_parsing_context<Char>& context) 
     {
         do_longlong_value(value,context);
@@ -160,6 +170,24 @@ private:
     virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context) = 0;
 
     virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context) = 0;
+
+    // The unconverted text of a number, by default converted as the reader would convert it
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        number_text_value val = parse_number_text(p, length);
+        switch (val.kind)
+        {
+        case number_text_value::longlong_kind:
+            do_longlong_value(val.longlong_value, context);
+            break;
+        case number_text_value::ulonglong_kind:
+            do_ulonglong_value(val.ulonglong_value, context);
+            break;
+        default:
+            do_double_value(val.double_value, context);
+            break;
+        }
+    }
 };
 
 
@@ -197,7 +225,7 @@ private:
     {
     }
 
-    virtual void do_name(const Char* p, size_t length, const basic_parsing_context<Char>&)
+    virtual void do_name(const Char*, size_t, const basic_parsing_context<Char>&)
     {
     }
 
@@ -205,7 +233,11 @@ private:
     {
     }
 
-    virtual void do_string_value(const Char*, size_t length, const basic_parsing_context<Char>&)
+    virtual void do_string_value(const Char*, size_t, const basic_parsing_context<Char>&)
+    {
+    }
+
+    virtual void do_binary_value(const Char*, size_t, const basic_parsing_context<Char>&)
     {
     }
 
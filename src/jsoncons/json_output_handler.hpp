@@ -80,6 +80,11 @@ public:
         do_binary_value(p, length);
     }
 
+    void number(const Char* p, size_t length) 
+    {
+        do_number_value(p, length);
+    }
+
     void value(int value) 
     {
         do_longlong_value(value);
@@ -125,6 +130,21 @@ public:
         do_null_value();
     }
 
+    void typed_array(const double* p, size_t length)
+    {
+        do_double_array_value(p, length);
+    }
+
+    void typed_array(const long long* p, size_t length)
+    {
+        do_longlong_array_value(p, length);
+    }
+
+    void typed_array(const unsigned long long* p, size_t length)
+    {
+        do_ulonglong_array_value(p, length);
+    }
+
 private:
 
     virtual void do_begin_json() = 0;
@@ -154,6 +174,56 @@ private:
     virtual void do_ulonglong_value(unsigned long long value) = 0;
 
     virtual void do_bool_value(bool value) = 0;
+
+    // The unconverted text of a number, by default converted as the reader would convert it
+    virtual void do_number_value(const Char* p, size_t length)
+    {
+        number_text_value val = parse_number_text(p, length);
+        switch (val.kind)
+        {
+        case number_text_value::longlong_kind:
+            do_longlong_value(val.longlong_value);
+            break;
+        case number_text_value::ulonglong_kind:
+            do_ulonglong_value(val.ulonglong_value);
+            break;
+        default:
+            do_double_value(val.double_value);
+            break;
+        }
+    }
+
+    // An array of numbers held contiguously, serializers may override to write it in bulk 
+
+    virtual void do_double_array_value(const double* p, size_t length)
+    {
+        do_begin_array();
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_double_value(p[i]);
+        }
+        do_end_array();
+    }
+
+    virtual void do_longlong_array_value(const long long* p, size_t length)
+    {
+        do_begin_array();
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_longlong_value(p[i]);
+        }
+        do_end_array();
+    }
+
+    virtual void do_ulonglong_array_value(const unsigned long long* p, size_t length)
+    {
+        do_begin_array();
+        for (size_t i = 0; i < length; ++i)
+        {
+            do_ulonglong_value(p[i]);
+        }
+        do_end_array();
+    }
 };
 
 template <typename Char>
@@ -169,7 +239,7 @@ private:
     {
     }
 
-    virtual void do_name(const Char* name, size_t length)
+    virtual void do_name(const Char*, size_t)
     {
     }
 
@@ -193,7 +263,11 @@ private:
     {
     }
 
-    virtual void do_string_value(const Char*, size_t length)
+    virtual void do_string_value(const Char*, size_t)
+    {
+    }
+
+    virtual void do_binary_value(const Char*, size_t)
     {
     }
 
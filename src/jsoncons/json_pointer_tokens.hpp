@@ -0,0 +1,132 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_POINTER_TOKENS_HPP
+#define JSONCONS_JSON_POINTER_TOKENS_HPP
+
+#include <string>
+#include <vector>
+#include "jsoncons/jsoncons.hpp"
+
+namespace jsoncons {
+
+// The reference tokens of a JSON Pointer (RFC 6901), unescaped. Throws
+// json_exception if p is neither empty nor starts with '/', or if a '~' is
+// not followed by '0' or '1'.
+template <typename Char>
+std::vector<std::basic_string<Char>> split_json_pointer(const Char* p, size_t length)
+{
+    std::vector<std::basic_string<Char>> tokens;
+    if (length == 0)
+    {
+        return tokens;
+    }
+    if (p[0] != '/')
+    {
+        JSONCONS_THROW_EXCEPTION_1("JSON Pointer %s does not start with /", std::basic_string<Char>(p, length));
+    }
+    std::basic_string<Char> name;
+    for (size_t i = 1; i <= length; ++i)
+    {
+        if (i == length || p[i] == '/')
+        {
+            tokens.push_back(name);
+            name.clear();
+        }
+        else if (p[i] == '~')
+        {
+            if (i + 1 < length && (p[i+1] == '0' || p[i+1] == '1'))
+            {
+                name.push_back(p[i+1] == '0' ? '~' : '/');
+                ++i;
+            }
+            else
+            {
+                JSONCONS_THROW_EXCEPTION_1("Invalid escape in JSON Pointer %s", std::basic_string<Char>(p, length));
+            }
+        }
+        else
+        {
+            name.push_back(p[i]);
+        }
+    }
+    return tokens;
+}
+
+template <typename Char>
+std::vector<std::basic_string<Char>> split_json_pointer(const std::basic_string<Char>& path)
+{
+    return split_json_pointer(path.data(), path.length());
+}
+
+// True if token is an array index, digits with no leading zero that fit in
+// size_t, and if so sets index
+template <typename Char>
+bool json_pointer_index(const std::basic_string<Char>& token, size_t& index)
+{
+    size_t n = token.length();
+    if (n == 0 || n > 19 || (token[0] == '0' && n > 1))
+    {
+        return false;
+    }
+    size_t value = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (token[i] < '0' || token[i] > '9')
+        {
+            return false;
+        }
+        value = value*10 + static_cast<size_t>(token[i] - '0');
+    }
+    index = value;
+    return true;
+}
+
+// The node that path leads to in a tree of nodes, adding any that are missing.
+// nodes[0] is the root, and each node has children_, a map from member name to
+// node, and any_, the node for the wildcard token "*" or size_t(-1) if none.
+template <class Node, typename Char>
+size_t find_or_add_path(std::vector<Node>& nodes, const std::basic_string<Char>& path)
+{
+    std::vector<std::basic_string<Char>> tokens = split_json_pointer(path);
+    size_t current = 0;
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        const std::basic_string<Char>& name = tokens[i];
+        size_t child;
+        if (name.length() == 1 && name[0] == '*')
+        {
+            child = nodes[current].any_;
+            if (child == static_cast<size_t>(-1))
+            {
+                child = nodes.size();
+                nodes[current].any_ = child;
+                nodes.push_back(Node());
+            }
+        }
+        else
+        {
+            auto it = nodes[current].children_.find(name);
+            if (it != nodes[current].children_.end())
+            {
+                child = it->second;
+            }
+            else
+            {
+                child = nodes.size();
+                nodes[current].children_[name] = child;
+                nodes.push_back(Node());
+            }
+        }
+        current = child;
+    }
+    return current;
+}
+
+}
+
+#endif
@@ -32,7 +32,10 @@ namespace parse_state_type
     enum parse_state_type_t {initial_s,name_s,value_separator_s,name_separator_s,value_completed_s};
 }
 
-template<typename Char>
+// Handler is basic_json_input_handler<Char> by default, so that events go through its 
+// virtual functions. A concrete handler type with non-virtual event functions of the 
+// same names, such as basic_json_deserializer, has its event functions called directly.
+template<typename Char, class Handler = basic_json_input_handler<Char>>
 class basic_json_reader : private basic_parsing_context<Char>
 {
     struct stack_item
@@ -107,7 +110,9 @@ class basic_json_reader : private basic_parsing_context<Char>
         size_t minimum_structure_capacity_;
     };
 
-    void parse();
+    bool parse();
+    void end_parse();
+    bool skip_structure();
 
 public:
 
@@ -124,7 +129,7 @@ public:
 
     //  Parse an input stream of JSON text into a json json_object_impl
     basic_json_reader(std::basic_istream<Char>& is,
-                      basic_json_input_handler<Char>& handler,
+                      Handler& handler,
                       basic_parse_error_handler<Char>& err_handler)
        :
          column_(0),
@@ -139,11 +144,14 @@ public:
          err_handler_(std::addressof(err_handler)),
          bof_(true),
          eof_(false),
+         lazy_numbers_(false),
+         paused_(false),
+         skip_(false),
          is_(std::addressof(is))
     {
     }
     basic_json_reader(std::basic_istream<Char>& is,
-                      basic_json_input_handler<Char>& handler)
+                      Handler& handler)
 
        :
          column_(0),
@@ -158,6 +166,9 @@ public:
          err_handler_(std::addressof(default_basic_parse_error_handler<Char>::instance())),
          bof_(true),
          eof_(false),
+         lazy_numbers_(false),
+         paused_(false),
+         skip_(false),
          is_(std::addressof(is))
     {
     }
@@ -168,6 +179,31 @@ public:
 
     void read();
 
+    // Called by the handler during an event, makes read() or resume() return
+    // after that event, with the rest of the text still to be read
+    void pause()
+    {
+        paused_ = true;
+    }
+
+    // True if the last read() or resume() returned because of pause()
+    bool paused() const
+    {
+        return paused_;
+    }
+
+    // Continues a paused read
+    void resume();
+
+    // Called by the handler during a begin_object or begin_array event, or while
+    // paused after one, makes the reader pass over the rest of that object or
+    // array without reporting its events. Only strings and brackets are looked
+    // at, the skipped text is not otherwise checked.
+    void skip()
+    {
+        skip_ = true;
+    }
+
     bool eof() const
     {
         return eof_;
@@ -183,6 +219,18 @@ public:
         buffer_capacity_ = buffer_capacity;
     }
 
+    bool lazy_numbers() const
+    {
+        return lazy_numbers_;
+    }
+
+    // When true, numbers are passed to the handler as their original text, 
+    // and are converted only if and when the handler needs their value
+    void lazy_numbers(bool value)
+    {
+        lazy_numbers_ = value;
+    }
+
 private:
     basic_json_reader(const basic_json_reader&); // noop
     basic_json_reader& operator = (const basic_json_reader&); // noop
@@ -313,65 +361,19 @@ private:
     size_t buffer_length_;
     size_t hard_buffer_length_;
     size_t estimation_buffer_length_;
-    basic_json_input_handler<Char> *handler_;
+    Handler *handler_;
     basic_parse_error_handler<Char> *err_handler_;
     bool bof_;
     bool eof_;
+    bool lazy_numbers_;
+    bool paused_;
+    bool skip_;
     std::basic_istream<Char> *is_;
     Char c_;
 };
 
-template<typename Char>
-unsigned long long string_to_unsigned(const Char *s, size_t length) throw(std::overflow_error)
-{
-    const unsigned long long max_value = std::numeric_limits<unsigned long long>::max JSONCONS_NO_MACRO_EXP();
-    const unsigned long long max_value_div_10 = max_value/10;
-    unsigned long long n = 0;
-    for (size_t i = 0; i < length; ++i)
-    {
-        unsigned long long x = s[i] - '0';
-        if (n > max_value_div_10)
-        {
-            throw std::overflow_error("Unsigned overflow");
-        }
-        n = n * 10;
-        if (n > max_value - x)
-        {
-            throw std::overflow_error("Unsigned overflow");
-        }
-
-        n += x;
-    }
-    return n;
-}
-
-template<typename Char>
-long long string_to_integer(bool has_neg, const Char *s, size_t length) throw(std::overflow_error)
-{
-    const long long max_value = std::numeric_limits<long long>::max JSONCONS_NO_MACRO_EXP();
-    const long long max_value_div_10 = max_value/10;
-
-    long long n = 0;
-    for (size_t i = 0; i < length; ++i)
-    {
-        long long x = s[i] - '0';
-        if (n > max_value_div_10)
-        {
-            throw std::overflow_error("Integer overflow");
-        }
-        n = n * 10;
-        if (n > max_value - x)
-        {
-            throw std::overflow_error("Integer overflow");
-        }
-
-        n += x;
-    }
-    return has_neg ? -n : n;
-}
-
-template<typename Char>
-void basic_json_reader<Char>::read()
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::read()
 {
     if (is_->bad())
     {
@@ -391,8 +393,120 @@ void basic_json_reader<Char>::read()
         read_some();
     }
 
+    paused_ = false;
+    skip_ = false;
+    stack_.clear();
     stack_.push_back(stack_item(structure_type::json_text));
-    parse();
+    if (!parse())
+    {
+        end_parse();
+    }
+}
+
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::resume()
+{
+    JSONCONS_ASSERT(paused_);
+    paused_ = false;
+    if (skip_)
+    {
+        skip_ = false;
+        if (skip_structure())
+        {
+            end_parse();
+            return;
+        }
+    }
+    if (!parse())
+    {
+        end_parse();
+    }
+}
+
+// Passes over the rest of the object or array on the top of the stack, returns
+// true if it was the top level value
+template<typename Char, class Handler>
+bool basic_json_reader<Char,Handler>::skip_structure()
+{
+    size_t depth = 1;
+    bool in_string = false;
+    while (depth > 0)
+    {
+        if (buffer_position_ >= buffer_length_)
+        {
+            read_some();
+            if (eof())
+            {
+                err_handler_->error(std::error_code(json_parser_errc::unexpected_eof, json_parser_category()), *this);
+                return false;
+            }
+        }
+        while ((depth > 0) & (buffer_position_ < buffer_length_))
+        {
+            c_ = buffer_[buffer_position_++];
+            ++column_;
+            if (in_string)
+            {
+                if (c_ == '\\')
+                {
+                    ++buffer_position_;
+                    ++column_;
+                }
+                else if (c_ == '\"')
+                {
+                    in_string = false;
+                }
+                continue;
+            }
+            switch (c_)
+            {
+            case '\"':
+                in_string = true;
+                break;
+            case begin_object:
+            case begin_array:
+                ++depth;
+                break;
+            case end_object:
+            case end_array:
+                --depth;
+                break;
+            case '\n':
+                ++line_;
+                column_ = 0;
+                break;
+            case '/':
+                {
+                    Char next = buffer_[buffer_position_];
+                    if (next == '/')
+                    {
+                        ++buffer_position_;
+                        ignore_single_line_comment();
+                    }
+                    else if (next == '*')
+                    {
+                        ++buffer_position_;
+                        ignore_multi_line_comment();
+                    }
+                }
+                break;
+            }
+        }
+    }
+    stack_.pop_back();
+    if (stack_.back().is_top())
+    {
+        handler_->end_json();
+        return true;
+    }
+    stack_.back().state_ = parse_state_type::value_completed_s;
+    return false;
+}
+
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::end_parse()
+{
+    paused_ = false;
     stack_.pop_back();
     if (stack_.size() > 0)
     {
@@ -400,8 +514,9 @@ void basic_json_reader<Char>::read()
     }
 }
 
-template<typename Char>
-void basic_json_reader<Char>::parse()
+// Returns true if paused before the end of the json text
+template<typename Char, class Handler>
+bool basic_json_reader<Char,Handler>::parse()
 {
     while (!eof())
     {
@@ -540,7 +655,7 @@ void basic_json_reader<Char>::parse()
                 else
                 {
                     handler_->end_json();
-                    return;
+                    return false;
                 }
                 break;
             case end_array:
@@ -567,7 +682,7 @@ void basic_json_reader<Char>::parse()
                 else
                 {
                     handler_->end_json();
-                    return;
+                    return false;
                 }
                 break;
             case 't':
@@ -653,21 +768,37 @@ void basic_json_reader<Char>::parse()
                 }
                 break;
             }
+            if (paused_ | skip_)
+            {
+                if (skip_)
+                {
+                    skip_ = false;
+                    if (skip_structure())
+                    {
+                        return false;
+                    }
+                }
+                if (paused_)
+                {
+                    return true;
+                }
+            }
         }
         if (buffer_position_ >= buffer_length_)
         {
             read_some();
         }
     }
+    return false;
 }
 
-template<typename Char>
-void basic_json_reader<Char>::parse_number()
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::parse_number()
 {
     string_buffer_.clear();
     bool has_frac_or_exp = false;
     bool has_neg = (c_ == '-') ? true : false;
-    if (!has_neg)
+    if (!has_neg || lazy_numbers_)
     {
         string_buffer_.push_back(c_);
     }
@@ -707,7 +838,19 @@ void basic_json_reader<Char>::parse_number()
                 break;
             default:
                 {
-                    if (has_frac_or_exp)
+                    if (lazy_numbers_)
+                    {
+                        if (is_number_text(string_buffer_.data(), string_buffer_.length()))
+                        {
+                            handler_->number(string_buffer_.data(), string_buffer_.length(), *this);
+                        }
+                        else
+                        {
+                            err_handler_->error(std::error_code(json_parser_errc::invalid_number, json_parser_category()), *this);
+                            handler_->value(null_type(), *this);
+                        }
+                    }
+                    else if (has_frac_or_exp)
                     {
                         try
                         {
@@ -780,8 +923,8 @@ void basic_json_reader<Char>::parse_number()
     }
 }
 
-template<typename Char>
-void basic_json_reader<Char>::parse_string()
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::parse_string()
 {
     string_buffer_.clear();
 
@@ -897,8 +1040,8 @@ void basic_json_reader<Char>::parse_string()
     }
 }
 
-template<typename Char>
-void basic_json_reader<Char>::ignore_single_line_comment()
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::ignore_single_line_comment()
 {
     bool done = false;
     while (!done)
@@ -937,8 +1080,8 @@ void basic_json_reader<Char>::ignore_single_line_comment()
     }
 }
 
-template<typename Char>
-void basic_json_reader<Char>::ignore_multi_line_comment()
+template<typename Char, class Handler>
+void basic_json_reader<Char,Handler>::ignore_multi_line_comment()
 {
     bool done = false;
     while (!done)
@@ -986,8 +1129,8 @@ void basic_json_reader<Char>::ignore_multi_line_comment()
     }
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::estimate_minimum_array_capacity() const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::estimate_minimum_array_capacity() const
 {
     size_t size = 0;
     size_t pos = buffer_position_;
@@ -1047,8 +1190,8 @@ size_t basic_json_reader<Char>::estimate_minimum_array_capacity() const
     return size;
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::estimate_minimum_object_capacity() const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::estimate_minimum_object_capacity() const
 {
     size_t size = 0;
     size_t pos = buffer_position_;
@@ -1092,8 +1235,8 @@ size_t basic_json_reader<Char>::estimate_minimum_object_capacity() const
     return size;
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::skip_array(size_t pos, const size_t end) const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::skip_array(size_t pos, const size_t end) const
 {
     bool done = false;
     while (!done & (pos < end))
@@ -1122,8 +1265,8 @@ size_t basic_json_reader<Char>::skip_array(size_t pos, const size_t end) const
     return pos;
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::skip_string(size_t pos, const size_t end) const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::skip_string(size_t pos, const size_t end) const
 {
     bool done = false;
     while (!done & (pos < end))
@@ -1154,8 +1297,8 @@ size_t basic_json_reader<Char>::skip_string(size_t pos, const size_t end) const
     return pos;
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::skip_number(size_t pos, const size_t end) const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::skip_number(size_t pos, const size_t end) const
 {
     bool done = false;
     while (!done & (pos < end))
@@ -1188,8 +1331,8 @@ size_t basic_json_reader<Char>::skip_number(size_t pos, const size_t end) const
     return pos;
 }
 
-template<typename Char>
-size_t basic_json_reader<Char>::skip_object(size_t pos, const size_t end) const
+template<typename Char, class Handler>
+size_t basic_json_reader<Char,Handler>::skip_object(size_t pos, const size_t end) const
 {
     bool done = false;
     while (!done & (pos < end))
@@ -1218,8 +1361,8 @@ size_t basic_json_reader<Char>::skip_object(size_t pos, const size_t end) const
     return pos;
 }
 
-template<typename Char>
-uint32_t basic_json_reader<Char>::decode_unicode_codepoint()
+template<typename Char, class Handler>
+uint32_t basic_json_reader<Char,Handler>::decode_unicode_codepoint()
 {
     uint32_t cp = decode_unicode_escape_sequence();
     if (hard_buffer_length_ - buffer_position_ < 2)
@@ -1244,8 +1387,8 @@ uint32_t basic_json_reader<Char>::decode_unicode_codepoint()
     return cp;
 }
 
-template<typename Char>
-uint32_t basic_json_reader<Char>::decode_unicode_escape_sequence()
+template<typename Char, class Handler>
+uint32_t basic_json_reader<Char,Handler>::decode_unicode_escape_sequence()
 {
     if (hard_buffer_length_ - buffer_position_ < 4)
     {
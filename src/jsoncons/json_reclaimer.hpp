@@ -0,0 +1,111 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_RECLAIMER_HPP
+#define JSONCONS_JSON_RECLAIMER_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "jsoncons/json1.hpp"
+
+namespace jsoncons {
+
+template<typename Char, class Alloc>
+class basic_json_reclaimer
+{
+public:
+    basic_json_reclaimer()
+        : pending_(), busy_(false), done_(false)
+    {
+        thread_ = std::thread(&basic_json_reclaimer::run, this);
+    }
+
+    ~basic_json_reclaimer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        pending_cv_.notify_one();
+        thread_.join();
+    }
+
+    // Takes ownership of val, leaving it null, and frees it on the reclaimer thread.
+    // Scalars are cheap to free and are released on the calling thread.
+    void reclaim(basic_json<Char,Alloc>& val)
+    {
+        if (val.is_array() || val.is_object())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.push_back(std::move(val));
+            }
+            pending_cv_.notify_one();
+        }
+        else
+        {
+            basic_json<Char,Alloc>(null_type()).swap(val);
+        }
+    }
+
+    void reclaim(basic_json<Char,Alloc>&& val)
+    {
+        reclaim(val);
+    }
+
+    // Blocks until everything handed over so far has been freed.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this]{return pending_.empty() && !busy_;});
+    }
+
+private:
+    basic_json_reclaimer(const basic_json_reclaimer&); // noop
+    basic_json_reclaimer& operator=(const basic_json_reclaimer&); // noop
+
+    void run()
+    {
+        std::vector<basic_json<Char,Alloc>> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            pending_cv_.wait(lock, [this]{return done_ || !pending_.empty();});
+            if (pending_.empty())
+            {
+                break;
+            }
+            batch.swap(pending_);
+            busy_ = true;
+            lock.unlock();
+            batch.clear();
+            lock.lock();
+            busy_ = false;
+            if (pending_.empty())
+            {
+                idle_cv_.notify_all();
+            }
+        }
+    }
+
+    std::vector<basic_json<Char,Alloc>> pending_;
+    bool busy_;
+    bool done_;
+    std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::condition_variable idle_cv_;
+    std::thread thread_;
+};
+
+typedef basic_json_reclaimer<char,std::allocator<void>> json_reclaimer;
+typedef basic_json_reclaimer<wchar_t,std::allocator<void>> wjson_reclaimer;
+
+}
+
+#endif
@@ -14,16 +14,41 @@
 #include <istream>
 #include <ostream>
 #include <cstdlib>
+#include <memory>
+#include <algorithm>
 #include "jsoncons/jsoncons.hpp"
 #include "jsoncons/output_format.hpp"
+#include "jsoncons/output_sink.hpp"
 #include "jsoncons/json2.hpp"
 #include "jsoncons/json_output_handler.hpp"
 #include <limits> // std::numeric_limits
 
 namespace jsoncons {
 
-template<typename Char>
-class basic_json_serializer : public basic_json_output_handler<Char>
+// Options taken at run time from the constructor's indenting argument and 
+// the output format's escape_solidus and escape_all_non_ascii
+struct dynamic_serializer_options
+{
+    static const bool is_static = false;
+    static const bool indenting = false;
+    static const bool escape_all_non_ascii = false;
+    static const bool escape_solidus = false;
+};
+
+// Options fixed at compile time, so that the serializer is compiled without 
+// the branches for the choices not taken. The indenting constructor argument 
+// and the format's escape settings are ignored.
+template <bool Indenting, bool EscapeAllNonAscii = false, bool EscapeSolidus = false>
+struct static_serializer_options
+{
+    static const bool is_static = true;
+    static const bool indenting = Indenting;
+    static const bool escape_all_non_ascii = EscapeAllNonAscii;
+    static const bool escape_solidus = EscapeSolidus;
+};
+
+template<typename Char, class Options>
+class basic_json_serializer final : public basic_json_output_handler<Char>
 {
     struct stack_item
     {
@@ -42,30 +67,215 @@ class basic_json_serializer : public basic_json_output_handler<Char>
     };
 public:
     basic_json_serializer(std::basic_ostream<Char>& os)
-       : os_(std::addressof(os)), indent_(0), indenting_(false)
+       : os_sink_(new basic_ostream_sink<Char>(os)), buffer_(*os_sink_), indent_(0), indenting_(false)
     {
     }
 
     basic_json_serializer(std::basic_ostream<Char>& os, bool indenting)
-       : os_(std::addressof(os)), indent_(0), indenting_(indenting)
+       : os_sink_(new basic_ostream_sink<Char>(os)), buffer_(*os_sink_), indent_(0), indenting_(indenting)
     {
     }
 
     basic_json_serializer(std::basic_ostream<Char>& os, const basic_output_format<Char>& format)
-       : os_(std::addressof(os)), format_(format), indent_(0),
+       : os_sink_(new basic_ostream_sink<Char>(os)), buffer_(*os_sink_), format_(format), indent_(0),
          indenting_(false) // Deprecated behavior
     {
     }
     basic_json_serializer(std::basic_ostream<Char>& os, const basic_output_format<Char>& format, bool indenting)
-       : os_(std::addressof(os)), format_(format), indent_(0), indenting_(indenting)
+       : os_sink_(new basic_ostream_sink<Char>(os)), buffer_(*os_sink_), format_(format), indent_(0), indenting_(indenting)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<Char>& sink)
+       : buffer_(sink), indent_(0), indenting_(false)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<Char>& sink, bool indenting)
+       : buffer_(sink), indent_(0), indenting_(indenting)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<Char>& sink, const basic_output_format<Char>& format)
+       : buffer_(sink), format_(format), indent_(0), indenting_(false)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<Char>& sink, const basic_output_format<Char>& format, bool indenting)
+       : buffer_(sink), format_(format), indent_(0), indenting_(indenting)
     {
     }
 
     ~basic_json_serializer()
     {
+        try
+        {
+            buffer_.flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    template <typename Char2, typename Alloc>
+    friend class basic_json;
+
+    // Passes buffered output to the sink and flushes the sink. Output is otherwise
+    // passed on when the buffer fills and whenever a top level value is complete.
+    void flush()
+    {
+        buffer_.flush();
+        buffer_.sink().flush();
+    }
+
+    // The event functions of this class, called without virtual dispatch when the 
+    // static type is basic_json_serializer, see basic_json::walk
+    // The class is final, so that no override of the do_ functions can be bypassed this way.
+    using basic_json_output_handler<Char>::name;
+    using basic_json_output_handler<Char>::value;
+
+    void begin_json()
+    {
+        basic_json_serializer::do_begin_json();
+    }
+
+    void end_json()
+    {
+        basic_json_serializer::do_end_json();
+    }
+
+    void begin_object()
+    {
+        basic_json_serializer::do_begin_object();
+    }
+
+    void end_object()
+    {
+        basic_json_serializer::do_end_object();
+    }
+
+    void begin_array()
+    {
+        basic_json_serializer::do_begin_array();
+    }
+
+    void end_array()
+    {
+        basic_json_serializer::do_end_array();
+    }
+
+    void name(const Char* p, size_t length)
+    {
+        basic_json_serializer::do_name(p, length);
+    }
+
+    void value(const Char* p, size_t length)
+    {
+        basic_json_serializer::do_string_value(p, length);
+    }
+
+    void binary(const Char* p, size_t length)
+    {
+        basic_json_serializer::do_binary_value(p, length);
+    }
+
+    void number(const Char* p, size_t length)
+    {
+        basic_json_serializer::do_number_value(p, length);
+    }
+
+    void value(long long value)
+    {
+        basic_json_serializer::do_longlong_value(value);
+    }
+
+    void value(unsigned long long value)
+    {
+        basic_json_serializer::do_ulonglong_value(value);
+    }
+
+    void value(double value)
+    {
+        basic_json_serializer::do_double_value(value);
+    }
+
+    void value(bool value)
+    {
+        basic_json_serializer::do_bool_value(value);
+    }
+
+    void value(null_type)
+    {
+        basic_json_serializer::do_null_value();
+    }
+
+    void typed_array(const double* p, size_t length)
+    {
+        basic_json_serializer::do_double_array_value(p, length);
+    }
+
+    void typed_array(const long long* p, size_t length)
+    {
+        basic_json_serializer::do_longlong_array_value(p, length);
+    }
+
+    void typed_array(const unsigned long long* p, size_t length)
+    {
+        basic_json_serializer::do_ulonglong_array_value(p, length);
     }
 
 private:
+    bool indenting() const
+    {
+        if (Options::is_static)
+        {
+            return Options::indenting;
+        }
+        return indenting_;
+    }
+
+    bool escape_solidus() const
+    {
+        if (Options::is_static)
+        {
+            return Options::escape_solidus;
+        }
+        return format_.escape_solidus();
+    }
+
+    bool escape_all_non_ascii() const
+    {
+        if (Options::is_static)
+        {
+            return Options::escape_all_non_ascii;
+        }
+        return format_.escape_all_non_ascii();
+    }
+
+    // A fragment formats a range of the elements or members of the structure open in parent,
+    // producing exactly the text parent would have produced for them
+    void begin_fragment(const basic_json_serializer<Char,Options>& parent, size_t count)
+    {
+        stack_.push_back(parent.stack_.back());
+        stack_.back().count_ = count;
+        stack_.back().content_indented_ = false;
+        indent_ = parent.indent_;
+    }
+
+    // Returns true if the fragment started a new line within the structure
+    bool end_fragment()
+    {
+        buffer_.flush();
+        return stack_.back().content_indented_;
+    }
+
+    void append_fragment(const std::basic_string<Char>& text, size_t count, bool content_indented)
+    {
+        buffer_.write(text);
+        stack_.back().count_ += count;
+        stack_.back().content_indented_ = stack_.back().content_indented_ || content_indented;
+    }
+
     // Implementing methods
     virtual void do_begin_json()
     {
@@ -73,30 +283,31 @@ private:
 
     virtual void do_end_json()
     {
+        buffer_.flush();
     }
 
     virtual void do_begin_object()
     {
         begin_structure();
 
-        if (indenting_ && !stack_.empty() && stack_.back().is_object())
+        if (indenting() && !stack_.empty() && stack_.back().is_object())
         {
             write_indent();
         }
         stack_.push_back(stack_item(true));
-        os_->put('{');
+        buffer_.put('{');
         indent();
     }
 
     virtual void do_end_object()
     {
         unindent();
-        if (indenting_ && !stack_.empty())
+        if (indenting() && !stack_.empty())
         {
             write_indent();
         }
         stack_.pop_back();
-        os_->put('}');
+        buffer_.put('}');
 
         end_value();
     }
@@ -105,24 +316,24 @@ private:
     {
         begin_structure();
 
-        if (indenting_ && !stack_.empty() && stack_.back().is_object())
+        if (indenting() && !stack_.empty() && stack_.back().is_object())
         {
             write_indent();
         }
         stack_.push_back(stack_item(false));
-        os_->put('[');
+        buffer_.put('[');
         indent();
     }
 
     virtual void do_end_array()
     {
         unindent();
-        if (indenting_ && !stack_.empty() && stack_.back().content_indented_)
+        if (indenting() && !stack_.empty() && stack_.back().content_indented_)
         {
             write_indent();
         }
         stack_.pop_back();
-        os_->put(']');
+        buffer_.put(']');
 
         end_value();
     }
@@ -130,17 +341,17 @@ private:
     virtual void do_name(const Char* name, size_t length)
     {
         begin_element();
-        os_->put('\"');
-        escape_string<Char>(name, length, format_, *os_);
-        os_->put('\"');
-        os_->put(':');
+        buffer_.put('\"');
+        write_escaped_string(name, length, escape_solidus(), escape_all_non_ascii(), buffer_);
+        buffer_.put('\"');
+        buffer_.put(':');
     }
 
     virtual void do_null_value()
     {
         begin_value();
 
-        *os_ << json_char_traits<Char,sizeof(Char)>::null_literal();
+        buffer_.write(json_char_traits<Char,sizeof(Char)>::null_literal());
 
         end_value();
     }
@@ -149,9 +360,9 @@ private:
     {
         begin_value();
 
-        os_->put('\"');
-        escape_string<Char>(value, length, format_, *os_);
-        os_->put('\"');
+        buffer_.put('\"');
+        write_escaped_string(value, length, escape_solidus(), escape_all_non_ascii(), buffer_);
+        buffer_.put('\"');
 
         end_value();
     }
@@ -160,9 +371,9 @@ private:
     {
         begin_value();
 
-        os_->put('\"');
-        base64_string<Char>(value, length, format_, *os_);
-        os_->put('\"');
+        buffer_.put('\"');
+        base64_string<Char>(value, length, format_, buffer_);
+        buffer_.put('\"');
 
         end_value();
     }
@@ -171,31 +382,7 @@ private:
     {
         begin_value();
 
-        if (is_nan(value) && format_.replace_nan())
-        {
-            *os_ << format_.nan_replacement();
-        }
-        else if (is_pos_inf(value) && format_.replace_pos_inf())
-        {
-            *os_ << format_.pos_inf_replacement();
-        }
-        else if (is_neg_inf(value) && format_.replace_neg_inf())
-        {
-            *os_ << format_.neg_inf_replacement();
-        }
-        else if (format_.floatfield() != 0)
-        {
-            std::basic_ostringstream<Char> os;
-            os.imbue(std::locale::classic());
-            os.setf(format_.floatfield(), std::ios::floatfield);
-            os << std::showpoint << std::setprecision(format_.precision()) << value;
-            *os_ << os.str();
-        }
-        else
-        {
-            std::basic_string<Char> buf = float_to_string<Char>(value,format_.precision());
-            *os_ << buf;
-        }
+        write_number(value);
 
         end_value();
     }
@@ -204,7 +391,7 @@ private:
     {
         begin_value();
 
-        *os_ << value;
+        write_number(value);
 
         end_value();
     }
@@ -213,7 +400,16 @@ private:
     {
         begin_value();
 
-        *os_ << value;
+        write_number(value);
+
+        end_value();
+    }
+
+    virtual void do_number_value(const Char* p, size_t length)
+    {
+        begin_value();
+
+        buffer_.write(p, length);
 
         end_value();
     }
@@ -222,20 +418,110 @@ private:
     {
         begin_value();
 
-        *os_ << (value ? json_char_traits<Char,sizeof(Char)>::true_literal() :  json_char_traits<Char,sizeof(Char)>::false_literal());
+        buffer_.write(value ? json_char_traits<Char,sizeof(Char)>::true_literal() :  json_char_traits<Char,sizeof(Char)>::false_literal());
 
         end_value();
     }
 
+    virtual void do_double_array_value(const double* p, size_t length)
+    {
+        write_numbers(p, length);
+    }
+
+    virtual void do_longlong_array_value(const long long* p, size_t length)
+    {
+        write_numbers(p, length);
+    }
+
+    virtual void do_ulonglong_array_value(const unsigned long long* p, size_t length)
+    {
+        write_numbers(p, length);
+    }
+
+    // Writes a whole array of numbers without the per element bookkeeping
+    template <class T>
+    void write_numbers(const T* p, size_t length)
+    {
+        do_begin_array();
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (i > 0)
+            {
+                buffer_.put(',');
+            }
+            write_number(p[i]);
+        }
+        stack_.back().count_ += length;
+
+        do_end_array();
+    }
+
+    // Formats into a buffer on the stack, very high precisions fall back to a string
+    void write_number(double value)
+    {
+        if (is_nan(value) && format_.replace_nan())
+        {
+            buffer_.write(format_.nan_replacement());
+        }
+        else if (is_pos_inf(value) && format_.replace_pos_inf())
+        {
+            buffer_.write(format_.pos_inf_replacement());
+        }
+        else if (is_neg_inf(value) && format_.replace_neg_inf())
+        {
+            buffer_.write(format_.neg_inf_replacement());
+        }
+        else if (format_.floatfield() != 0)
+        {
+            std::basic_ostringstream<Char> os;
+            os.imbue(std::locale::classic());
+            os.setf(format_.floatfield(), std::ios::floatfield);
+            os << std::showpoint << std::setprecision(format_.precision()) << value;
+            buffer_.write(os.str());
+        }
+        else
+        {
+            char text[64];
+            size_t length = format_float(value, format_.precision(), text, sizeof(text));
+            if (length != 0)
+            {
+                Char chars[64];
+                std::copy(text, text + length, chars);
+                buffer_.write(chars, length);
+            }
+            else
+            {
+                buffer_.write(float_to_string<Char>(value,format_.precision()));
+            }
+        }
+    }
+
+    void write_number(unsigned long long value)
+    {
+        Char digits[32];
+        Char* last = digits + 32;
+        Char* first = format_unsigned(value, last);
+        buffer_.write(first, last - first);
+    }
+
+    void write_number(long long value)
+    {
+        Char digits[32];
+        Char* last = digits + 32;
+        Char* first = format_integer(value, last);
+        buffer_.write(first, last - first);
+    }
+
     void begin_element()
     {
         if (!stack_.empty())
         {
             if (stack_.back().count_ > 0)
             {
-                os_->put(',');
+                buffer_.put(',');
             }
-            if (indenting_)
+            if (indenting())
             {
                 write_indent();
             }
@@ -249,7 +535,7 @@ private:
             //begin_element();
             if (stack_.back().count_ > 0)
             {
-                os_->put(',');
+                buffer_.put(',');
             }
         }
     }
@@ -260,6 +546,10 @@ private:
         {
             ++stack_.back().count_;
         }
+        else
+        {
+            buffer_.flush();
+        }
     }
 
     void begin_structure()
@@ -286,14 +576,15 @@ private:
         {
             stack_.back().content_indented_ = true;
         }
-        os_->put('\n');
-        for (int i = 0; i < indent_; ++i)
+        buffer_.put('\n');
+        if (indent_ > 0)
         {
-            os_->put(' ');
+            buffer_.fill(' ', indent_);
         }
     }
 
-    std::basic_ostream<Char>* os_;
+    std::unique_ptr<basic_ostream_sink<Char>> os_sink_;
+    basic_output_buffer<Char> buffer_;
     basic_output_format<Char> format_;
     std::vector<stack_item> stack_;
     int indent_;
@@ -305,6 +596,10 @@ private:
 
 typedef basic_json_serializer<char> json_serializer;
 typedef basic_json_serializer<wchar_t> wjson_serializer;
+typedef basic_json_serializer<char,static_serializer_options<false>> compact_json_serializer;
+typedef basic_json_serializer<wchar_t,static_serializer_options<false>> wcompact_json_serializer;
+typedef basic_json_serializer<char,static_serializer_options<true>> pretty_json_serializer;
+typedef basic_json_serializer<wchar_t,static_serializer_options<true>> wpretty_json_serializer;
 
 }
 #endif
@@ -19,6 +19,9 @@
 #include <iomanip>
 #include <utility>
 #include <new>
+#include <atomic>
+#include <thread>
+#include <future>
 #include "jsoncons/json1.hpp"
 
 namespace jsoncons {
@@ -45,109 +48,565 @@ public:
     }
 };
 
+// Calls f(first,last) over consecutive ranges covering [0,n), running the ranges 
+// concurrently on up to max_threads threads when n is large enough to pay for it
+template <class F>
+void for_each_chunk(size_t n, size_t max_threads, F f)
+{
+    const size_t min_chunk_size = 4096;
+    size_t chunks = std::min(max_threads, n / min_chunk_size);
+    if (chunks <= 1)
+    {
+        f(0, n);
+        return;
+    }
+    const size_t chunk_size = (n + chunks - 1) / chunks;
+    std::vector<std::future<void>> futures;
+    for (size_t first = chunk_size; first < n; first += chunk_size)
+    {
+        futures.push_back(std::async(std::launch::async, f, first, std::min(n, first + chunk_size)));
+    }
+    f(0, chunk_size);
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].get();
+    }
+}
+
+// Reports the new buffer to an installed json_allocation_counter if v was 
+// reallocated, from a capacity of old_capacity
+template <class T>
+void count_growth(const std::vector<T>& v, size_t old_capacity)
+{
+    if (v.capacity() != old_capacity && v.capacity() != 0)
+    {
+        json_allocation_counter::add(v.capacity()*sizeof(T));
+    }
+}
+
+// Bytes a string holds on the heap, zero if it fits in the small string buffer
+template <typename Char>
+size_t heap_string_size(const std::basic_string<Char>& s)
+{
+    static const size_t small_capacity = std::basic_string<Char>().capacity();
+    return s.capacity() > small_capacity ? (s.capacity()+1)*sizeof(Char) : 0;
+}
 template <typename Char,class Alloc>
-class json_array_impl 
+class json_array_impl
 {
+    // An element of an array whose elements are all doubles, all long longs
+    // or all unsigned long longs
+    union number_value
+    {
+        double double_value_;
+        long long longlong_value_;
+        unsigned long long ulonglong_value_;
+    };
+
+    // Contiguous storage for such an array, 8 bytes per element
+    struct number_storage
+    {
+        number_storage(value_type::value_type_t type)
+            : type_(type)
+        {
+        }
+
+        value_type::value_type_t type_;
+        std::vector<number_value> values_;
+    };
+
+    // Progress of the conversion of the numbers to elements_ by a const access
+    enum expansion_state {not_expanded, expanding, expanded};
+
+    // Gives a const access the numbers if they are to be read instead of elements_,
+    // and keeps an expansion on another thread from releasing them meanwhile
+    class number_reader
+    {
+    public:
+        number_reader(const json_array_impl& a)
+            : a_(a), numbers_(nullptr), counted_(false)
+        {
+            if (a_.numbers_.load(std::memory_order_acquire) != nullptr)
+            {
+                counted_ = true;
+                a_.readers_.fetch_add(1);
+                if (a_.expansion_.load() != expanded)
+                {
+                    numbers_ = a_.numbers_.load();
+                }
+            }
+        }
+
+        ~number_reader()
+        {
+            if (counted_)
+            {
+                a_.end_read();
+            }
+        }
+
+        const number_storage* numbers() const
+        {
+            return numbers_;
+        }
+    private:
+        number_reader(const number_reader&); // noop
+        number_reader& operator=(const number_reader&); // noop
+
+        const json_array_impl& a_;
+        const number_storage* numbers_;
+        bool counted_;
+    };
+
+    static value_type::value_type_t number_type(double) {return value_type::double_t;}
+    static value_type::value_type_t number_type(long long) {return value_type::longlong_t;}
+    static value_type::value_type_t number_type(unsigned long long) {return value_type::ulonglong_t;}
+
+    static void set_number(number_value& n, double value) {n.double_value_ = value;}
+    static void set_number(number_value& n, long long value) {n.longlong_value_ = value;}
+    static void set_number(number_value& n, unsigned long long value) {n.ulonglong_value_ = value;}
 public:
     typedef typename std::vector<basic_json<Char,Alloc>>::iterator iterator;
     typedef typename std::vector<basic_json<Char,Alloc>>::const_iterator const_iterator;
 
     // Allocation
-    static void* operator new(std::size_t) { return typename Alloc::template rebind<json_array_impl>::other().allocate(1); }
+    static void* operator new(std::size_t)
+    {
+        json_allocation_counter::add(sizeof(json_array_impl));
+        return typename Alloc::template rebind<json_array_impl>::other().allocate(1);
+    }
     static void operator delete(void* ptr) { return typename Alloc::template rebind<json_array_impl>::other().deallocate(static_cast<json_array_impl*>(ptr), 1); }
 
     json_array_impl()
+        : numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
     }
 
     json_array_impl(size_t n)
-        : elements_(n)
+        : elements_(n), numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
+        count_growth(elements_, 0);
     }
 
     json_array_impl(size_t n, const basic_json<Char,Alloc>& val)
-        : elements_(n,val)
+        : elements_(n,val), numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
+        count_growth(elements_, 0);
     }
 
     json_array_impl(std::vector<basic_json<Char,Alloc>> elements)
-        : elements_(elements)
+        : elements_(elements), numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
+        count_growth(elements_, 0);
     }
 
     template <class InputIterator>
     json_array_impl(InputIterator begin, InputIterator end)
-        : elements_(begin,end)
+        : elements_(begin,end), numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
+        count_growth(elements_, 0);
     }
 
-    json_array_impl<Char,Alloc>* clone() 
+    json_array_impl(const json_array_impl<Char,Alloc>& val)
+        : numbers_(nullptr), expansion_(not_expanded), readers_(0)
     {
-        return new json_array_impl(elements_);
+        number_reader reader(val);
+        if (reader.numbers() != nullptr)
+        {
+            number_storage* numbers = new number_storage(*reader.numbers());
+            numbers_.store(numbers, std::memory_order_relaxed);
+            json_allocation_counter::add(sizeof(number_storage));
+            count_growth(numbers->values_, 0);
+        }
+        else
+        {
+            elements_ = val.elements_;
+            count_growth(elements_, 0);
+        }
     }
 
-    size_t size() const {return elements_.size();}
+    ~json_array_impl()
+    {
+        delete numbers_.load(std::memory_order_relaxed);
+    }
 
-    size_t capacity() const {return elements_.capacity();}
+    json_array_impl<Char,Alloc>* clone() const
+    {
+        return new json_array_impl(*this);
+    }
 
-    void clear() {elements_.clear();}
+    size_t size() const
+    {
+        number_reader reader(*this);
+        return reader.numbers() != nullptr ? reader.numbers()->values_.size() : elements_.size();
+    }
 
-    void reserve(size_t n) {elements_.reserve(n);}
+    size_t capacity() const
+    {
+        number_reader reader(*this);
+        return reader.numbers() != nullptr ? reader.numbers()->values_.capacity() : elements_.capacity();
+    }
 
-    void resize(size_t n) {elements_.resize(n);}
+    void clear()
+    {
+        release_numbers();
+        elements_.clear();
+    }
 
-    void resize(size_t n, const basic_json<Char,Alloc>& val) {elements_.resize(n,val);}
+    // Releases the unused capacity of this array, but not of its elements
+    void shrink_to_fit()
+    {
+        number_storage* numbers = numbers_.load(std::memory_order_relaxed);
+        if (numbers != nullptr)
+        {
+            size_t capacity = numbers->values_.capacity();
+            numbers->values_.shrink_to_fit();
+            count_growth(numbers->values_, capacity);
+        }
+        size_t capacity = elements_.capacity();
+        elements_.shrink_to_fit();
+        count_growth(elements_, capacity);
+    }
 
-    void remove_range(size_t from_index, size_t to_index) 
+    void compact(size_t max_threads)
+    {
+        shrink_to_fit();
+        const size_t n = elements_.size();
+        for_each_chunk(n, max_threads, [this,n,max_threads](size_t first, size_t last)
+        {
+            // When this array is too small to split, its elements may use the threads
+            size_t threads = last - first == n ? max_threads : 1;
+            for (size_t i = first; i < last; ++i)
+            {
+                elements_[i].parallel_compact(threads);
+            }
+        });
+    }
+
+    // Adds the bytes this array owns, and those of its elements, to usage
+    void memory_usage(json_memory_usage& usage) const
+    {
+        const size_t element_size = sizeof(basic_json<Char,Alloc>);
+        number_reader reader(*this);
+        const number_storage* numbers = reader.numbers();
+        usage.arrays += sizeof(json_array_impl);
+        if (numbers != nullptr)
+        {
+            usage.arrays += sizeof(number_storage) + numbers->values_.capacity()*sizeof(number_value);
+            usage.unused_capacity += (numbers->values_.capacity() - numbers->values_.size())*sizeof(number_value);
+            return;
+        }
+        usage.arrays += elements_.capacity()*element_size;
+        usage.unused_capacity += (elements_.capacity() - elements_.size())*element_size;
+        for (const auto& element : elements_)
+        {
+            element.memory_usage(usage);
+        }
+    }
+
+    // The last element, or nullptr if there is none, and removing it. These
+    // let a tree be destroyed without recursion, see basic_json::destroy_tree.
+    basic_json<Char,Alloc>* last_value()
+    {
+        return elements_.empty() ? nullptr : std::addressof(elements_.back());
+    }
+
+    void drop_last_value()
+    {
+        elements_.pop_back();
+    }
+
+    void reserve(size_t n)
+    {
+        number_storage* numbers = numbers_.load(std::memory_order_relaxed);
+        if (numbers != nullptr)
+        {
+            size_t capacity = numbers->values_.capacity();
+            numbers->values_.reserve(n);
+            count_growth(numbers->values_, capacity);
+        }
+        else
+        {
+            size_t capacity = elements_.capacity();
+            elements_.reserve(n);
+            count_growth(elements_, capacity);
+        }
+    }
+
+    void resize(size_t n)
+    {
+        to_elements();
+        size_t capacity = elements_.capacity();
+        elements_.resize(n);
+        count_growth(elements_, capacity);
+    }
+
+    void resize(size_t n, const basic_json<Char,Alloc>& val)
+    {
+        to_elements();
+        size_t capacity = elements_.capacity();
+        elements_.resize(n,val);
+        count_growth(elements_, capacity);
+    }
+
+    void remove_range(size_t from_index, size_t to_index)
     {
+        to_elements();
         JSONCONS_ASSERT(from_index <= to_index);
         JSONCONS_ASSERT(to_index <= elements_.size());
         elements_.erase(elements_.begin()+from_index,elements_.begin()+to_index);
     }
 
-    basic_json<Char,Alloc>& at(size_t i) {return elements_[i];}
+    basic_json<Char,Alloc>& at(size_t i)
+    {
+        to_elements();
+        return elements_[i];
+    }
 
-    const basic_json<Char,Alloc>& at(size_t i) const {return elements_[i];}
+    const basic_json<Char,Alloc>& at(size_t i) const
+    {
+        expand();
+        return elements_[i];
+    }
 
     void push_back(const basic_json<Char,Alloc>& value)
     {
+        to_elements();
+        size_t capacity = elements_.capacity();
         elements_.push_back(value);
+        count_growth(elements_, capacity);
     }
 
     void add(size_t index, const basic_json<Char,Alloc>& value)
     {
+        to_elements();
         json_array_impl<Char,Alloc>::iterator position = index < elements_.size() ? elements_.begin() + index : elements_.end();
+        size_t capacity = elements_.capacity();
         elements_.insert(position, value);
+        count_growth(elements_, capacity);
     }
 
     void push_back(basic_json<Char,Alloc>&& value)
     {
+        to_elements();
+        size_t capacity = elements_.capacity();
         elements_.push_back(value);
+        count_growth(elements_, capacity);
     }
 
     void add(size_t index, basic_json<Char,Alloc>&& value)
     {
+        to_elements();
         json_array_impl<Char,Alloc>::iterator position = index < elements_.size() ? elements_.begin() + index : elements_.end();
+        size_t capacity = elements_.capacity();
         elements_.insert(position, value);
+        count_growth(elements_, capacity);
+    }
+
+    // Switches an empty array to contiguous storage for numbers of type T
+    // (double, long long or unsigned long long) and reserves room for n of them
+    template <class T>
+    void reserve_numbers(size_t n)
+    {
+        JSONCONS_ASSERT(size() == 0);
+        release_numbers();
+        number_storage* numbers = new number_storage(number_type(T()));
+        numbers->values_.reserve(n);
+        numbers_.store(numbers, std::memory_order_relaxed);
+        json_allocation_counter::add(sizeof(number_storage));
+        count_growth(numbers->values_, 0);
+    }
+
+    // Appends a number, keeping contiguous storage as long as every element
+    // has the same numeric type
+    template <class T>
+    void push_back_number(T value)
+    {
+        number_storage* numbers = numbers_.load(std::memory_order_relaxed);
+        if (numbers != nullptr && numbers->type_ == number_type(value) && expansion_.load(std::memory_order_relaxed) == not_expanded)
+        {
+            size_t capacity = numbers->values_.capacity();
+            numbers->values_.push_back(number_value());
+            set_number(numbers->values_.back(), value);
+            count_growth(numbers->values_, capacity);
+        }
+        else
+        {
+            to_elements();
+            size_t capacity = elements_.capacity();
+            elements_.push_back(basic_json<Char,Alloc>(value));
+            count_growth(elements_, capacity);
+        }
     }
 
-    iterator begin() {return elements_.begin();}
+    bool has_contiguous_numbers() const
+    {
+        number_reader reader(*this);
+        return reader.numbers() != nullptr;
+    }
+
+    template <class T>
+    bool copy_numbers_to(std::vector<T>&) const
+    {
+        return false;
+    }
+
+    bool copy_numbers_to(std::vector<double>& v) const
+    {
+        return copy_numbers<double>(v);
+    }
+
+    bool copy_numbers_to(std::vector<long long>& v) const
+    {
+        return copy_numbers<long long>(v);
+    }
+
+    bool copy_numbers_to(std::vector<unsigned long long>& v) const
+    {
+        return copy_numbers<unsigned long long>(v);
+    }
+
+    // Sends the contiguous numbers to handler in one typed_array event,
+    // returns false if the array does not hold its numbers contiguously
+    template <class Handler>
+    bool numbers_to_stream(Handler& handler) const
+    {
+        number_reader reader(*this);
+        const number_storage* numbers = reader.numbers();
+        if (numbers == nullptr)
+        {
+            return false;
+        }
+        const number_value* p = numbers->values_.data();
+        const size_t n = numbers->values_.size();
+        switch (numbers->type_)
+        {
+        case value_type::double_t:
+            handler.typed_array(reinterpret_cast<const double*>(p), n);
+            break;
+        case value_type::longlong_t:
+            handler.typed_array(reinterpret_cast<const long long*>(p), n);
+            break;
+        default:
+            handler.typed_array(reinterpret_cast<const unsigned long long*>(p), n);
+            break;
+        }
+        return true;
+    }
+
+    iterator begin()
+    {
+        to_elements();
+        return elements_.begin();
+    }
 
-    iterator end() {return elements_.end();}
+    iterator end()
+    {
+        to_elements();
+        return elements_.end();
+    }
 
-    const_iterator begin() const {return elements_.begin();}
+    const_iterator begin() const
+    {
+        expand();
+        return elements_.begin();
+    }
 
-    const_iterator end() const {return elements_.end();}
+    const_iterator end() const
+    {
+        expand();
+        return elements_.end();
+    }
 
     bool operator==(const json_array_impl<Char,Alloc>& rhs) const
     {
-        if (size() != rhs.size())
+        return equals(rhs, 1);
+    }
+
+    // Compares contiguous numbers in place, without converting either array
+    bool equals(const json_array_impl<Char,Alloc>& rhs, size_t max_threads) const
+    {
+        const size_t n = size();
+        if (n != rhs.size())
         {
             return false;
         }
-        for (size_t i = 0; i < size(); ++i)
+        number_reader reader(*this);
+        number_reader rhs_reader(rhs);
+        const number_storage* numbers = reader.numbers();
+        const number_storage* rhs_numbers = rhs_reader.numbers();
+        if (numbers != nullptr && rhs_numbers != nullptr && numbers->type_ == rhs_numbers->type_)
+        {
+            return numbers_equal(*numbers, *rhs_numbers);
+        }
+        std::atomic<bool> equal(true);
+        for_each_chunk(n, max_threads,
+                       [&](size_t first, size_t last)
+                       {
+                           for (size_t i = first; i < last && equal.load(std::memory_order_relaxed); ++i)
+                           {
+                               if (!element_equals(numbers, i, rhs, rhs_numbers))
+                               {
+                                   equal.store(false, std::memory_order_relaxed);
+                               }
+                           }
+                       });
+        return equal.load();
+    }
+
+    // Order dependent structural hash. It is not cached, since an element can be
+    // changed through a reference without the array knowing.
+    size_t hash(size_t max_threads) const
+    {
+        number_reader reader(*this);
+        const number_storage* numbers = reader.numbers();
+        std::atomic<uint64_t> sum(0);
+        const size_t n = numbers != nullptr ? numbers->values_.size() : elements_.size();
+        for_each_chunk(n, max_threads,
+                       [&](size_t first, size_t last)
+                       {
+                           uint64_t partial = 0;
+                           for (size_t i = first; i < last; ++i)
+                           {
+                               partial += mix_hash(element_hash(numbers, i) + i * 0x9e3779b97f4a7c15ULL);
+                           }
+                           sum.fetch_add(partial, std::memory_order_relaxed);
+                       });
+        return static_cast<size_t>(mix_hash(0x61727261796a736fULL + sum.load() + n));
+    }
+private:
+    static basic_json<Char,Alloc> number_at(const number_storage& numbers, size_t i)
+    {
+        switch (numbers.type_)
+        {
+        case value_type::double_t:
+            return basic_json<Char,Alloc>(numbers.values_[i].double_value_);
+        case value_type::longlong_t:
+            return basic_json<Char,Alloc>(numbers.values_[i].longlong_value_);
+        default:
+            return basic_json<Char,Alloc>(numbers.values_[i].ulonglong_value_);
+        }
+    }
+
+    static bool numbers_equal(const number_storage& a, const number_storage& b)
+    {
+        const size_t n = a.values_.size();
+        for (size_t i = 0; i < n; ++i)
         {
-            if (elements_[i] != rhs.elements_[i])
+            bool equal;
+            switch (a.type_)
+            {
+            case value_type::double_t:
+                equal = a.values_[i].double_value_ == b.values_[i].double_value_;
+                break;
+            case value_type::longlong_t:
+                equal = a.values_[i].longlong_value_ == b.values_[i].longlong_value_;
+                break;
+            default:
+                equal = a.values_[i].ulonglong_value_ == b.values_[i].ulonglong_value_;
+                break;
+            }
+            if (!equal)
             {
                 return false;
             }
@@ -155,12 +614,134 @@ public:
         return true;
     }
 
-    json_array_impl(const json_array_impl<Char,Alloc>& val)
-        : elements_(val.elements_)
+    bool element_equals(const number_storage* numbers, size_t i,
+                        const json_array_impl<Char,Alloc>& rhs, const number_storage* rhs_numbers) const
     {
+        if (numbers != nullptr)
+        {
+            basic_json<Char,Alloc> value = number_at(*numbers, i);
+            return rhs_numbers != nullptr ? value == number_at(*rhs_numbers, i) : value == rhs.elements_[i];
+        }
+        return rhs_numbers != nullptr ? elements_[i] == number_at(*rhs_numbers, i) : elements_[i] == rhs.elements_[i];
     }
-private:
-    std::vector<basic_json<Char,Alloc>> elements_;
+
+    size_t element_hash(const number_storage* numbers, size_t i) const
+    {
+        if (numbers == nullptr)
+        {
+            return elements_[i].hash();
+        }
+        switch (numbers->type_)
+        {
+        case value_type::double_t:
+            return hash_number(numbers->values_[i].double_value_);
+        case value_type::longlong_t:
+            return hash_number(static_cast<double>(numbers->values_[i].longlong_value_));
+        default:
+            return hash_number(static_cast<double>(numbers->values_[i].ulonglong_value_));
+        }
+    }
+
+    template <class T>
+    bool copy_numbers(std::vector<T>& v) const
+    {
+        number_reader reader(*this);
+        const number_storage* numbers = reader.numbers();
+        if (numbers == nullptr)
+        {
+            return false;
+        }
+        const size_t n = numbers->values_.size();
+        v.resize(n);
+        if (numbers->type_ == number_type(T()))
+        {
+            if (n > 0)
+            {
+                std::memcpy(v.data(), numbers->values_.data(), n*sizeof(T));
+            }
+            return true;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            switch (numbers->type_)
+            {
+            case value_type::double_t:
+                v[i] = static_cast<T>(numbers->values_[i].double_value_);
+                break;
+            case value_type::longlong_t:
+                v[i] = static_cast<T>(numbers->values_[i].longlong_value_);
+                break;
+            default:
+                v[i] = static_cast<T>(numbers->values_[i].ulonglong_value_);
+                break;
+            }
+        }
+        return true;
+    }
+
+    // Builds elements_ from the contiguous numbers on the first const access that
+    // needs them, then releases the numbers once no const access is reading them
+    void expand() const
+    {
+        const number_storage* numbers = numbers_.load(std::memory_order_acquire);
+        if (numbers == nullptr)
+        {
+            return;
+        }
+        int state = not_expanded;
+        if (expansion_.compare_exchange_strong(state, expanding))
+        {
+            elements_.clear();
+            size_t capacity = elements_.capacity();
+            elements_.reserve(numbers->values_.size());
+            count_growth(elements_, capacity);
+            for (size_t i = 0; i < numbers->values_.size(); ++i)
+            {
+                elements_.push_back(number_at(*numbers, i));
+            }
+            expansion_.store(expanded);
+            if (readers_.load() == 0)
+            {
+                delete numbers_.exchange(nullptr);
+            }
+            return;
+        }
+        while (expansion_.load(std::memory_order_acquire) != expanded)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Called as a number_reader goes, the last reader after an expansion releases the numbers
+    void end_read() const
+    {
+        if (readers_.fetch_sub(1) == 1 && expansion_.load() == expanded)
+        {
+            delete numbers_.exchange(nullptr);
+        }
+    }
+
+    // Converts to general element storage before a mutable access
+    void to_elements()
+    {
+        if (numbers_.load(std::memory_order_relaxed) != nullptr)
+        {
+            expand();
+            release_numbers();
+        }
+    }
+
+    void release_numbers()
+    {
+        delete numbers_.exchange(nullptr, std::memory_order_relaxed);
+        expansion_.store(not_expanded, std::memory_order_relaxed);
+    }
+
+    mutable std::vector<basic_json<Char,Alloc>> elements_;
+    mutable std::atomic<number_storage*> numbers_;
+    mutable std::atomic<int> expansion_;
+    mutable std::atomic<unsigned> readers_;
+
     json_array_impl& operator=(const json_array_impl<Char,Alloc>&);
 };
 
@@ -299,39 +880,185 @@ public:
     typedef object_iterator<Char,Alloc,false> iterator;
     typedef object_iterator<Char,Alloc,true> const_iterator;
 	typedef std::pair<std::basic_string<Char>,basic_json<Char,Alloc>> member_type;
+private:
+    // Open addressing table from the hashes of the member names to their
+    // positions, for lookups with a key that miss its hint
+    class member_index
+    {
+        struct slot
+        {
+            uint32_t hash_;
+            // Position plus one, zero for an empty slot
+            uint32_t position_;
+        };
+    public:
+        member_index(const std::vector<member_type>& members)
+        {
+            size_t capacity = 16;
+            while (capacity < 2*members.size())
+            {
+                capacity *= 2;
+            }
+            slots_.resize(capacity);
+            count_growth(slots_, 0);
+            mask_ = capacity - 1;
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                size_t h = basic_json<Char,Alloc>::key::hash_value(members[i].first.data(),members[i].first.length());
+                size_t j = h & mask_;
+                while (slots_[j].position_ != 0)
+                {
+                    j = (j + 1) & mask_;
+                }
+                slots_[j].hash_ = static_cast<uint32_t>(h);
+                slots_[j].position_ = static_cast<uint32_t>(i + 1);
+            }
+        }
+
+        // The position of the member named k, or the size of members if there is none
+        size_t find(const typename basic_json<Char,Alloc>::key& k, const std::vector<member_type>& members) const
+        {
+            const uint32_t h = static_cast<uint32_t>(k.hash());
+            for (size_t j = k.hash() & mask_; slots_[j].position_ != 0; j = (j + 1) & mask_)
+            {
+                if (slots_[j].hash_ == h)
+                {
+                    const std::basic_string<Char>& name = members[slots_[j].position_ - 1].first;
+                    if (k.equals(name.data(),name.length()))
+                    {
+                        return slots_[j].position_ - 1;
+                    }
+                }
+            }
+            return members.size();
+        }
+
+        size_t memory_usage() const
+        {
+            return sizeof(member_index) + slots_.capacity()*sizeof(slot);
+        }
+    private:
+        std::vector<slot> slots_;
+        size_t mask_;
+    };
+
+    // Smaller objects are searched with lower_bound
+    static const size_t min_indexed_size = 8;
+    // Key lookups that miss their hint before an object builds its index
+    static const unsigned lookups_before_index = 2;
+public:
     typedef typename std::vector<member_type>::iterator internal_iterator;
     typedef typename std::vector<member_type>::const_iterator const_internal_iterator;
 
     // Allocation
-    static void* operator new(std::size_t) { return typename Alloc::template rebind<json_object_impl>::other().allocate(1); }
+    static void* operator new(std::size_t) 
+    { 
+        json_allocation_counter::add(sizeof(json_object_impl));
+        return typename Alloc::template rebind<json_object_impl>::other().allocate(1); 
+    }
     static void operator delete(void* ptr) { return typename Alloc::template rebind<json_object_impl>::other().deallocate(static_cast<json_object_impl*>(ptr), 1); }
 
     json_object_impl()
+        : index_(nullptr), index_lookups_(0)
+    {
+    }
+
+    ~json_object_impl()
     {
+        delete index_.load(std::memory_order_relaxed);
     }
 
     json_object_impl(size_t n)
-        : members_(n)
+        : members_(n), index_(nullptr), index_lookups_(0)
     {
+        count_growth(members_, 0);
     }
 
     json_object_impl(std::vector<member_type> members)
-        : members_(members)
+        : members_(members), index_(nullptr), index_lookups_(0)
     {
+        count_members();
     }
 
     json_object_impl<Char,Alloc>* clone() 
     {
-        return new json_object_impl(members_);
+        return new json_object_impl(*this);
     }
 
     size_t size() const {return members_.size();}
 
     size_t capacity() const {return members_.capacity();}
 
-    void clear() {members_.clear();}
+    void clear() 
+    {
+        invalidate_index();
+        members_.clear();
+    }
 
-    void reserve(size_t n) {members_.reserve(n);}
+    void shrink_to_fit()
+    {
+        size_t capacity = members_.capacity();
+        members_.shrink_to_fit();
+        count_growth(members_, capacity);
+        for (auto& member : members_)
+        {
+            size_t key_capacity = member.first.capacity();
+            member.first.shrink_to_fit();
+            if (member.first.capacity() != key_capacity)
+            {
+                count_key(member.first);
+            }
+        }
+    }
+
+    void compact(size_t max_threads)
+    {
+        shrink_to_fit();
+        const size_t n = members_.size();
+        for_each_chunk(n, max_threads, [this,n,max_threads](size_t first, size_t last)
+        {
+            size_t threads = last - first == n ? max_threads : 1;
+            for (size_t i = first; i < last; ++i)
+            {
+                members_[i].second.parallel_compact(threads);
+            }
+        });
+    }
+
+    void memory_usage(json_memory_usage& usage) const
+    {
+        usage.objects += sizeof(json_object_impl) + members_.capacity()*sizeof(member_type);
+        const member_index* index = index_.load(std::memory_order_acquire);
+        if (index != nullptr)
+        {
+            usage.objects += index->memory_usage();
+        }
+        usage.unused_capacity += (members_.capacity() - members_.size())*sizeof(member_type);
+        for (const auto& member : members_)
+        {
+            usage.keys += heap_string_size(member.first);
+            member.second.memory_usage(usage);
+        }
+    }
+
+    // The value of the last member, or nullptr if there is none, and removing
+    // it. Only for destroying a tree, so the index is left as it is.
+    basic_json<Char,Alloc>* last_value()
+    {
+        return members_.empty() ? nullptr : std::addressof(members_.back().second);
+    }
+
+    void drop_last_value()
+    {
+        members_.pop_back();
+    }
+
+    void reserve(size_t n) 
+    {
+        size_t capacity = members_.capacity();
+        members_.reserve(n);
+        count_growth(members_, capacity);
+    }
 
     iterator find(const std::basic_string<Char>& name)
     {
@@ -347,8 +1074,14 @@ public:
         return (it != members_.end() && it->name() == name) ? const_iterator(it) : end();
     }
 
+    iterator find(const typename basic_json<Char,Alloc>::key& k)
+    {
+        return iterator(members_.begin() + find_index(k));
+    }
+
     void remove_range(size_t from_index, size_t to_index) 
     {
+        invalidate_index();
         JSONCONS_ASSERT(from_index <= to_index);
         JSONCONS_ASSERT(to_index <= members_.size());
         members_.erase(members_.begin()+from_index,members_.begin()+to_index);
@@ -356,22 +1089,98 @@ public:
 
     void remove(const std::basic_string<Char>& name) 
     {
+        invalidate_index();
         key_compare<Char,Alloc> comp;
         auto it = std::lower_bound(members_.begin(),members_.end(), name, comp);
-        if (it != members_.end())
+        if (it != members_.end() && it->first == name)
         {
             members_.erase(it);
         }
     }
 
-    const typename basic_json<Char,Alloc>::member_type& get(size_t i) const 
+    // Removes the members with the names, which are sorted and distinct, in one pass
+    void remove_sorted(const std::vector<std::basic_string<Char>>& names)
+    {
+        invalidate_index();
+        size_t j = 0;
+        size_t k = 0;
+        for (size_t i = 0; i < members_.size(); ++i)
+        {
+            while (j < names.size() && names[j] < members_[i].first)
+            {
+                ++j;
+            }
+            if (j < names.size() && names[j] == members_[i].first)
+            {
+                ++j;
+                continue;
+            }
+            if (k != i)
+            {
+                members_[k].first.swap(members_[i].first);
+                members_[k].second.swap(members_[i].second);
+            }
+            ++k;
+        }
+        members_.erase(members_.begin() + k, members_.end());
+    }
+
+    // Sets the members, which are sorted by name and distinct, moving their
+    // values in. Existing members are replaced in place, and the new ones are
+    // appended and merged in once, rather than inserted one at a time.
+    void set_sorted(std::vector<member_type>& members)
+    {
+        const size_t n = members_.size();
+        size_t first = 0;
+        size_t added = 0;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            auto it = std::lower_bound(members_.begin() + first, members_.begin() + n, members[i].first, key_compare<Char,Alloc>());
+            first = it - members_.begin();
+            if (first < n && members_[first].first == members[i].first)
+            {
+                members_[first].second.swap(members[i].second);
+            }
+            else
+            {
+                if (added != i)
+                {
+                    members[added].first.swap(members[i].first);
+                    members[added].second.swap(members[i].second);
+                }
+                ++added;
+            }
+        }
+        if (added == 0)
+        {
+            return;
+        }
+        invalidate_index();
+        size_t capacity = members_.capacity();
+        members_.reserve(n + added);
+        count_growth(members_, capacity);
+        for (size_t i = 0; i < added; ++i)
+        {
+            members_.push_back(member_type());
+            members_.back().first.swap(members[i].first);
+            members_.back().second.swap(members[i].second);
+            count_key(members_.back().first);
+        }
+        std::inplace_merge(members_.begin(), members_.begin() + n, members_.end(), member_compare<Char,Alloc>());
+    }
+
+    const member_type& get(size_t i) const 
     {
         return members_[i];
     }
 
     void push_back(const std::basic_string<Char>& name, const basic_json<Char,Alloc>& val)
     {
+        invalidate_index();
+        size_t capacity = members_.capacity();
         members_.push_back(typename basic_json<Char,Alloc>::member_type(name,val));
+        count_growth(members_, capacity);
+        count_key(members_.back().first);
     }
 
     void set(const std::basic_string<Char>& name, const basic_json<Char,Alloc>& value)
@@ -383,27 +1192,41 @@ public:
         }
         else
         {
-            members_.insert(it,member_type(name,value));
+            invalidate_index();
+            size_t capacity = members_.capacity();
+            it = members_.insert(it,member_type(name,value));
+            count_growth(members_, capacity);
+            count_key(it->first);
         }
     }
 
     void set(std::basic_string<Char>&& name, basic_json<Char,Alloc>&& value)
     {
-        auto it = std::lower_bound(begin(),end(),name ,key_compare<Char,Alloc>());
-        if (it != end() && it->name() == name)
+        auto it = std::lower_bound(members_.begin(),members_.end(),name ,key_compare<Char,Alloc>());
+        if (it != members_.end() && it->first == name)
         {
-            *it = member_type(name,value);
+            it->second.swap(value);
         }
         else
         {
-            insert(it,member_type(name,value));
+            invalidate_index();
+            size_t capacity = members_.capacity();
+            it = members_.insert(it,member_type());
+            count_growth(members_, capacity);
+            it->first.swap(name);
+            count_key(it->first);
+            it->second.swap(value);
         }
     }
 
     void push_back(std::basic_string<Char>&& name, basic_json<Char,Alloc>&& val)
     {
+        invalidate_index();
+        size_t capacity = members_.capacity();
         members_.push_back(member_type());
+        count_growth(members_, capacity);
         members_.back().first.swap(name);
+        count_key(members_.back().first);
         members_.back().second.swap(val);
         //members_.push_back(typename basic_json<Char,Alloc>::member_type(name,val)); // much slower on VS 2010
     }
@@ -428,46 +1251,203 @@ public:
         return it->second;
     }
 
+    basic_json<Char,Alloc>& get(const typename basic_json<Char,Alloc>::key& k) 
+    {
+        size_t i = find_index(k);
+        if (i == members_.size())
+        {
+            JSONCONS_THROW_EXCEPTION_1("Member %s not found.",k.name());
+        }
+        return members_[i].second;
+    }
+
+    const basic_json<Char,Alloc>& get(const typename basic_json<Char,Alloc>::key& k) const
+    {
+        size_t i = find_index(k);
+        if (i == members_.size())
+        {
+            JSONCONS_THROW_EXCEPTION_1("Member %s not found.",k.name());
+        }
+        return members_[i].second;
+    }
+
+    // The value of the member with key k, or null if there is none
+    basic_json<Char,Alloc>* find_value(const typename basic_json<Char,Alloc>::key& k) 
+    {
+        size_t i = find_index(k);
+        return i < members_.size() ? std::addressof(members_[i].second) : nullptr;
+    }
+
+    const basic_json<Char,Alloc>* find_value(const typename basic_json<Char,Alloc>::key& k) const
+    {
+        size_t i = find_index(k);
+        return i < members_.size() ? std::addressof(members_[i].second) : nullptr;
+    }
+
 	void sort_members()
 	{
+        invalidate_index();
 		std::sort(members_.begin(),members_.end(),member_compare<Char,Alloc>());
 	}
 
-    iterator begin() {return iterator(members_.begin());}
+    iterator begin() 
+    {
+        return iterator(members_.begin());
+    }
 
-    iterator end() {return iterator(members_.end());}
+    iterator end() 
+    {
+        return iterator(members_.end());
+    }
 
     const_iterator begin() const {return const_iterator(members_.begin());}
 
     const_iterator end() const {return const_iterator(members_.end());}
 
     bool operator==(const json_object_impl<Char,Alloc>& rhs) const
+    {
+        return equals(rhs, 1);
+    }
+
+    // Both sides keep their members sorted by name, so members are compared pairwise
+    bool equals(const json_object_impl<Char,Alloc>& rhs, size_t max_threads) const
     {
         if (size() != rhs.size())
         {
             return false;
         }
-        for (auto it = members_.begin(); it != members_.end(); ++it)
+        std::atomic<bool> equal(true);
+        for_each_chunk(members_.size(), max_threads, 
+                       [&](size_t first, size_t last)
+                       {
+                           for (size_t i = first; i < last && equal.load(std::memory_order_relaxed); ++i)
+                           {
+                               if (members_[i].first != rhs.members_[i].first || members_[i].second != rhs.members_[i].second)
+                               {
+                                   equal.store(false, std::memory_order_relaxed);
+                               }
+                           }
+                       });
+        return equal.load();
+    }
+
+    // Order independent structural hash, recomputed on each call like the array's
+    size_t hash(size_t max_threads) const
+    {
+        std::atomic<uint64_t> sum(0);
+        for_each_chunk(members_.size(), max_threads, 
+                       [&](size_t first, size_t last)
+                       {
+                           uint64_t partial = 0;
+                           for (size_t i = first; i < last; ++i)
+                           {
+                               const std::basic_string<Char>& name = members_[i].first;
+                               uint64_t name_hash = basic_json<Char,Alloc>::key::hash_value(name.data(),name.length());
+                               partial += mix_hash(name_hash * 31 + members_[i].second.hash());
+                           }
+                           sum.fetch_add(partial, std::memory_order_relaxed);
+                       });
+        return hash_members(sum.load(), members_.size());
+    }
+
+    static size_t empty_hash()
+    {
+        return hash_members(0, 0);
+    }
+
+    json_object_impl(const json_object_impl<Char,Alloc>& val)
+        : members_(val.members_), index_(nullptr), index_lookups_(0)
+    {
+        count_members();
+    }
+
+private:
+    static size_t hash_members(uint64_t sum, size_t count)
+    {
+        return static_cast<size_t>(mix_hash(0x6f626a6563746a73ULL + sum + count));
+    }
+
+    // Reports a members vector built in one step, and its long names
+    void count_members() const
+    {
+        if (json_allocation_counter::enabled())
         {
+            count_growth(members_, 0);
+            for (const auto& member : members_)
+            {
+                count_key(member.first);
+            }
+        }
+    }
 
-            auto rhs_it = std::lower_bound(rhs.members_.begin(), rhs.members_.end(), *it, member_compare<Char, Alloc>());
-            // member_compare actually only compares keys, so we need to check the value separately
-            if (rhs_it == rhs.members_.end() || rhs_it->second != it->second)
+    static void count_key(const std::basic_string<Char>& name)
+    {
+        if (json_allocation_counter::enabled())
+        {
+            size_t size = heap_string_size(name);
+            if (size > 0)
             {
-                return false;
+                json_allocation_counter::add(size);
             }
         }
-        return true;
     }
 
-    json_object_impl(const json_object_impl<Char,Alloc>& val)
-        : members_(val.members_)
+    // Tries the position of the key's last match, then the index of member name
+    // hashes if the object has one, otherwise a binary search
+    size_t find_index(const typename basic_json<Char,Alloc>::key& k) const
     {
+        const size_t n = members_.size();
+        size_t i = k.hint();
+        if (i < n && k.equals(members_[i].first.data(),members_[i].first.length()))
+        {
+            return i;
+        }
+        const member_index* index = index_.load(std::memory_order_acquire);
+        if (index == nullptr && n >= min_indexed_size && n < 0xffffffff &&
+            index_lookups_.fetch_add(1, std::memory_order_relaxed) >= lookups_before_index)
+        {
+            index = build_index();
+        }
+        if (index != nullptr)
+        {
+            i = index->find(k, members_);
+        }
+        else
+        {
+            auto it = std::lower_bound(members_.begin(),members_.end(), k.name(), key_compare<Char,Alloc>());
+            i = it != members_.end() && k.equals(it->first.data(),it->first.length()) ? it - members_.begin() : n;
+        }
+        if (i < n)
+        {
+            k.hint(i);
+        }
+        return i;
     }
 
-private:
+    // Const lookups on several threads may build the index at once, the first to publish it wins
+    const member_index* build_index() const
+    {
+        member_index* index = new member_index(members_);
+        json_allocation_counter::add(sizeof(member_index));
+        member_index* expected = nullptr;
+        if (!index_.compare_exchange_strong(expected, index))
+        {
+            delete index;
+            return expected;
+        }
+        return index;
+    }
+
+    // Called when the names or positions of the members change
+    void invalidate_index()
+    {
+        delete index_.exchange(nullptr, std::memory_order_relaxed);
+        index_lookups_.store(0, std::memory_order_relaxed);
+    }
 
     std::vector<member_type> members_;
+    mutable std::atomic<member_index*> index_;
+    mutable std::atomic<unsigned> index_lookups_;
     json_object_impl<Char,Alloc>& operator=(const json_object_impl<Char,Alloc>&);
 };
 
@@ -0,0 +1,500 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_THREADED_FILTER_HPP
+#define JSONCONS_JSON_THREADED_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <cstring>
+#include <algorithm>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json_output_handler.hpp"
+#include "jsoncons/json_filter.hpp"
+
+namespace jsoncons {
+
+// Single producer, single consumer ring of bytes. Each side keeps a private
+// position and publishes it with one atomic store, after a whole record or
+// before it waits, and rereads the other side's position only when it runs out.
+class spsc_byte_ring
+{
+public:
+    explicit spsc_byte_ring(size_t capacity)
+        : data_(round_up(capacity)), mask_(data_.size() - 1), abandoned_(false),
+          head_(0), tail_(0),
+          write_pos_(0), cached_head_(0), read_pos_(0), cached_tail_(0)
+    {
+    }
+
+    // Producer side
+
+    // Returns false if the consumer has abandoned the ring
+    bool write(const void* p, size_t length)
+    {
+        const char* s = static_cast<const char*>(p);
+        while (length > 0)
+        {
+            size_t space = data_.size() - (write_pos_ - cached_head_);
+            if (space == 0)
+            {
+                tail_.store(write_pos_, std::memory_order_release);
+                size_t spins = 0;
+                while ((space = data_.size() - (write_pos_ - (cached_head_ = head_.load(std::memory_order_acquire)))) == 0)
+                {
+                    if (abandoned_.load(std::memory_order_acquire))
+                    {
+                        return false;
+                    }
+                    backoff(spins);
+                }
+            }
+            size_t offset = write_pos_ & mask_;
+            size_t n = (std::min)((std::min)(length, space), data_.size() - offset);
+            std::memcpy(&data_[offset], s, n);
+            write_pos_ += n;
+            s += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    void publish()
+    {
+        tail_.store(write_pos_, std::memory_order_release);
+    }
+
+    // Consumer side
+
+    void read(void* p, size_t length)
+    {
+        char* d = static_cast<char*>(p);
+        while (length > 0)
+        {
+            size_t available = cached_tail_ - read_pos_;
+            if (available == 0)
+            {
+                head_.store(read_pos_, std::memory_order_release);
+                size_t spins = 0;
+                while ((available = (cached_tail_ = tail_.load(std::memory_order_acquire)) - read_pos_) == 0)
+                {
+                    backoff(spins);
+                }
+            }
+            size_t offset = read_pos_ & mask_;
+            size_t n = (std::min)((std::min)(length, available), data_.size() - offset);
+            std::memcpy(d, &data_[offset], n);
+            read_pos_ += n;
+            d += n;
+            length -= n;
+        }
+    }
+
+    void release()
+    {
+        head_.store(read_pos_, std::memory_order_release);
+    }
+
+    // Tells the producer that nothing more will be read
+    void abandon()
+    {
+        abandoned_.store(true, std::memory_order_release);
+    }
+
+private:
+    spsc_byte_ring(const spsc_byte_ring&); // noop
+    spsc_byte_ring& operator=(const spsc_byte_ring&); // noop
+
+    static size_t round_up(size_t capacity)
+    {
+        size_t n = 64;
+        while (n < capacity)
+        {
+            n *= 2;
+        }
+        return n;
+    }
+
+    // Spins briefly, then yields, then sleeps, so that an idle side does not hold a core
+    static void backoff(size_t& spins)
+    {
+        ++spins;
+        if (spins > 1024)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        else if (spins > 64)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::vector<char> data_;
+    size_t mask_;
+    std::atomic<bool> abandoned_;
+    // The padding keeps the two published positions, and each side's private
+    // positions, on cache lines of their own, so that a store by one side does
+    // not invalidate a line the other side is using
+    char pad0_[64];
+    std::atomic<size_t> head_;
+    char pad1_[64];
+    std::atomic<size_t> tail_;
+    char pad2_[64];
+    size_t write_pos_;
+    size_t cached_head_;
+    char pad3_[64];
+    size_t read_pos_;
+    size_t cached_tail_;
+    char pad4_[64];
+};
+
+// Passes the events it receives to a consumer thread through a spsc_byte_ring,
+// and the consumer thread replays them into the downstream handler, so that
+// parsing and handling run on separate cores. Call finish() before using the
+// results of the downstream handler.
+template <typename Char>
+class basic_json_threaded_filter : public basic_json_input_handler<Char>
+{
+    enum event_type : uint8_t
+    {
+        begin_json_event, end_json_event, begin_object_event, end_object_event,
+        begin_array_event, end_array_event, name_event, string_event, binary_event,
+        number_event, double_event, longlong_event, ulonglong_event,
+        true_event, false_event, null_event, stop_event
+    };
+
+    // Position and capacity hint of the event being replayed
+    class replay_context : public basic_parsing_context<Char>
+    {
+    public:
+        replay_context()
+            : line_(0), column_(0), minimum_structure_capacity_(0)
+        {
+        }
+
+        uint32_t line_;
+        uint32_t column_;
+        size_t minimum_structure_capacity_;
+    private:
+        virtual unsigned long do_line_number() const
+        {
+            return line_;
+        }
+        virtual unsigned long do_column_number() const
+        {
+            return column_;
+        }
+        virtual bool do_eof() const
+        {
+            return false;
+        }
+        virtual size_t do_minimum_structure_capacity() const
+        {
+            return minimum_structure_capacity_;
+        }
+        virtual Char do_last_char() const
+        {
+            return 0;
+        }
+    };
+public:
+    static const size_t default_capacity = 1 << 20;
+
+    basic_json_threaded_filter(basic_json_input_handler<Char>& handler, size_t capacity = default_capacity)
+        : handler_(std::addressof(handler)), ring_(capacity), failed_(false), finished_(false)
+    {
+        consumer_ = std::thread(&basic_json_threaded_filter::consume, this);
+    }
+
+    basic_json_threaded_filter(basic_json_output_handler<Char>& handler, size_t capacity = default_capacity)
+        : input_output_adapter_(handler), handler_(std::addressof(input_output_adapter_)), ring_(capacity),
+          failed_(false), finished_(false)
+    {
+        consumer_ = std::thread(&basic_json_threaded_filter::consume, this);
+    }
+
+    ~basic_json_threaded_filter()
+    {
+        try
+        {
+            finish();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // Waits until the downstream handler has received every event, and rethrows
+    // any exception the downstream handler threw
+    void finish()
+    {
+        if (!finished_)
+        {
+            finished_ = true;
+            write_event(stop_event, 0, 0);
+            ring_.publish();
+            consumer_.join();
+        }
+        if (failed_)
+        {
+            failed_ = false;
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    basic_json_threaded_filter(const basic_json_threaded_filter&); // noop
+    basic_json_threaded_filter& operator=(const basic_json_threaded_filter&); // noop
+
+    // Producer
+
+    void write_event(event_type type, const basic_parsing_context<Char>& context)
+    {
+        write_event(type, static_cast<uint32_t>(context.line_number()), static_cast<uint32_t>(context.column_number()));
+    }
+
+    void write_event(event_type type, uint32_t line, uint32_t column)
+    {
+        char header[9];
+        header[0] = static_cast<char>(type);
+        std::memcpy(header + 1, &line, 4);
+        std::memcpy(header + 5, &column, 4);
+        write(header, sizeof(header));
+    }
+
+    template <class T>
+    void write_value(event_type type, T value, const basic_parsing_context<Char>& context)
+    {
+        write_event(type, context);
+        write(&value, sizeof(T));
+        ring_.publish();
+    }
+
+    void write_text(event_type type, const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        write_event(type, context);
+        write(&length, sizeof(length));
+        write(p, length*sizeof(Char));
+        ring_.publish();
+    }
+
+    void write(const void* p, size_t length)
+    {
+        if (!ring_.write(p, length))
+        {
+            // The consumer stopped on an exception from the downstream handler
+            finished_ = true;
+            consumer_.join();
+            failed_ = false;
+            std::rethrow_exception(error_);
+        }
+    }
+
+    virtual void do_begin_json()
+    {
+        write_event(begin_json_event, 0, 0);
+        ring_.publish();
+    }
+
+    virtual void do_end_json()
+    {
+        write_event(end_json_event, 0, 0);
+        ring_.publish();
+    }
+
+    virtual void do_begin_object(const basic_parsing_context<Char>& context)
+    {
+        write_value(begin_object_event, context.minimum_structure_capacity(), context);
+    }
+
+    virtual void do_end_object(const basic_parsing_context<Char>& context)
+    {
+        write_event(end_object_event, context);
+        ring_.publish();
+    }
+
+    virtual void do_begin_array(const basic_parsing_context<Char>& context)
+    {
+        write_value(begin_array_event, context.minimum_structure_capacity(), context);
+    }
+
+    virtual void do_end_array(const basic_parsing_context<Char>& context)
+    {
+        write_event(end_array_event, context);
+        ring_.publish();
+    }
+
+    virtual void do_name(const Char* name, size_t length, const basic_parsing_context<Char>& context)
+    {
+        write_text(name_event, name, length, context);
+    }
+
+    virtual void do_string_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        write_text(string_event, value, length, context);
+    }
+
+    virtual void do_binary_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        write_text(binary_event, value, length, context);
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        write_text(number_event, p, length, context);
+    }
+
+    virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+    {
+        write_value(double_event, value, context);
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+    {
+        write_value(longlong_event, value, context);
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context)
+    {
+        write_value(ulonglong_event, value, context);
+    }
+
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+    {
+        write_event(value ? true_event : false_event, context);
+        ring_.publish();
+    }
+
+    virtual void do_null_value(const basic_parsing_context<Char>& context)
+    {
+        write_event(null_event, context);
+        ring_.publish();
+    }
+
+    // Consumer
+
+    template <class T>
+    T read_value()
+    {
+        T value;
+        ring_.read(&value, sizeof(T));
+        return value;
+    }
+
+    void read_text()
+    {
+        size_t length = read_value<size_t>();
+        text_.resize(length);
+        if (length > 0)
+        {
+            ring_.read(&text_[0], length*sizeof(Char));
+        }
+    }
+
+    void consume()
+    {
+        replay_context context;
+        try
+        {
+            for (;;)
+            {
+                char header[9];
+                ring_.read(header, sizeof(header));
+                std::memcpy(&context.line_, header + 1, 4);
+                std::memcpy(&context.column_, header + 5, 4);
+                switch (static_cast<event_type>(header[0]))
+                {
+                case begin_json_event:
+                    handler_->begin_json();
+                    break;
+                case end_json_event:
+                    handler_->end_json();
+                    break;
+                case begin_object_event:
+                    context.minimum_structure_capacity_ = read_value<size_t>();
+                    handler_->begin_object(context);
+                    break;
+                case end_object_event:
+                    handler_->end_object(context);
+                    break;
+                case begin_array_event:
+                    context.minimum_structure_capacity_ = read_value<size_t>();
+                    handler_->begin_array(context);
+                    break;
+                case end_array_event:
+                    handler_->end_array(context);
+                    break;
+                case name_event:
+                    read_text();
+                    handler_->name(text_.data(), text_.length(), context);
+                    break;
+                case string_event:
+                    read_text();
+                    handler_->value(text_.data(), text_.length(), context);
+                    break;
+                case binary_event:
+                    read_text();
+                    handler_->binary(text_.data(), text_.length(), context);
+                    break;
+                case number_event:
+                    read_text();
+                    handler_->number(text_.data(), text_.length(), context);
+                    break;
+                case double_event:
+                    handler_->value(read_value<double>(), context);
+                    break;
+                case longlong_event:
+                    handler_->value(read_value<long long>(), context);
+                    break;
+                case ulonglong_event:
+                    handler_->value(read_value<unsigned long long>(), context);
+                    break;
+                case true_event:
+                    handler_->value(true, context);
+                    break;
+                case false_event:
+                    handler_->value(false, context);
+                    break;
+                case null_event:
+                    handler_->value(null_type(), context);
+                    break;
+                case stop_event:
+                    ring_.release();
+                    return;
+                }
+                ring_.release();
+            }
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+            failed_ = true;
+            ring_.abandon();
+        }
+    }
+
+    basic_json_input_output_adapter<Char> input_output_adapter_;
+    basic_json_input_handler<Char>* handler_;
+    spsc_byte_ring ring_;
+    std::basic_string<Char> text_;
+    std::thread consumer_;
+    std::exception_ptr error_;
+    bool failed_;
+    bool finished_;
+};
+
+typedef basic_json_threaded_filter<char> json_threaded_filter;
+typedef basic_json_threaded_filter<wchar_t> wjson_threaded_filter;
+
+}
+
+#endif
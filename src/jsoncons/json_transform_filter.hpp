@@ -0,0 +1,436 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_JSON_TRANSFORM_FILTER_HPP
+#define JSONCONS_JSON_TRANSFORM_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json_output_handler.hpp"
+#include "jsoncons/json_filter.hpp"
+#include "jsoncons/json_pointer_tokens.hpp"
+
+namespace jsoncons {
+
+template <typename Char>
+class basic_json_transform_filter;
+
+// A table of rules for basic_json_transform_filter. Paths are JSON Pointers, in
+// which a "*" segment stands for any array element, or any member name that
+// has no rule of its own. The rules are kept as a tree with one node per path
+// prefix, each with a hash map from member name to child node.
+template <typename Char>
+class basic_json_transform_rules
+{
+    friend class basic_json_transform_filter<Char>;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct node
+    {
+        node()
+            : any_(npos), rename_(false), drop_(false), to_number_(false), flatten_(false)
+        {
+        }
+
+        std::unordered_map<std::basic_string<Char>,size_t> children_;
+        size_t any_;
+        bool rename_;
+        bool drop_;
+        bool to_number_;
+        bool flatten_;
+        std::basic_string<Char> new_name_;
+        std::basic_string<Char> separator_;
+        std::vector<std::pair<std::basic_string<Char>,basic_json<Char>>> injections_;
+    };
+public:
+    basic_json_transform_rules()
+        : nodes_(1)
+    {
+    }
+
+    // Renames the member at path
+    basic_json_transform_rules<Char>& rename(const std::basic_string<Char>& path, const std::basic_string<Char>& new_name)
+    {
+        node& n = nodes_[member_node(path)];
+        n.rename_ = true;
+        n.new_name_ = new_name;
+        return *this;
+    }
+
+    // Removes the value at path, which is skipped without passing on its events
+    basic_json_transform_rules<Char>& drop(const std::basic_string<Char>& path)
+    {
+        nodes_[member_node(path)].drop_ = true;
+        return *this;
+    }
+
+    // Passes a string at path that is a JSON number on as that number
+    basic_json_transform_rules<Char>& to_number(const std::basic_string<Char>& path)
+    {
+        nodes_[member_node(path)].to_number_ = true;
+        return *this;
+    }
+
+    // Replaces an object member at path with its members, named with the
+    // member's name and the separator as a prefix. Other values are kept.
+    basic_json_transform_rules<Char>& flatten(const std::basic_string<Char>& path, const std::basic_string<Char>& separator)
+    {
+        node& n = nodes_[member_node(path)];
+        n.flatten_ = true;
+        n.separator_ = separator;
+        return *this;
+    }
+
+    basic_json_transform_rules<Char>& flatten(const std::basic_string<Char>& path)
+    {
+        static const Char dot[] = {'.', 0};
+        return flatten(path, dot);
+    }
+
+    // Adds a member to the end of each object at path
+    basic_json_transform_rules<Char>& inject(const std::basic_string<Char>& path, const std::basic_string<Char>& name, const basic_json<Char>& value)
+    {
+        nodes_[find_or_add(path)].injections_.push_back(std::make_pair(name, value));
+        return *this;
+    }
+
+private:
+    size_t member_node(const std::basic_string<Char>& path)
+    {
+        size_t i = find_or_add(path);
+        if (i == 0)
+        {
+            JSONCONS_THROW_EXCEPTION("A rename, drop, to_number or flatten rule cannot apply to the root");
+        }
+        return i;
+    }
+
+    size_t find_or_add(const std::basic_string<Char>& path)
+    {
+        return find_or_add_path(nodes_, path);
+    }
+
+    // The node for a member name of an object at node parent, or npos if none
+    size_t member_child(size_t parent, const std::basic_string<Char>& name) const
+    {
+        if (parent == npos)
+        {
+            return npos;
+        }
+        const node& p = nodes_[parent];
+        if (!p.children_.empty())
+        {
+            auto it = p.children_.find(name);
+            if (it != p.children_.end())
+            {
+                return it->second;
+            }
+        }
+        return p.any_;
+    }
+
+    size_t element_child(size_t parent) const
+    {
+        return parent == npos ? npos : nodes_[parent].any_;
+    }
+
+    std::vector<node> nodes_;
+};
+
+// Renames, drops, converts, flattens and adds members while passing events on,
+// following a basic_json_transform_rules table. Values outside the paths of the
+// rules cost a hash lookup per member name of an object on a rule path, and
+// nothing otherwise.
+template <typename Char>
+class basic_json_transform_filter : public basic_json_filter<Char>
+{
+    static const size_t npos = basic_json_transform_rules<Char>::npos;
+
+    struct stack_item
+    {
+        stack_item(bool is_object, size_t node)
+           : is_object_(is_object), flattened_(false), node_(node), child_(npos)
+        {
+        }
+
+        bool is_object_;
+        // Members are passed on to the enclosing object, with prefix_ before their names
+        bool flattened_;
+        size_t node_;
+        // Node of the member being read
+        size_t child_;
+        std::basic_string<Char> prefix_;
+    };
+public:
+    basic_json_transform_filter(basic_json_input_handler<Char>& handler,
+                                const basic_json_transform_rules<Char>& rules)
+        : basic_json_filter<Char>(handler), rules_(rules), skip_depth_(0), has_pending_name_(false)
+    {
+    }
+
+    basic_json_transform_filter(basic_json_output_handler<Char>& output_handler,
+                                const basic_json_transform_rules<Char>& rules)
+        : basic_json_filter<Char>(output_handler), rules_(rules), skip_depth_(0), has_pending_name_(false)
+    {
+    }
+
+private:
+    using basic_json_filter<Char>::input_handler;
+
+    typedef typename basic_json_transform_rules<Char>::node node_type;
+
+    virtual void do_begin_json()
+    {
+        stack_.clear();
+        skip_depth_ = 0;
+        has_pending_name_ = false;
+        input_handler().begin_json();
+    }
+
+    // The node of the value about to start, or npos
+    size_t value_node() const
+    {
+        if (stack_.empty())
+        {
+            return 0;
+        }
+        const stack_item& parent = stack_.back();
+        return parent.is_object_ ? parent.child_ : rules_.element_child(parent.node_);
+    }
+
+    // False if the value is dropped
+    bool begin_value(size_t n, const basic_parsing_context<Char>& context)
+    {
+        if (n != npos && rules_.nodes_[n].drop_)
+        {
+            has_pending_name_ = false;
+            return false;
+        }
+        if (has_pending_name_)
+        {
+            input_handler().name(pending_name_.data(), pending_name_.length(), context);
+            has_pending_name_ = false;
+        }
+        return true;
+    }
+
+    virtual void do_begin_object(const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            ++skip_depth_;
+            return;
+        }
+        size_t n = value_node();
+        if (n != npos && rules_.nodes_[n].flatten_ && has_pending_name_)
+        {
+            stack_item item(true, n);
+            item.flattened_ = true;
+            item.prefix_ = pending_name_;
+            item.prefix_.append(rules_.nodes_[n].separator_);
+            stack_.push_back(item);
+            has_pending_name_ = false;
+            return;
+        }
+        if (!begin_value(n, context))
+        {
+            skip_depth_ = 1;
+            return;
+        }
+        stack_.push_back(stack_item(true, n));
+        input_handler().begin_object(context);
+    }
+
+    virtual void do_end_object(const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            --skip_depth_;
+            return;
+        }
+        const stack_item& item = stack_.back();
+        if (item.node_ != npos)
+        {
+            const node_type& n = rules_.nodes_[item.node_];
+            if (!n.injections_.empty())
+            {
+                basic_json_output_input_adapter<Char> adapter(input_handler(), context);
+                for (size_t i = 0; i < n.injections_.size(); ++i)
+                {
+                    std::basic_string<Char> name(item.prefix_);
+                    name.append(n.injections_[i].first);
+                    input_handler().name(name.data(), name.length(), context);
+                    n.injections_[i].second.to_stream(adapter);
+                }
+            }
+        }
+        if (!item.flattened_)
+        {
+            input_handler().end_object(context);
+        }
+        stack_.pop_back();
+    }
+
+    virtual void do_begin_array(const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            ++skip_depth_;
+            return;
+        }
+        size_t n = value_node();
+        if (!begin_value(n, context))
+        {
+            skip_depth_ = 1;
+            return;
+        }
+        stack_.push_back(stack_item(false, n));
+        input_handler().begin_array(context);
+    }
+
+    virtual void do_end_array(const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            --skip_depth_;
+            return;
+        }
+        stack_.pop_back();
+        input_handler().end_array(context);
+    }
+
+    virtual void do_name(const Char* name, size_t length, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            return;
+        }
+        stack_item& item = stack_.back();
+        if (item.node_ == npos)
+        {
+            input_handler().name(name, length, context);
+            return;
+        }
+        name_buffer_.assign(name, length);
+        item.child_ = rules_.member_child(item.node_, name_buffer_);
+        if (item.child_ == npos && !item.flattened_)
+        {
+            input_handler().name(name, length, context);
+            return;
+        }
+
+        // Passed on when the value starts, when it is known whether it is dropped or flattened
+        pending_name_ = item.prefix_;
+        if (item.child_ != npos && rules_.nodes_[item.child_].rename_)
+        {
+            pending_name_.append(rules_.nodes_[item.child_].new_name_);
+        }
+        else
+        {
+            pending_name_.append(name, length);
+        }
+        has_pending_name_ = true;
+    }
+
+    virtual void do_string_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ > 0)
+        {
+            return;
+        }
+        size_t n = value_node();
+        if (begin_value(n, context))
+        {
+            if (n != npos && rules_.nodes_[n].to_number_ && is_number_text(value, length))
+            {
+                input_handler().number(value, length, context);
+            }
+            else
+            {
+                input_handler().value(value, length, context);
+            }
+        }
+    }
+
+    virtual void do_binary_value(const Char* value, size_t length, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().binary(value, length, context);
+        }
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().number(p, length, context);
+        }
+    }
+
+    virtual void do_double_value(double value, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().value(value, context);
+        }
+    }
+
+    virtual void do_longlong_value(long long value, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().value(value, context);
+        }
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().value(value, context);
+        }
+    }
+
+    virtual void do_bool_value(bool value, const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().value(value, context);
+        }
+    }
+
+    virtual void do_null_value(const basic_parsing_context<Char>& context)
+    {
+        if (skip_depth_ == 0 && begin_value(value_node(), context))
+        {
+            input_handler().value(null_type(), context);
+        }
+    }
+
+    basic_json_transform_rules<Char> rules_;
+    std::vector<stack_item> stack_;
+    size_t skip_depth_;
+    bool has_pending_name_;
+    std::basic_string<Char> pending_name_;
+    std::basic_string<Char> name_buffer_;
+};
+
+typedef basic_json_transform_rules<char> json_transform_rules;
+typedef basic_json_transform_rules<wchar_t> wjson_transform_rules;
+typedef basic_json_transform_filter<char> json_transform_filter;
+typedef basic_json_transform_filter<wchar_t> wjson_transform_filter;
+
+}
+
+#endif
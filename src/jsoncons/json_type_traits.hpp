@@ -454,12 +454,7 @@ public:
     }
     std::vector<T> as(const basic_json<Char, Alloc>& val) const
     {
-        std::vector<T> v(val.size());
-        for (size_t i = 0; i < v.size(); ++i)
-        {
-            v[i] = val[i].template as<T>();
-        }
-        return v;
+        return val.template as_vector<T>();
     }
     void assign(basic_json<Char, Alloc>& self, const std::vector<T>& val)
     {
@@ -13,9 +13,14 @@
 #include <vector>
 #include <istream>
 #include <cstdlib>
+#include <cstring>
+#include <cfloat>
 #include <cwchar>
 #include <cstdint> 
 #include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <atomic>
 #include "jsoncons/jsoncons_config.hpp"
 
 namespace jsoncons {
@@ -270,11 +275,577 @@ struct json_char_traits<wchar_t,4> // assume utf32
     }
 };
 
+template<typename Char>
+unsigned long long string_to_unsigned(const Char *s, size_t length) throw(std::overflow_error)
+{
+    const unsigned long long max_value = std::numeric_limits<unsigned long long>::max JSONCONS_NO_MACRO_EXP();
+    const unsigned long long max_value_div_10 = max_value/10;
+    unsigned long long n = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned long long x = s[i] - '0';
+        if (n > max_value_div_10)
+        {
+            throw std::overflow_error("Unsigned overflow");
+        }
+        n = n * 10;
+        if (n > max_value - x)
+        {
+            throw std::overflow_error("Unsigned overflow");
+        }
+
+        n += x;
+    }
+    return n;
+}
+
+template<typename Char>
+long long string_to_integer(bool has_neg, const Char *s, size_t length) throw(std::overflow_error)
+{
+    const long long max_value = std::numeric_limits<long long>::max JSONCONS_NO_MACRO_EXP();
+    const long long max_value_div_10 = max_value/10;
+
+    long long n = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        long long x = s[i] - '0';
+        if (n > max_value_div_10)
+        {
+            throw std::overflow_error("Integer overflow");
+        }
+        n = n * 10;
+        if (n > max_value - x)
+        {
+            throw std::overflow_error("Integer overflow");
+        }
+
+        n += x;
+    }
+    return has_neg ? -n : n;
+}
+
+// Checks that text is a JSON number, tolerating leading zeros as basic_json_reader does
+template<typename Char>
+bool is_number_text(const Char* p, size_t length)
+{
+    const Char* end = p + length;
+    if (p != end && *p == '-')
+    {
+        ++p;
+    }
+    const Char* digits = p;
+    while (p != end && *p >= '0' && *p <= '9')
+    {
+        ++p;
+    }
+    if (p == digits)
+    {
+        return false;
+    }
+    if (p != end && *p == '.')
+    {
+        digits = ++p;
+        while (p != end && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+        if (p == digits)
+        {
+            return false;
+        }
+    }
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        if (p != end && (*p == '+' || *p == '-'))
+        {
+            ++p;
+        }
+        digits = p;
+        while (p != end && *p >= '0' && *p <= '9')
+        {
+            ++p;
+        }
+        if (p == digits)
+        {
+            return false;
+        }
+    }
+    return p == end;
+}
+
+// The value of the text of a JSON number, typed as basic_json_reader types it: 
+// long long for negative integers, unsigned long long for other integers, 
+// and double for numbers with a fraction or exponent or out of integer range
+struct number_text_value
+{
+    enum kind_t {longlong_kind,ulonglong_kind,double_kind};
+
+    kind_t kind;
+    long long longlong_value;
+    unsigned long long ulonglong_value;
+    double double_value;
+};
+
+// Converts number text whose digits, without the decimal point, fit in 53 bits
+// and whose decimal exponent is at most 22 in magnitude. Both the digits and
+// the power of ten are then exact doubles, so one multiplication or division
+// rounds correctly. Returns false for any other text, which is left to
+// string_to_float. Needs no allocation and does not depend on the locale.
+template<typename Char>
+bool exact_text_to_float(const Char* p, size_t length, double& value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+    return false;
+#else
+    static const double powers_of_ten[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const Char* end = p + length;
+    bool is_negative = p < end && *p == '-';
+    if (is_negative)
+    {
+        ++p;
+    }
+    unsigned long long mantissa = 0;
+    size_t digit_count = 0;
+    long exponent = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+        if (mantissa != 0 || *p != '0')
+        {
+            mantissa = mantissa*10 + (*p - '0');
+            ++digit_count;
+        }
+        if (digit_count > 15)
+        {
+            return false;
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+        {
+            if (mantissa != 0 || *p != '0')
+            {
+                mantissa = mantissa*10 + (*p - '0');
+                ++digit_count;
+            }
+            if (digit_count > 15)
+            {
+                return false;
+            }
+            --exponent;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool is_negative_exponent = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            ++p;
+        }
+        long e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p)
+        {
+            if (e > 1000)
+            {
+                return false;
+            }
+            e = e*10 + (*p - '0');
+        }
+        exponent += is_negative_exponent ? -e : e;
+    }
+    if (p != end || exponent < -22 || exponent > 22)
+    {
+        return false;
+    }
+    double d = static_cast<double>(mantissa);
+    if (exponent < 0)
+    {
+        d /= powers_of_ten[-exponent];
+    }
+    else
+    {
+        d *= powers_of_ten[exponent];
+    }
+    value = is_negative ? -d : d;
+    return true;
+#endif
+}
+
+template<typename Char>
+number_text_value parse_number_text(const Char* p, size_t length)
+{
+    number_text_value result = {number_text_value::double_kind,0,0,0.0};
+
+    bool has_neg = length > 0 && p[0] == '-';
+    const Char* digits = has_neg ? p + 1 : p;
+    size_t digits_length = has_neg ? length - 1 : length;
+
+    bool is_integer = digits_length > 0;
+    for (size_t i = 0; is_integer && i < digits_length; ++i)
+    {
+        is_integer = digits[i] >= '0' && digits[i] <= '9';
+    }
+    if (is_integer)
+    {
+        try
+        {
+            if (has_neg)
+            {
+                result.longlong_value = string_to_integer(has_neg, digits, digits_length);
+                result.kind = number_text_value::longlong_kind;
+            }
+            else
+            {
+                result.ulonglong_value = string_to_unsigned(digits, digits_length);
+                result.kind = number_text_value::ulonglong_kind;
+            }
+            return result;
+        }
+        catch (const std::overflow_error&)
+        {
+            // fall back to double
+        }
+    }
+    if (!exact_text_to_float(p, length, result.double_value))
+    {
+        result.double_value = string_to_float(std::basic_string<Char>(p,length));
+    }
+    return result;
+}
+
+// Writes the decimal digits of value right to left, ending just before last, 
+// and returns the first digit. Two digits are produced per division.
+// The space before last must hold 20 characters.
+template <typename Char>
+Char* format_unsigned(unsigned long long value, Char* last)
+{
+    static const char digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    Char* p = last;
+    while (value >= 100)
+    {
+        const char* pair = digit_pairs + (value % 100) * 2;
+        value /= 100;
+        *--p = static_cast<Char>(pair[1]);
+        *--p = static_cast<Char>(pair[0]);
+    }
+    if (value >= 10)
+    {
+        const char* pair = digit_pairs + value * 2;
+        *--p = static_cast<Char>(pair[1]);
+        *--p = static_cast<Char>(pair[0]);
+    }
+    else
+    {
+        *--p = static_cast<Char>('0' + value);
+    }
+    return p;
+}
+
+// As format_unsigned, with a leading minus sign for negative values.
+// The space before last must hold 21 characters.
+template <typename Char>
+Char* format_integer(long long value, Char* last)
+{
+    if (value < 0)
+    {
+        Char* p = format_unsigned(static_cast<unsigned long long>(-(value + 1)) + 1, last);
+        *--p = '-';
+        return p;
+    }
+    return format_unsigned(static_cast<unsigned long long>(value), last);
+}
+
+// Spreads the bits of a hash value (the 64 bit finalizer from MurmurHash3)
+inline
+uint64_t mix_hash(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Hashes any number through its double value, so that numbers that compare equal 
+// as long long, unsigned long long or double hash equal
+inline
+size_t hash_number(double val)
+{
+    if (val == 0)
+    {
+        val = 0.0; // -0.0 == 0.0
+    }
+    else if (val != val)
+    {
+        return static_cast<size_t>(mix_hash(0x7ff8000000000000ULL));
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return static_cast<size_t>(mix_hash(bits));
+}
+
+// Streaming 64 bit xxHash (XXH64). Input may be passed in pieces of any size,
+// the digest is the same as for the concatenated input.
+class xxhash64
+{
+public:
+    explicit xxhash64(uint64_t seed = 0)
+    {
+        reset(seed);
+    }
+
+    void reset(uint64_t seed = 0)
+    {
+        seed_ = seed;
+        v1_ = seed + prime1 + prime2;
+        v2_ = seed + prime2;
+        v3_ = seed;
+        v4_ = seed - prime1;
+        total_length_ = 0;
+        buffered_ = 0;
+    }
+
+    void update(const void* data, size_t length)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const unsigned char* end = p + length;
+        total_length_ += length;
+
+        if (buffered_ + length < 32)
+        {
+            std::memcpy(buffer_ + buffered_, p, length);
+            buffered_ += length;
+            return;
+        }
+        if (buffered_ > 0)
+        {
+            size_t n = 32 - buffered_;
+            std::memcpy(buffer_ + buffered_, p, n);
+            p += n;
+            consume(buffer_);
+            buffered_ = 0;
+        }
+        while (end - p >= 32)
+        {
+            consume(p);
+            p += 32;
+        }
+        buffered_ = static_cast<size_t>(end - p);
+        std::memcpy(buffer_, p, buffered_);
+    }
+
+    uint64_t digest() const
+    {
+        uint64_t h;
+        if (total_length_ >= 32)
+        {
+            h = rotl(v1_, 1) + rotl(v2_, 7) + rotl(v3_, 12) + rotl(v4_, 18);
+            h = merge(h, v1_);
+            h = merge(h, v2_);
+            h = merge(h, v3_);
+            h = merge(h, v4_);
+        }
+        else
+        {
+            h = seed_ + prime5;
+        }
+        h += total_length_;
+
+        const unsigned char* p = buffer_;
+        const unsigned char* end = buffer_ + buffered_;
+        for (; end - p >= 8; p += 8)
+        {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * prime1 + prime4;
+        }
+        if (end - p >= 4)
+        {
+            h ^= read32(p) * prime1;
+            h = rotl(h, 23) * prime2 + prime3;
+            p += 4;
+        }
+        for (; p != end; ++p)
+        {
+            h ^= *p * prime5;
+            h = rotl(h, 11) * prime1;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static const uint64_t prime1 = 11400714785074694791ULL;
+    static const uint64_t prime2 = 14029467366897019727ULL;
+    static const uint64_t prime3 = 1609587929392839161ULL;
+    static const uint64_t prime4 = 9650029242287828579ULL;
+    static const uint64_t prime5 = 2870177450012600261ULL;
+
+    static uint64_t rotl(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t round(uint64_t acc, uint64_t input)
+    {
+        acc += input * prime2;
+        return rotl(acc, 31) * prime1;
+    }
+
+    static uint64_t merge(uint64_t acc, uint64_t v)
+    {
+        acc ^= round(0, v);
+        return acc * prime1 + prime4;
+    }
+
+    // Little endian reads, independent of the byte order of the host
+    static uint64_t read64(const unsigned char* p)
+    {
+        return read32(p) | (read32(p + 4) << 32);
+    }
+
+    static uint64_t read32(const unsigned char* p)
+    {
+        return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) |
+               (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24);
+    }
+
+    void consume(const unsigned char* p)
+    {
+        v1_ = round(v1_, read64(p));
+        v2_ = round(v2_, read64(p + 8));
+        v3_ = round(v3_, read64(p + 16));
+        v4_ = round(v4_, read64(p + 24));
+    }
+
+    uint64_t seed_;
+    uint64_t v1_;
+    uint64_t v2_;
+    uint64_t v3_;
+    uint64_t v4_;
+    uint64_t total_length_;
+    unsigned char buffer_[32];
+    size_t buffered_;
+};
+
 inline
 bool is_control_character(uint32_t c)
 {
     return c <= 0x1F || c == 0x7f;
 }
 
+// Heap bytes owned by a json value, see basic_json::memory_usage
+struct json_memory_usage
+{
+    json_memory_usage()
+        : strings(0), arrays(0), objects(0), keys(0), anys(0), unused_capacity(0)
+    {
+    }
+
+    size_t total() const
+    {
+        return strings + arrays + objects + keys + anys;
+    }
+
+    // string_data blocks of strings, binary values and lazy numbers
+    size_t strings;
+    // Array impls and their element vectors, including contiguous numbers
+    size_t arrays;
+    // Object impls and their member vectors
+    size_t objects;
+    // Member names that do not fit in the small string buffer
+    size_t keys;
+    // any values and their heap payloads
+    size_t anys;
+    // The part of arrays and objects that is reserved but not used
+    size_t unused_capacity;
+};
+
+// Counts the allocations jsoncons makes for json values while a counter is installed.
+// Vector growth is reported as the size of the new buffer.
+class json_allocation_counter
+{
+public:
+    json_allocation_counter()
+        : count_(0), bytes_(0)
+    {
+    }
+
+    static void install(json_allocation_counter* counter)
+    {
+        installed().store(counter, std::memory_order_release);
+    }
+
+    static void uninstall()
+    {
+        install(nullptr);
+    }
+
+    static void add(size_t bytes)
+    {
+        json_allocation_counter* counter = installed().load(std::memory_order_acquire);
+        if (counter != nullptr)
+        {
+            counter->count_.fetch_add(1, std::memory_order_relaxed);
+            counter->bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    static bool enabled()
+    {
+        return installed().load(std::memory_order_relaxed) != nullptr;
+    }
+
+    size_t count() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    size_t bytes() const
+    {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        count_.store(0, std::memory_order_relaxed);
+        bytes_.store(0, std::memory_order_relaxed);
+    }
+private:
+    json_allocation_counter(const json_allocation_counter&); // noop
+    json_allocation_counter& operator=(const json_allocation_counter&); // noop
+
+    static std::atomic<json_allocation_counter*>& installed()
+    {
+        static std::atomic<json_allocation_counter*> counter(nullptr);
+        return counter;
+    }
+
+    std::atomic<size_t> count_;
+    std::atomic<size_t> bytes_;
+};
+
 }
 #endif
@@ -22,6 +22,19 @@
 
 #define JSONCONS_NO_MACRO_EXP 
 
+// Define JSONCONS_NO_SSE2 to keep the SSE2 string scanning code out of the build
+#if !defined(JSONCONS_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSONCONS_HAS_SSE2
+#endif
+
+// Define JSONCONS_NO_SSSE3 or JSONCONS_NO_AVX2 to keep the base64 kernels that use them out of the build
+#if !defined(JSONCONS_NO_SSSE3) && (defined(__SSSE3__) || defined(__AVX__))
+#define JSONCONS_HAS_SSSE3
+#endif
+#if !defined(JSONCONS_NO_AVX2) && defined(JSONCONS_HAS_SSSE3) && defined(__AVX2__)
+#define JSONCONS_HAS_AVX2
+#endif
+
 namespace jsoncons {
 
 // Follow boost
@@ -94,11 +107,13 @@ inline bool is_neg_inf(double x) {return  std::isinf(x) && x > 0;}
 #endif
 
 #ifdef _MSC_VER
-template <typename Char>
-std::basic_string<Char> float_to_string(double val, size_t precision)
+// Writes val with precision significant digits, dropping the trailing zeros of
+// the fraction, at buf, which has room for n characters. Returns the length of
+// the text, or zero if it does not fit.
+inline
+size_t format_float(double val, size_t precision, char* buf, size_t n)
 {
-    std::basic_string<Char> s;
-    char buf[_CVTBUFSIZE];
+    char digits[_CVTBUFSIZE];
     int decimal_point = 0;
     int sign = 0;
 
@@ -107,15 +122,11 @@ std::basic_string<Char> float_to_string(double val, size_t precision)
         precision = _CVTBUFSIZE - 1;
     }
 
-    int err = _ecvt_s(buf, _CVTBUFSIZE, val, static_cast<int>(precision), &decimal_point, &sign);
+    int err = _ecvt_s(digits, _CVTBUFSIZE, val, static_cast<int>(precision), &decimal_point, &sign);
     if (err != 0)
     {
         throw std::runtime_error("Failed attempting double to string conversion");
     }
-    if (sign != 0)
-    {
-        s.push_back('-');
-    }
 
     int len = static_cast<int>(precision);
 
@@ -132,76 +143,121 @@ std::basic_string<Char> float_to_string(double val, size_t precision)
         exponent = 0;
     }
 
-    while (len >= 2 && buf[len - 1] == '0' && (len - 1) != decimal)
+    while (len >= 2 && digits[len - 1] == '0' && (len - 1) != decimal)
     {
         --len;
     }
 
+    // Sign, "0.", the digits and a point, and an exponent of at most 16 characters
+    if (static_cast<size_t>(len) + 21 > n)
+    {
+        return 0;
+    }
+    char* p = buf;
+    if (sign != 0)
+    {
+        *p++ = '-';
+    }
     if (decimal == 0)
     {
-        s.push_back('0');
-        s.push_back('.');
+        *p++ = '0';
+        *p++ = '.';
     }
-    s.push_back(buf[0]);
+    *p++ = digits[0];
     for (int i = 1; i < len; ++i)
     {
         if (i == decimal)
         {
-            s.push_back('.');
+            *p++ = '.';
         }
-        s.push_back(buf[i]);
+        *p++ = digits[i];
     }
     if (exponent != 0)
     {
-        s.push_back('e');
+        *p++ = 'e';
         if (exponent > 0)
         {
-            s.push_back('+');
+            *p++ = '+';
         }
-        int err2 = _itoa_s(exponent,buf,_CVTBUFSIZE,10);
+        char exponent_digits[16];
+        int err2 = _itoa_s(exponent,exponent_digits,16,10);
         if (err2 != 0)
         {
             throw std::runtime_error("Failed attempting double to string conversion");
         }
-        for (int i = 0; i < _CVTBUFSIZE && buf[i]; ++i)
+        for (int i = 0; i < 16 && exponent_digits[i]; ++i)
         {
-            s.push_back(buf[i]);
+            *p++ = exponent_digits[i];
         }
     }
-    return s;
+    return static_cast<size_t>(p - buf);
 }
 #else
-template <typename Char>
-std::basic_string<Char> float_to_string(double val, size_t precision)
+// Writes val with precision significant digits, dropping the trailing zeros of
+// the fraction, at buf, which has room for n characters. Returns the length of
+// the text, or zero if it does not fit.
+inline
+size_t format_float(double val, size_t precision, char* buf, size_t n)
 {
-    std::basic_ostringstream<Char> os;
-    os.imbue(std::locale::classic());
-    os << std::showpoint << std::setprecision(precision) << val;
-    std::basic_string<Char> s(os.str());
-
-    typename std::basic_string<Char>::size_type exp_pos= s.find('e');
-    std::basic_string<Char> exp;
-    if (exp_pos != std::basic_string<Char>::npos)
+    int length = c99_snprintf(buf, n, "%#.*g", static_cast<int>(precision), val);
+    if (length < 0 || static_cast<size_t>(length) >= n)
     {
-        exp = s.substr(exp_pos);
-        s.erase(exp_pos);
+        return 0;
+    }
+    char* end = buf + length;
+    if (val - val == 0)
+    {
+        // The locale's decimal point, of one or more bytes, becomes '.'
+        char* q = buf;
+        bool has_point = false;
+        for (const char* p = buf; p != end; ++p)
+        {
+            char c = *p;
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == 'e')
+            {
+                *q++ = c;
+            }
+            else if (!has_point)
+            {
+                *q++ = '.';
+                has_point = true;
+            }
+        }
+        end = q;
     }
 
-    int len = s.size();
-    while (len >= 2 && s[len - 1] == '0' && s[len - 2] != '.')
+    char* exponent = buf;
+    while (exponent != end && *exponent != 'e')
     {
-        --len;
+        ++exponent;
     }
-    s.erase(len);
-    if (exp_pos != std::basic_string<Char>::npos)
+    char* last = exponent;
+    while (last - buf >= 2 && last[-1] == '0' && last[-2] != '.')
     {
-        s.append(exp);
+        --last;
     }
-
-    return s;
+    while (exponent != end)
+    {
+        *last++ = *exponent++;
+    }
+    return static_cast<size_t>(last - buf);
 }
 #endif
 
+template <typename Char>
+std::basic_string<Char> float_to_string(double val, size_t precision)
+{
+    char buf[64];
+    size_t length = format_float(val, precision, buf, sizeof(buf));
+    if (length != 0)
+    {
+        return std::basic_string<Char>(buf, buf + length);
+    }
+    std::vector<char> large(precision + 32);
+    length = format_float(val, precision, large.data(), large.size());
+    return std::basic_string<Char>(large.data(), large.data() + length);
+}
+
 #ifdef _MSC_VER
 inline
 double string_to_float(const std::string& s)
@@ -0,0 +1,96 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_LRU_CACHE_HPP
+#define JSONCONS_LRU_CACHE_HPP
+
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "jsoncons/jsoncons.hpp"
+
+namespace jsoncons {
+
+// A thread safe cache of at most capacity immutable values, dropping the least
+// recently used. Values are shared, so one that is dropped stays alive for as
+// long as a caller holds it. Values are made outside the lock, two threads
+// missing the same key may both make it, and the first one stored is kept.
+template <class Key, class T>
+class lru_cache
+{
+    typedef std::list<std::pair<Key,std::shared_ptr<const T>>> list_type;
+public:
+    explicit lru_cache(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    template <class Make>
+    std::shared_ptr<const T> get(const Key& key, Make make)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end())
+            {
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return it->second->second;
+            }
+        }
+
+        std::shared_ptr<const T> value = std::make_shared<const T>(make());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+        entries_.push_front(std::make_pair(key, value));
+        index_[key] = entries_.begin();
+        if (entries_.size() > capacity_)
+        {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        return value;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        entries_.clear();
+    }
+
+private:
+    lru_cache(const lru_cache&); // noop
+    lru_cache& operator=(const lru_cache&); // noop
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    list_type entries_;
+    std::unordered_map<Key,typename list_type::iterator> index_;
+};
+
+}
+
+#endif
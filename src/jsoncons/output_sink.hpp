@@ -0,0 +1,326 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_OUTPUT_SINK_HPP
+#define JSONCONS_OUTPUT_SINK_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "jsoncons/jsoncons.hpp"
+
+namespace jsoncons {
+
+// Destination for serialized text, written to in large blocks by basic_output_buffer
+template <typename Char>
+class basic_output_sink
+{
+public:
+    virtual ~basic_output_sink()
+    {
+    }
+
+    void write(const Char* s, size_t length)
+    {
+        do_write(s, length);
+    }
+
+    void flush()
+    {
+        do_flush();
+    }
+
+private:
+    virtual void do_write(const Char* s, size_t length) = 0;
+
+    virtual void do_flush()
+    {
+    }
+};
+
+template <typename Char>
+class basic_ostream_sink : public basic_output_sink<Char>
+{
+public:
+    basic_ostream_sink(std::basic_ostream<Char>& os)
+        : os_(std::addressof(os))
+    {
+    }
+
+private:
+    virtual void do_write(const Char* s, size_t length)
+    {
+        os_->write(s, length);
+    }
+
+    virtual void do_flush()
+    {
+        os_->flush();
+    }
+
+    std::basic_ostream<Char>* os_;
+};
+
+template <typename Char>
+class basic_string_sink : public basic_output_sink<Char>
+{
+public:
+    basic_string_sink(std::basic_string<Char>& s)
+        : s_(std::addressof(s))
+    {
+    }
+
+private:
+    virtual void do_write(const Char* s, size_t length)
+    {
+        s_->append(s, length);
+    }
+
+    std::basic_string<Char>* s_;
+};
+
+// Writes into a caller owned buffer. Output that does not fit is dropped
+// and overflow() becomes true.
+template <typename Char>
+class basic_fixed_buffer_sink : public basic_output_sink<Char>
+{
+public:
+    basic_fixed_buffer_sink(Char* p, size_t capacity)
+        : p_(p), capacity_(capacity), length_(0), overflow_(false)
+    {
+    }
+
+    size_t length() const
+    {
+        return length_;
+    }
+
+    bool overflow() const
+    {
+        return overflow_;
+    }
+
+private:
+    virtual void do_write(const Char* s, size_t length)
+    {
+        size_t n = (std::min)(length, capacity_ - length_);
+        std::char_traits<Char>::copy(p_ + length_, s, n);
+        length_ += n;
+        if (n < length)
+        {
+            overflow_ = true;
+        }
+    }
+
+    Char* p_;
+    size_t capacity_;
+    size_t length_;
+    bool overflow_;
+};
+
+// Writes to a file descriptor, such as a file or socket opened by the caller
+class fd_sink : public basic_output_sink<char>
+{
+public:
+    explicit fd_sink(int fd)
+        : fd_(fd)
+    {
+    }
+
+private:
+    virtual void do_write(const char* s, size_t length)
+    {
+        while (length > 0)
+        {
+#if defined(_WIN32)
+            int n = ::_write(fd_, s, static_cast<unsigned int>((std::min)(length, static_cast<size_t>(INT_MAX))));
+#else
+            ssize_t n = ::write(fd_, s, length);
+#endif
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                JSONCONS_THROW_EXCEPTION("Write to file descriptor failed");
+            }
+            s += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+
+    int fd_;
+};
+
+// Feeds output to an xxhash64 instead of storing it. Characters are hashed
+// as their in-memory code units.
+template <typename Char>
+class basic_hash_sink : public basic_output_sink<Char>
+{
+public:
+    explicit basic_hash_sink(uint64_t seed = 0)
+        : hash_(seed)
+    {
+    }
+
+    uint64_t hash() const
+    {
+        return hash_.digest();
+    }
+
+private:
+    virtual void do_write(const Char* s, size_t length)
+    {
+        hash_.update(s, length*sizeof(Char));
+    }
+
+    xxhash64 hash_;
+};
+
+// Collects output in a contiguous block and passes it to a sink when full,
+// so that formatting code appends to memory rather than calling into a stream.
+// The block starts inside the buffer and grows on the heap up to max_capacity,
+// so short output such as a scalar never allocates.
+template <typename Char>
+class basic_output_buffer
+{
+public:
+    static const size_t inline_capacity = 256;
+    static const size_t max_capacity = 16384;
+
+    basic_output_buffer(basic_output_sink<Char>& sink)
+        : sink_(std::addressof(sink))
+    {
+        begin_ = inline_;
+        p_ = begin_;
+        end_ = begin_ + inline_capacity;
+    }
+
+    void put(Char c)
+    {
+        if (p_ == end_)
+        {
+            make_room(1);
+        }
+        *p_++ = c;
+    }
+
+    void write(const Char* s, size_t length)
+    {
+        if (length > static_cast<size_t>(end_ - p_))
+        {
+            make_room(length);
+            if (length > static_cast<size_t>(end_ - p_))
+            {
+                sink_->write(s, length);
+                return;
+            }
+        }
+        std::char_traits<Char>::copy(p_, s, length);
+        p_ += length;
+    }
+
+    void write(const std::basic_string<Char>& s)
+    {
+        write(s.data(), s.length());
+    }
+
+    // Writes n copies of c
+    void fill(Char c, size_t n)
+    {
+        while (n > 0)
+        {
+            if (p_ == end_)
+            {
+                make_room(n);
+            }
+            size_t m = (std::min)(n, static_cast<size_t>(end_ - p_));
+            std::char_traits<Char>::assign(p_, m, c);
+            p_ += m;
+            n -= m;
+        }
+    }
+
+    // Passes the buffered output to the sink
+    void flush()
+    {
+        if (p_ != begin_)
+        {
+            Char* p = p_;
+            p_ = begin_;
+            sink_->write(begin_, p - begin_);
+        }
+    }
+
+    basic_output_sink<Char>& sink()
+    {
+        return *sink_;
+    }
+
+private:
+    basic_output_buffer(const basic_output_buffer&); // noop
+    basic_output_buffer& operator=(const basic_output_buffer&); // noop
+
+    // Grows the block, doubling it up to max_capacity, when length more
+    // characters do not fit, and flushes it once it is at max_capacity.
+    // Afterwards there may still be less room than length.
+    void make_room(size_t length)
+    {
+        size_t capacity = end_ - begin_;
+        size_t size = p_ - begin_;
+        if (capacity < max_capacity)
+        {
+            size_t new_capacity = capacity;
+            while (new_capacity < max_capacity && new_capacity - size < length)
+            {
+                new_capacity *= 2;
+            }
+            std::vector<Char> data(new_capacity);
+            std::char_traits<Char>::copy(data.data(), begin_, size);
+            data_.swap(data);
+            begin_ = data_.data();
+            p_ = begin_ + size;
+            end_ = begin_ + new_capacity;
+            if (new_capacity - size >= length)
+            {
+                return;
+            }
+        }
+        flush();
+    }
+
+    basic_output_sink<Char>* sink_;
+    Char inline_[inline_capacity];
+    std::vector<Char> data_;
+    Char* begin_;
+    Char* p_;
+    Char* end_;
+};
+
+typedef basic_output_sink<char> output_sink;
+typedef basic_output_sink<wchar_t> woutput_sink;
+typedef basic_ostream_sink<char> ostream_sink;
+typedef basic_ostream_sink<wchar_t> wostream_sink;
+typedef basic_string_sink<char> string_sink;
+typedef basic_string_sink<wchar_t> wstring_sink;
+typedef basic_fixed_buffer_sink<char> fixed_buffer_sink;
+typedef basic_fixed_buffer_sink<wchar_t> wfixed_buffer_sink;
+typedef basic_hash_sink<char> hash_sink;
+typedef basic_hash_sink<wchar_t> whash_sink;
+
+}
+
+#endif
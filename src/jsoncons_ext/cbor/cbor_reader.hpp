@@ -216,6 +216,9 @@ void basic_cbor_reader< Char, Alloc >::parse_array( uint8_t additional ) {
     }
     
     parse_thing();
+    if( length > 0 ) {
+      --length;
+    }
   }
   
   handler_->end_array( *this );
@@ -254,6 +257,9 @@ void basic_cbor_reader< Char, Alloc >::parse_map( uint8_t additional ) {
     handler_->name( name.data(), name.size(), *this );
     
     parse_thing();
+    if( length > 0 ) {
+      --length;
+    }
   }
   
   handler_->end_object( *this );
@@ -38,37 +38,119 @@ public:
     }
 
 private:
-    void put_major( uint8_t major, uint8_t additional ) {
-      os_->put(major << 5 | additional);
-    }
-
-    void put_additional( uint8_t major, uint64_t additional ) {
+    // Appends encoded bytes to a buffer, so that an array of numbers
+    // can be encoded as a block and written to the stream at once
+    struct buffer_sink
+    {
+        buffer_sink(std::basic_string<Char>& buf)
+            : buf_(buf)
+        {
+        }
+        void put(Char c)
+        {
+            buf_.push_back(c);
+        }
+        std::basic_string<Char>& buf_;
+    };
+
+    template <class Sink>
+    static void put_major( Sink& sink, uint8_t major, uint8_t additional ) {
+      sink.put(major << 5 | additional);
+    }
+
+    template <class Sink>
+    static void put_additional( Sink& sink, uint8_t major, uint64_t additional ) {
       if( additional < 24ull ) {
-        put_major( major, additional );
+        put_major( sink, major, additional );
       } else if( additional < 256ull ) {
-        put_major( major, 24 );
-        os_->put( ( additional ) & 0xff );
+        put_major( sink, major, 24 );
+        sink.put( ( additional ) & 0xff );
       } else if( additional < 65536ull ) {
-        put_major( major, 25 );
-        os_->put( ( additional >> 8 ) & 0xff );
-        os_->put( ( additional ) & 0xff );
+        put_major( sink, major, 25 );
+        sink.put( ( additional >> 8 ) & 0xff );
+        sink.put( ( additional ) & 0xff );
       } else if( additional < 4294967296ull ) {
-        put_major( major, 26 );
-        os_->put( ( additional >> 24 ) & 0xff );
-        os_->put( ( additional >> 16 ) & 0xff );
-        os_->put( ( additional >> 8 ) & 0xff );
-        os_->put( ( additional ) & 0xff );
+        put_major( sink, major, 26 );
+        sink.put( ( additional >> 24 ) & 0xff );
+        sink.put( ( additional >> 16 ) & 0xff );
+        sink.put( ( additional >> 8 ) & 0xff );
+        sink.put( ( additional ) & 0xff );
+      } else {
+        put_major( sink, major, 27 );
+        sink.put( ( additional >> 56 ) & 0xff );
+        sink.put( ( additional >> 48 ) & 0xff );
+        sink.put( ( additional >> 40 ) & 0xff );
+        sink.put( ( additional >> 32 ) & 0xff );
+        sink.put( ( additional >> 24 ) & 0xff );
+        sink.put( ( additional >> 16 ) & 0xff );
+        sink.put( ( additional >> 8 ) & 0xff );
+        sink.put( ( additional ) & 0xff );
+      }
+    }
+
+    template <class Sink>
+    static void put_double( Sink& sink, double val ) {
+      int exponent;
+      int64_t fraction = static_cast< int64_t >( frexp( val, &exponent ) * 9007199254740992 ) & 0x000fffffffffffffull;
+      
+      if( exponent < 127 && exponent > -126 && ( fraction & 0x000000001fffffffull ) == 0 ) {
+        fraction >>= 29;
+        uint32_t bits = val < 0 ? 0x80000000ul : 0ul;
+        bits |= ( static_cast< uint32_t >( exponent + 126 ) << 23 ) & 0x7f100000ul;
+        bits |= fraction;
+
+        put_major( sink, 7, 26 );
+        sink.put( ( bits >> 24 ) & 0xff );
+        sink.put( ( bits >> 16 ) & 0xff );
+        sink.put( ( bits >> 8 ) & 0xff );
+        sink.put( ( bits ) & 0xff );
       } else {
-        put_major( major, 27 );
-        os_->put( ( additional >> 56 ) & 0xff );
-        os_->put( ( additional >> 48 ) & 0xff );
-        os_->put( ( additional >> 40 ) & 0xff );
-        os_->put( ( additional >> 32 ) & 0xff );
-        os_->put( ( additional >> 24 ) & 0xff );
-        os_->put( ( additional >> 16 ) & 0xff );
-        os_->put( ( additional >> 8 ) & 0xff );
-        os_->put( ( additional ) & 0xff );
+        uint64_t bits = val < 0 ? 0x8000000000000000ull : 0ull;
+        bits |= ( static_cast< int64_t >( exponent + 1022 ) << 52 ) & 0x7ff0000000000000ull;
+        bits |= fraction;
+
+        put_major( sink, 7, 27 );
+        sink.put( ( bits >> 56 ) & 0xff );
+        sink.put( ( bits >> 48 ) & 0xff );
+        sink.put( ( bits >> 40 ) & 0xff );
+        sink.put( ( bits >> 32 ) & 0xff );
+        sink.put( ( bits >> 24 ) & 0xff );
+        sink.put( ( bits >> 16 ) & 0xff );
+        sink.put( ( bits >> 8 ) & 0xff );
+        sink.put( ( bits ) & 0xff );
+      }
+    }
+
+    template <class Sink>
+    static void put_number( Sink& sink, double val ) {
+      put_double( sink, val );
+    }
+
+    template <class Sink>
+    static void put_number( Sink& sink, long long val ) {
+      if( val < 0 ) {
+        put_additional( sink, 1, static_cast< uint64_t >( -1 - val ) );
+      } else {
+        put_additional( sink, 0, val );
+      }
+    }
+
+    template <class Sink>
+    static void put_number( Sink& sink, unsigned long long val ) {
+      put_additional( sink, 0, val );
+    }
+
+    // Numbers held contiguously are written as a definite length array
+    template <class T>
+    void write_numbers( const T* p, size_t length ) {
+      std::basic_string<Char> buf;
+      buf.reserve( 9 * ( length + 1 ) );
+      buffer_sink sink( buf );
+      put_additional( sink, 4, length );
+      for( size_t i = 0; i < length; ++i ) {
+        put_number( sink, p[i] );
       }
+      os_->write( buf.data(), buf.length() );
     }
 
     virtual void do_begin_json()
@@ -81,104 +163,86 @@ private:
 
     virtual void do_begin_object()
     {
-      put_major( 5, 31 );
+      put_major( *os_, 5, 31 );
     }
 
     virtual void do_end_object()
     {
-      put_major( 7, 31 );
+      put_major( *os_, 7, 31 );
     }
 
     virtual void do_begin_array()
     {
-      put_major( 4, 31 );
+      put_major( *os_, 4, 31 );
     }
 
     virtual void do_end_array()
     {
-      put_major( 7, 31 );
+      put_major( *os_, 7, 31 );
     }
 
     virtual void do_name(const Char* name, size_t length)
     {
-      put_additional( 3, length );
+      put_additional( *os_, 3, length );
       os_->write( name, length );
     }
 
     virtual void do_null_value()
     {
-      put_additional( 7, 22 );
+      put_additional( *os_, 7, 22 );
     }
 
     virtual void do_string_value(const Char* val, size_t length)
     {
-      put_additional( 3, length );
+      put_additional( *os_, 3, length );
       os_->write( val, length );
     }
 
     virtual void do_binary_value(const Char* val, size_t length)
     {
-      put_additional( 2, length );
+      put_additional( *os_, 2, length );
       os_->write( val, length );
     }
 
     virtual void do_double_value(double val)
     {
-      int exponent;
-      double significand = frexp( val, &exponent );
-      int64_t fraction = static_cast< int64_t >( frexp( val, &exponent ) * 9007199254740992 ) & 0x000fffffffffffffull;
-      
-      if( exponent < 127 && exponent > -126 && ( fraction & 0x000000001fffffffull ) == 0 ) {
-        fraction >>= 29;
-        uint32_t bits = val < 0 ? 0x80000000ul : 0ul;
-        bits |= ( static_cast< uint32_t >( exponent + 126 ) << 23 ) & 0x7f100000ul;
-        bits |= fraction;
-
-        put_major( 7, 26 );
-        os_->put( ( bits >> 24 ) & 0xff );
-        os_->put( ( bits >> 16 ) & 0xff );
-        os_->put( ( bits >> 8 ) & 0xff );
-        os_->put( ( bits ) & 0xff );
-      } else {
-        uint64_t bits = val < 0 ? 0x8000000000000000ull : 0ull;
-        bits |= ( static_cast< int64_t >( exponent + 1022 ) << 52 ) & 0x7ff0000000000000ull;
-        bits |= fraction;
-
-        put_major( 7, 27 );
-        os_->put( ( bits >> 56 ) & 0xff );
-        os_->put( ( bits >> 48 ) & 0xff );
-        os_->put( ( bits >> 40 ) & 0xff );
-        os_->put( ( bits >> 32 ) & 0xff );
-        os_->put( ( bits >> 24 ) & 0xff );
-        os_->put( ( bits >> 16 ) & 0xff );
-        os_->put( ( bits >> 8 ) & 0xff );
-        os_->put( ( bits ) & 0xff );
-      }
+      put_number( *os_, val );
     }
 
     virtual void do_longlong_value(long long val)
     {
-      if( val < 0 ) {
-        put_additional( 1, - 1 - val );
-      } else {
-        put_additional( 0, val );
-      }
+      put_number( *os_, val );
     }
 
     virtual void do_ulonglong_value(unsigned long long val)
     {
-      put_additional( 0, val );
+      put_number( *os_, val );
     }
 
     virtual void do_bool_value(bool val)
     {
       if( val ) {
-        put_additional( 7, 21 );
+        put_additional( *os_, 7, 21 );
       } else {
-        put_additional( 7, 22 );
+        put_additional( *os_, 7, 22 );
       }
     }
 
+    virtual void do_double_array_value(const double* p, size_t length)
+    {
+      write_numbers( p, length );
+    }
+
+    virtual void do_longlong_array_value(const long long* p, size_t length)
+    {
+      write_numbers( p, length );
+    }
+
+    virtual void do_ulonglong_array_value(const unsigned long long* p, size_t length)
+    {
+      write_numbers( p, length );
+    }
+
     std::basic_ostream<Char>* os_;
 };
 
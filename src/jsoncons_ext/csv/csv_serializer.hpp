@@ -276,6 +276,24 @@ private:
         }
     }
 
+    virtual void do_binary_value(const Char* val, size_t length)
+    {
+        if (stack_.size() == 2 && !stack_.back().skip_)
+        {
+            std::basic_ostringstream<Char> ss;
+            jsoncons::base64_string<Char>(val, length, format_, ss);
+            std::basic_string<Char> s = ss.str();
+            if (stack_.back().is_object() && stack_[0].count_ == 0)
+            {
+                value(s.data(),s.length(),header_os_);
+            }
+            else
+            {
+                value(s.data(),s.length(),*os_);
+            }
+        }
+    }
+
     virtual void do_double_value(double val)
     {
         if (stack_.size() == 2 && !stack_.back().skip_)
@@ -394,7 +412,10 @@ private:
     {
         begin_value(os);
 
-        os  << val;
+        Char digits[32];
+        Char* last = digits + 32;
+        Char* first = jsoncons::format_integer(val, last);
+        os.write(first, last - first);
 
         end_value();
     }
@@ -403,7 +424,10 @@ private:
     {
         begin_value(os);
 
-        os  << val;
+        Char digits[32];
+        Char* last = digits + 32;
+        Char* first = jsoncons::format_unsigned(val, last);
+        os.write(first, last - first);
 
         end_value();
     }
@@ -0,0 +1,621 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_EXT_JSONPATCH_JSONPATCH_HPP
+#define JSONCONS_EXT_JSONPATCH_JSONPATCH_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <deque>
+#include <unordered_set>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons_ext/jsonpointer/jsonpointer.hpp"
+
+namespace jsoncons_ext { namespace jsonpatch {
+
+namespace detail {
+
+// Applies the operations of a JSON Patch (RFC 6902) to a value in place. Each
+// path is compiled once as a basic_json_pointer, and the parent it names is 
+// looked up once. A run of add and replace operations on members of the same
+// object is kept as a batch and set with one sorted merge, when an operation 
+// that is not part of the run comes, or at the end. 
+//
+// Every change made is recorded with what it replaced or removed, and if an 
+// operation fails the changes are undone in reverse order, so that the patch
+// is applied as a whole or not at all (RFC 6902 section 5).
+template <class Json>
+class patch_applier
+{
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef std::pair<string_type,Json> member_type;
+    typedef jsoncons_ext::jsonpointer::basic_json_pointer<Json> pointer;
+    typedef typename pointer::token token;
+
+    // A change to the value at path, or to the root if path has no tokens.
+    // The location is looked up again when undoing, by then the document is
+    // as it was just after the change.
+    struct change
+    {
+        enum kind_type
+        {
+            replaced,   // old_ was at the location
+            inserted,   // the location was added
+            removed     // old_ was at the location, and was removed
+        };
+
+        change(kind_type kind, const pointer* path, size_t index)
+            : kind_(kind), path_(path), index_(index), moved_(false)
+        {
+        }
+
+        kind_type kind_;
+        const pointer* path_;
+        size_t index_;  // of the element, if the parent is an array
+        Json old_;
+        bool moved_;    // old_ is the value taken by the change undone before this one
+    };
+public:
+    patch_applier(Json& target)
+        : target_(target), batch_parent_(nullptr)
+    {
+    }
+
+    // The values of the operations are moved out of patch if movable is true
+    void apply(const Json& patch, bool movable)
+    {
+        if (!patch.is_array())
+        {
+            JSONCONS_THROW_EXCEPTION("A JSON Patch must be an array of operations");
+        }
+        try
+        {
+            for (size_t i = 0; i < patch.size(); ++i)
+            {
+                apply_operation(patch.at(i), movable);
+            }
+            flush();
+        }
+        catch (...)
+        {
+            clear_batch();
+            undo();
+            throw;
+        }
+    }
+
+private:
+    patch_applier(const patch_applier&); // noop
+    patch_applier& operator=(const patch_applier&); // noop
+
+    static string_type literal(const char* s)
+    {
+        string_type result;
+        for (; *s != 0; ++s)
+        {
+            result.push_back(static_cast<char_type>(*s));
+        }
+        return result;
+    }
+
+    const Json& member(const Json& op, const char* name)
+    {
+        typedef char_type Char;
+
+        string_type s = literal(name);
+        if (!op.is_object() || !op.has_member(s))
+        {
+            JSONCONS_THROW_EXCEPTION_1("A JSON Patch operation is missing %s", s);
+        }
+        return op.get(s);
+    }
+
+    const pointer& compile(const Json& val)
+    {
+        paths_.push_back(pointer::compile(val.as_string()));
+        return paths_.back();
+    }
+
+    // Whether the first count tokens of a and b are the same
+    static bool same_tokens(const pointer& a, const pointer& b, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (a[i].key_ != b[i].key_)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool is_append(const token& t)
+    {
+        return t.key_.length() == 1 && t.key_.data()[0] == '-';
+    }
+
+    // The value named by the first count tokens of p, throws if there is none
+    Json& resolve(const pointer& p, size_t count)
+    {
+        typedef char_type Char;
+
+        Json* current = std::addressof(target_);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const token& t = p[i];
+            Json* next = nullptr;
+            if (current->is_array())
+            {
+                if (t.is_index_ && t.index_ < current->size())
+                {
+                    next = std::addressof(current->at(t.index_));
+                }
+            }
+            else
+            {
+                next = current->find(t.key_);
+            }
+            if (next == nullptr)
+            {
+                JSONCONS_THROW_EXCEPTION_1("%s not found", p.text());
+            }
+            current = next;
+        }
+        return *current;
+    }
+
+    Json take_value(const Json& op, bool movable)
+    {
+        const Json& value = member(op, "value");
+        Json result;
+        if (movable)
+        {
+            // Only done for a patch passed as an rvalue
+            result.swap(const_cast<Json&>(value));
+        }
+        else
+        {
+            result = value;
+        }
+        return result;
+    }
+
+    void apply_operation(const Json& op, bool movable)
+    {
+        typedef char_type Char;
+
+        string_type name = member(op, "op").as_string();
+        const pointer& p = compile(member(op, "path"));
+        if (name == literal("add") || name == literal("replace"))
+        {
+            bool is_replace = name == literal("replace");
+            Json value = take_value(op, movable);
+            if (batch(p, is_replace, value))
+            {
+                return;
+            }
+            flush();
+            if (is_replace)
+            {
+                replace(p, value);
+            }
+            else
+            {
+                add(p, value);
+            }
+            return;
+        }
+
+        flush();
+        if (name == literal("remove"))
+        {
+            remove(p);
+        }
+        else if (name == literal("move"))
+        {
+            const pointer& from = compile(member(op, "from"));
+            if (from.size() == p.size() && same_tokens(from, p, p.size()))
+            {
+                resolve(from, from.size());
+                return;
+            }
+            if (from.size() < p.size() && same_tokens(from, p, from.size()))
+            {
+                JSONCONS_THROW_EXCEPTION_1("Cannot move a value into itself, %s", p.text());
+            }
+            remove(from);
+            const size_t removal = changes_.size() - 1;
+            Json value;
+            value.swap(changes_[removal].old_);
+            changes_[removal].moved_ = true;
+            try
+            {
+                add(p, value);
+            }
+            catch (...)
+            {
+                // Not added, the value goes back with the removal
+                changes_[removal].old_.swap(value);
+                changes_[removal].moved_ = false;
+                throw;
+            }
+        }
+        else if (name == literal("copy"))
+        {
+            const pointer& from = compile(member(op, "from"));
+            Json value = resolve(from, from.size());
+            add(p, value);
+        }
+        else if (name == literal("test"))
+        {
+            if (!(resolve(p, p.size()) == member(op, "value")))
+            {
+                JSONCONS_THROW_EXCEPTION_1("Test failed at %s", p.text());
+            }
+        }
+        else
+        {
+            JSONCONS_THROW_EXCEPTION_1("Unknown JSON Patch operation %s", name);
+        }
+    }
+
+    // Adds the operation to the batch if it sets a member of an object, returns false otherwise
+    bool batch(const pointer& p, bool is_replace, Json& value)
+    {
+        typedef char_type Char;
+
+        if (p.size() == 0)
+        {
+            return false;
+        }
+        const size_t n = p.size() - 1;
+        const string_type& name = p[n].key_.name();
+        bool same_parent = batch_parent_ != nullptr && batch_paths_.front()->size() == p.size() &&
+                           same_tokens(*batch_paths_.front(), p, n);
+        if (same_parent && batch_names_.count(name) > 0)
+        {
+            flush();
+            same_parent = false;
+        }
+        if (!same_parent)
+        {
+            flush();
+            Json& parent = resolve(p, n);
+            if (!parent.is_object())
+            {
+                return false;
+            }
+            batch_parent_ = std::addressof(parent);
+        }
+        if (is_replace && batch_parent_->find(p[n].key_) == nullptr)
+        {
+            JSONCONS_THROW_EXCEPTION_1("%s not found", p.text());
+        }
+        batch_names_.insert(name);
+        batch_paths_.push_back(std::addressof(p));
+        batch_members_.push_back(member_type());
+        batch_members_.back().first = name;
+        batch_members_.back().second.swap(value);
+        return true;
+    }
+
+    // Members already there are swapped with their new values, the others are set with one merge
+    void flush()
+    {
+        if (batch_parent_ != nullptr)
+        {
+            reserve_changes(batch_members_.size());
+            std::vector<member_type> added;
+            std::vector<const pointer*> added_paths;
+            for (size_t i = 0; i < batch_members_.size(); ++i)
+            {
+                const pointer* path = batch_paths_[i];
+                Json* existing = batch_parent_->find((*path)[path->size() - 1].key_);
+                if (existing != nullptr)
+                {
+                    existing->swap(batch_members_[i].second);
+                    record(change::replaced, path, 0, batch_members_[i].second);
+                }
+                else
+                {
+                    added.push_back(member_type());
+                    added.back().first.swap(batch_members_[i].first);
+                    added.back().second.swap(batch_members_[i].second);
+                    added_paths.push_back(path);
+                }
+            }
+            if (!added.empty())
+            {
+                batch_parent_->set_members(std::move(added));
+                for (size_t i = 0; i < added_paths.size(); ++i)
+                {
+                    Json none;
+                    record(change::inserted, added_paths[i], 0, none);
+                }
+            }
+            clear_batch();
+        }
+    }
+
+    // Changes are recorded once made, with room reserved before so that recording does not throw
+    void reserve_changes(size_t n)
+    {
+        changes_.reserve(changes_.size() + n);
+    }
+
+    // Records a change, taking the value it replaced or removed from old
+    void record(typename change::kind_type kind, const pointer* path, size_t index, Json& old)
+    {
+        changes_.push_back(change(kind, path, index));
+        changes_.back().old_.swap(old);
+    }
+
+    void clear_batch()
+    {
+        batch_members_.clear();
+        batch_paths_.clear();
+        batch_names_.clear();
+        batch_parent_ = nullptr;
+    }
+
+    void add(const pointer& p, Json& value)
+    {
+        typedef char_type Char;
+
+        reserve_changes(1);
+        if (p.size() == 0)
+        {
+            target_.swap(value);
+            record(change::replaced, std::addressof(p), 0, value);
+            return;
+        }
+        Json& parent = resolve(p, p.size() - 1);
+        const token& t = p[p.size() - 1];
+        Json none;
+        if (parent.is_array())
+        {
+            size_t index = is_append(t) ? parent.size() : t.index_;
+            if (!is_append(t) && !(t.is_index_ && index <= parent.size()))
+            {
+                JSONCONS_THROW_EXCEPTION_1("Invalid array index in %s", p.text());
+            }
+            parent.add(index, std::move(value));
+            record(change::inserted, std::addressof(p), index, none);
+        }
+        else if (parent.is_object())
+        {
+            Json* existing = parent.find(t.key_);
+            if (existing != nullptr)
+            {
+                existing->swap(value);
+                record(change::replaced, std::addressof(p), 0, value);
+                return;
+            }
+            std::vector<member_type> members(1);
+            members[0].first = t.key_.name();
+            members[0].second.swap(value);
+            parent.set_members(std::move(members));
+            record(change::inserted, std::addressof(p), 0, none);
+        }
+        else
+        {
+            JSONCONS_THROW_EXCEPTION_1("%s is not in an object or array", p.text());
+        }
+    }
+
+    void replace(const pointer& p, Json& value)
+    {
+        reserve_changes(1);
+        resolve(p, p.size()).swap(value);
+        record(change::replaced, std::addressof(p), p.size() > 0 ? p[p.size() - 1].index_ : 0, value);
+    }
+
+    void remove(const pointer& p)
+    {
+        typedef char_type Char;
+
+        if (p.size() == 0)
+        {
+            JSONCONS_THROW_EXCEPTION("Cannot remove the whole document");
+        }
+        reserve_changes(1);
+        Json& parent = resolve(p, p.size() - 1);
+        const token& t = p[p.size() - 1];
+        Json* existing = nullptr;
+        if (parent.is_array())
+        {
+            existing = t.is_index_ && t.index_ < parent.size() ? std::addressof(parent.at(t.index_)) : nullptr;
+        }
+        else if (parent.is_object())
+        {
+            existing = parent.find(t.key_);
+        }
+        if (existing == nullptr)
+        {
+            JSONCONS_THROW_EXCEPTION_1("%s not found", p.text());
+        }
+        Json value;
+        value.swap(*existing);
+        if (parent.is_array())
+        {
+            parent.remove_range(t.index_, t.index_ + 1);
+        }
+        else
+        {
+            parent.remove_member(t.key_.name());
+        }
+        record(change::removed, std::addressof(p), t.index_, value);
+    }
+
+    // Reverts the recorded changes, last first. The value an undone change 
+    // takes out of the document is kept for the change before it if that one
+    // was the removal at the source of a move.
+    void undo()
+    {
+        Json taken;
+        while (!changes_.empty())
+        {
+            change& c = changes_.back();
+            const pointer& p = *c.path_;
+            if (p.size() == 0)
+            {
+                target_.swap(c.old_);
+                taken.swap(c.old_);
+                changes_.pop_back();
+                continue;
+            }
+            Json& parent = resolve(p, p.size() - 1);
+            const token& t = p[p.size() - 1];
+            switch (c.kind_)
+            {
+            case change::replaced:
+                {
+                    Json& current = parent.is_array() ? parent.at(c.index_) : *parent.find(t.key_);
+                    current.swap(c.old_);
+                    taken.swap(c.old_);
+                }
+                break;
+            case change::inserted:
+                if (parent.is_array())
+                {
+                    taken.swap(parent.at(c.index_));
+                    parent.remove_range(c.index_, c.index_ + 1);
+                }
+                else
+                {
+                    taken.swap(*parent.find(t.key_));
+                    parent.remove_member(t.key_.name());
+                }
+                break;
+            case change::removed:
+                if (c.moved_)
+                {
+                    c.old_.swap(taken);
+                }
+                if (parent.is_array())
+                {
+                    parent.add(c.index_, std::move(c.old_));
+                }
+                else
+                {
+                    std::vector<member_type> members(1);
+                    members[0].first = t.key_.name();
+                    members[0].second.swap(c.old_);
+                    parent.set_members(std::move(members));
+                }
+                break;
+            }
+            changes_.pop_back();
+        }
+    }
+
+    Json& target_;
+    std::deque<pointer> paths_;
+    std::vector<change> changes_;
+    Json* batch_parent_;
+    std::vector<const pointer*> batch_paths_;
+    std::vector<member_type> batch_members_;
+    std::unordered_set<string_type> batch_names_;
+};
+
+// Merges patch into target as RFC 7386 describes. The members of an object
+// patch are visited in name order, its removals are made in one pass and its
+// new members set with one sorted merge.
+template <class Json>
+void merge_patch(Json& target, const Json& patch, bool movable)
+{
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> string_type;
+
+    if (!patch.is_object())
+    {
+        if (movable)
+        {
+            // Only done for a patch passed as an rvalue
+            target.swap(const_cast<Json&>(patch));
+        }
+        else
+        {
+            target = patch;
+        }
+        return;
+    }
+    if (!target.is_object())
+    {
+        target = Json();
+    }
+    std::vector<string_type> removals;
+    std::vector<std::pair<string_type,Json>> additions;
+    for (auto it = patch.begin_members(); it != patch.end_members(); ++it)
+    {
+        const Json& value = it->value();
+        if (value.is_null())
+        {
+            removals.push_back(it->name());
+            continue;
+        }
+        Json* existing = target.find(typename Json::key(it->name()));
+        if (existing != nullptr)
+        {
+            merge_patch(*existing, value, movable);
+        }
+        else
+        {
+            additions.push_back(std::pair<string_type,Json>());
+            additions.back().first = it->name();
+            merge_patch(additions.back().second, value, movable);
+        }
+    }
+    if (!removals.empty())
+    {
+        target.remove_members(std::move(removals));
+    }
+    if (!additions.empty())
+    {
+        target.set_members(std::move(additions));
+    }
+}
+
+}
+
+// Applies a JSON Patch (RFC 6902), an array of operations, to target in place.
+// Throws json_exception if an operation fails, after which target is as it was.
+template <class Json>
+void apply_patch(Json& target, const Json& patch)
+{
+    detail::patch_applier<Json> applier(target);
+    applier.apply(patch, false);
+}
+
+// The same, moving the values of the operations out of patch
+template <class Json>
+void apply_patch(Json& target, Json&& patch)
+{
+    detail::patch_applier<Json> applier(target);
+    applier.apply(patch, true);
+}
+
+// Applies a JSON Merge Patch (RFC 7386) to target in place
+template <class Json>
+void apply_merge_patch(Json& target, const Json& patch)
+{
+    detail::merge_patch(target, patch, false);
+}
+
+// The same, moving values out of patch
+template <class Json>
+void apply_merge_patch(Json& target, Json&& patch)
+{
+    detail::merge_patch(target, patch, true);
+}
+
+}}
+
+#endif
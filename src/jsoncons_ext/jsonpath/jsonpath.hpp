@@ -0,0 +1,711 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_EXT_JSONPATH_JSONPATH_HPP
+#define JSONCONS_EXT_JSONPATH_JSONPATH_HPP
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/lru_cache.hpp"
+
+namespace jsoncons_ext { namespace jsonpath {
+
+// [start:end:step], a missing start or end is given by has_start_ or has_end_
+struct path_slice
+{
+    path_slice()
+        : start_(0), end_(0), step_(1), has_start_(false), has_end_(false)
+    {
+    }
+
+    long long start_;
+    long long end_;
+    long long step_;
+    bool has_start_;
+    bool has_end_;
+};
+
+// One step of a path, selecting the members or elements of a value. A selector
+// is either a wildcard or a union of names, indices and slices.
+template <typename Char>
+struct path_selector
+{
+    path_selector()
+        : recursive_(false), wildcard_(false)
+    {
+    }
+
+    // Preceded by .., so that it applies to the value and all of its descendants
+    bool recursive_;
+    bool wildcard_;
+    std::vector<std::basic_string<Char>> names_;
+    std::vector<long long> indices_;
+    std::vector<path_slice> slices_;
+
+    bool matches_name(const Char* p, size_t length) const
+    {
+        if (wildcard_)
+        {
+            return true;
+        }
+        for (size_t i = 0; i < names_.size(); ++i)
+        {
+            if (names_[i].length() == length && std::char_traits<Char>::compare(names_[i].data(), p, length) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether the element at index of an array of unknown length is selected,
+    // only defined when !requires_length()
+    bool matches_index(size_t index) const
+    {
+        if (wildcard_)
+        {
+            return true;
+        }
+        long long i = static_cast<long long>(index);
+        for (size_t k = 0; k < indices_.size(); ++k)
+        {
+            if (indices_[k] == i)
+            {
+                return true;
+            }
+        }
+        for (size_t k = 0; k < slices_.size(); ++k)
+        {
+            const path_slice& s = slices_[k];
+            if (i >= s.start_ && (!s.has_end_ || i < s.end_) && (i - s.start_) % s.step_ == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Negative indices and bounds count from the end, and a negative step
+    // walks backwards from it, so they cannot be decided before an array ends
+    bool requires_length() const
+    {
+        for (size_t k = 0; k < indices_.size(); ++k)
+        {
+            if (indices_[k] < 0)
+            {
+                return true;
+            }
+        }
+        for (size_t k = 0; k < slices_.size(); ++k)
+        {
+            const path_slice& s = slices_[k];
+            if (s.step_ < 0 || s.start_ < 0 || (s.has_end_ && s.end_ < 0))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// A parsed JSONPath expression, a sequence of selectors applied from the root $.
+// Supported are .name, ['name'], .*, [*], [n], [start:end:step], unions such as
+// [0,2] or ['a','b'], and recursive descent with ..
+template <typename Char>
+class basic_jsonpath_expression
+{
+public:
+    static basic_jsonpath_expression<Char> compile(const std::basic_string<Char>& path)
+    {
+        return compile(path.data(), path.length());
+    }
+
+    static basic_jsonpath_expression<Char> compile(const Char* p, size_t length)
+    {
+        basic_jsonpath_expression<Char> expr;
+        expr.text_.assign(p, length);
+        path_compiler c(p, p + length);
+        c.compile(expr.selectors_);
+        return expr;
+    }
+
+    const std::basic_string<Char>& text() const
+    {
+        return text_;
+    }
+
+    size_t size() const
+    {
+        return selectors_.size();
+    }
+
+    const path_selector<Char>& operator[](size_t i) const
+    {
+        return selectors_[i];
+    }
+
+    bool has_recursive_descent() const
+    {
+        for (size_t i = 0; i < selectors_.size(); ++i)
+        {
+            if (selectors_[i].recursive_)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool requires_length() const
+    {
+        for (size_t i = 0; i < selectors_.size(); ++i)
+        {
+            if (selectors_[i].requires_length())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    class path_compiler
+    {
+    public:
+        path_compiler(const Char* begin, const Char* end)
+            : begin_(begin), p_(begin), end_(end)
+        {
+        }
+
+        void compile(std::vector<path_selector<Char>>& selectors)
+        {
+            skip_whitespace();
+            if (p_ == end_ || *p_ != '$')
+            {
+                error("Expected $");
+            }
+            ++p_;
+            skip_whitespace();
+            while (p_ != end_)
+            {
+                path_selector<Char> sel;
+                if (*p_ == '.')
+                {
+                    ++p_;
+                    if (p_ != end_ && *p_ == '.')
+                    {
+                        ++p_;
+                        sel.recursive_ = true;
+                        if (p_ != end_ && *p_ == '[')
+                        {
+                            ++p_;
+                            parse_bracket(sel);
+                            selectors.push_back(sel);
+                            skip_whitespace();
+                            continue;
+                        }
+                    }
+                    if (p_ != end_ && *p_ == '*')
+                    {
+                        ++p_;
+                        sel.wildcard_ = true;
+                    }
+                    else
+                    {
+                        sel.names_.push_back(parse_identifier());
+                    }
+                }
+                else if (*p_ == '[')
+                {
+                    ++p_;
+                    parse_bracket(sel);
+                }
+                else
+                {
+                    error("Expected . or [");
+                }
+                selectors.push_back(sel);
+                skip_whitespace();
+            }
+        }
+
+    private:
+        std::basic_string<Char> parse_identifier()
+        {
+            const Char* start = p_;
+            while (p_ != end_ && *p_ != '.' && *p_ != '[' && *p_ != ' ' && *p_ != '\t' && *p_ != '\r' && *p_ != '\n')
+            {
+                ++p_;
+            }
+            if (p_ == start)
+            {
+                error("Expected name");
+            }
+            return std::basic_string<Char>(start, p_);
+        }
+
+        // After the [, reads the union up to and including the ]
+        void parse_bracket(path_selector<Char>& sel)
+        {
+            skip_whitespace();
+            if (p_ != end_ && *p_ == '*')
+            {
+                ++p_;
+                sel.wildcard_ = true;
+                skip_whitespace();
+                expect(']');
+                return;
+            }
+            if (p_ != end_ && *p_ == '?')
+            {
+                error("Filter expressions are not supported");
+            }
+            for (;;)
+            {
+                skip_whitespace();
+                if (p_ == end_)
+                {
+                    error("Expected ]");
+                }
+                if (*p_ == '\'' || *p_ == '\"')
+                {
+                    sel.names_.push_back(parse_quoted());
+                }
+                else
+                {
+                    parse_index_or_slice(sel);
+                }
+                skip_whitespace();
+                if (p_ != end_ && *p_ == ',')
+                {
+                    ++p_;
+                    continue;
+                }
+                expect(']');
+                return;
+            }
+        }
+
+        std::basic_string<Char> parse_quoted()
+        {
+            Char quote = *p_++;
+            std::basic_string<Char> s;
+            while (p_ != end_ && *p_ != quote)
+            {
+                if (*p_ == '\\')
+                {
+                    ++p_;
+                    if (p_ == end_)
+                    {
+                        break;
+                    }
+                }
+                s.push_back(*p_++);
+            }
+            if (p_ == end_)
+            {
+                error("Unterminated string");
+            }
+            ++p_;
+            return s;
+        }
+
+        void parse_index_or_slice(path_selector<Char>& sel)
+        {
+            path_slice slice;
+            slice.has_start_ = parse_integer(slice.start_);
+            skip_whitespace();
+            if (p_ == end_ || *p_ != ':')
+            {
+                if (!slice.has_start_)
+                {
+                    error("Expected index, slice or name");
+                }
+                sel.indices_.push_back(slice.start_);
+                return;
+            }
+            ++p_;
+            skip_whitespace();
+            slice.has_end_ = parse_integer(slice.end_);
+            skip_whitespace();
+            if (p_ != end_ && *p_ == ':')
+            {
+                ++p_;
+                skip_whitespace();
+                if (parse_integer(slice.step_) && slice.step_ == 0)
+                {
+                    error("Slice step cannot be zero");
+                }
+            }
+            if (!slice.has_start_)
+            {
+                slice.start_ = slice.step_ > 0 ? 0 : -1;
+            }
+            sel.slices_.push_back(slice);
+        }
+
+        bool parse_integer(long long& value)
+        {
+            const Char* start = p_;
+            bool negative = false;
+            if (p_ != end_ && *p_ == '-')
+            {
+                negative = true;
+                ++p_;
+            }
+            const long long max_value = (std::numeric_limits<long long>::max)();
+            long long n = 0;
+            const Char* digits = p_;
+            while (p_ != end_ && *p_ >= '0' && *p_ <= '9')
+            {
+                long long d = static_cast<long long>(*p_ - '0');
+                if (n > (max_value - d)/10)
+                {
+                    error("Index out of range");
+                }
+                n = n*10 + d;
+                ++p_;
+            }
+            if (p_ == digits)
+            {
+                p_ = start;
+                return false;
+            }
+            value = negative ? -n : n;
+            return true;
+        }
+
+        void expect(Char c)
+        {
+            if (p_ == end_ || *p_ != c)
+            {
+                std::string msg("Expected ");
+                msg.push_back(static_cast<char>(c));
+                error(msg.c_str());
+            }
+            ++p_;
+        }
+
+        void skip_whitespace()
+        {
+            while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n'))
+            {
+                ++p_;
+            }
+        }
+
+        void error(const char* what)
+        {
+            std::string msg(what);
+            msg.append(" at position ");
+            char buf[32];
+            c99_snprintf(buf, sizeof(buf), "%u", static_cast<unsigned int>(p_ - begin_));
+            msg.append(buf);
+            msg.append(" of JSONPath %s");
+            JSONCONS_THROW_EXCEPTION_1(msg,std::basic_string<Char>(begin_, end_));
+        }
+
+        const Char* begin_;
+        const Char* p_;
+        const Char* end_;
+    };
+
+    std::basic_string<Char> text_;
+    std::vector<path_selector<Char>> selectors_;
+};
+
+// A JSONPath compiled for evaluation against a basic_json. Names are kept as
+// basic_json keys, with their hash and the position of the last match, and
+// the results are pointers to values in the document rather than copies.
+template <class Json>
+class basic_jsonpath
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef typename Json::key key_type;
+
+private:
+    struct selector_plan
+    {
+        selector_plan(const path_selector<char_type>& sel)
+            : sel_(sel)
+        {
+            for (size_t i = 0; i < sel.names_.size(); ++i)
+            {
+                keys_.push_back(key_type(sel.names_[i]));
+            }
+        }
+
+        path_selector<char_type> sel_;
+        std::vector<key_type> keys_;
+    };
+public:
+    static basic_jsonpath<Json> compile(const string_type& path)
+    {
+        return basic_jsonpath<Json>(basic_jsonpath_expression<char_type>::compile(path));
+    }
+
+    explicit basic_jsonpath(const basic_jsonpath_expression<char_type>& expr)
+        : text_(expr.text())
+    {
+        for (size_t i = 0; i < expr.size(); ++i)
+        {
+            plan_.push_back(selector_plan(expr[i]));
+        }
+    }
+
+    const string_type& text() const
+    {
+        return text_;
+    }
+
+    // The values selected from root, in document order for each selector
+    std::vector<Json*> select(Json& root) const
+    {
+        std::vector<Json*> result;
+        select_into(root, result);
+        return result;
+    }
+
+    std::vector<const Json*> select(const Json& root) const
+    {
+        std::vector<const Json*> result;
+        select_into(root, result);
+        return result;
+    }
+
+    // The first value selected from root, or null if there is none
+    Json* select_first(Json& root) const
+    {
+        return first_of(root);
+    }
+
+    const Json* select_first(const Json& root) const
+    {
+        return first_of(root);
+    }
+
+private:
+    template <class J>
+    void select_into(J& root, std::vector<J*>& result) const
+    {
+        std::vector<J*> current(1, std::addressof(root));
+        for (size_t i = 0; i < plan_.size() && !current.empty(); ++i)
+        {
+            const selector_plan& step = plan_[i];
+            if (step.sel_.recursive_)
+            {
+                std::vector<J*> nodes;
+                for (size_t j = 0; j < current.size(); ++j)
+                {
+                    add_descendants(current[j], nodes);
+                }
+                current.swap(nodes);
+            }
+            std::vector<J*> next;
+            for (size_t j = 0; j < current.size(); ++j)
+            {
+                apply(step, current[j], next);
+            }
+            current.swap(next);
+        }
+        result.swap(current);
+    }
+
+    template <class J>
+    J* first_of(J& root) const
+    {
+        // Paths of names and indices select at most one value, which is found
+        // without building the intermediate sets
+        J* p = std::addressof(root);
+        for (size_t i = 0; i < plan_.size() && p != nullptr; ++i)
+        {
+            const selector_plan& step = plan_[i];
+            const path_selector<char_type>& sel = step.sel_;
+            if (sel.recursive_ || sel.wildcard_ || !sel.slices_.empty() || sel.names_.size() + sel.indices_.size() != 1)
+            {
+                std::vector<J*> result;
+                select_into(root, result);
+                return result.empty() ? nullptr : result[0];
+            }
+            if (!step.keys_.empty())
+            {
+                p = p->find(step.keys_[0]);
+            }
+            else if (p->is_array())
+            {
+                size_t index;
+                p = normalize_index(sel.indices_[0], p->size(), index) ? std::addressof(p->at(index)) : nullptr;
+            }
+            else
+            {
+                p = nullptr;
+            }
+        }
+        return p;
+    }
+
+    // Appends val and all values below it, in document order
+    template <class J>
+    static void add_descendants(J* val, std::vector<J*>& nodes)
+    {
+        nodes.push_back(val);
+        if (val->is_array())
+        {
+            for (size_t i = 0; i < val->size(); ++i)
+            {
+                add_descendants<J>(std::addressof(val->at(i)), nodes);
+            }
+        }
+        else if (val->is_object())
+        {
+            for (auto it = val->begin_members(); it != val->end_members(); ++it)
+            {
+                add_descendants<J>(std::addressof(it->value()), nodes);
+            }
+        }
+    }
+
+    template <class J>
+    static void apply(const selector_plan& step, J* val, std::vector<J*>& next)
+    {
+        const path_selector<char_type>& sel = step.sel_;
+        if (val->is_object())
+        {
+            if (sel.wildcard_)
+            {
+                for (auto it = val->begin_members(); it != val->end_members(); ++it)
+                {
+                    next.push_back(std::addressof(it->value()));
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < step.keys_.size(); ++k)
+                {
+                    J* p = val->find(step.keys_[k]);
+                    if (p != nullptr)
+                    {
+                        next.push_back(p);
+                    }
+                }
+            }
+        }
+        else if (val->is_array())
+        {
+            const size_t n = val->size();
+            if (sel.wildcard_)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    next.push_back(std::addressof(val->at(i)));
+                }
+                return;
+            }
+            for (size_t k = 0; k < sel.indices_.size(); ++k)
+            {
+                size_t index;
+                if (normalize_index(sel.indices_[k], n, index))
+                {
+                    next.push_back(std::addressof(val->at(index)));
+                }
+            }
+            for (size_t k = 0; k < sel.slices_.size(); ++k)
+            {
+                apply_slice(sel.slices_[k], val, next);
+            }
+        }
+    }
+
+    template <class J>
+    static void apply_slice(const path_slice& s, J* val, std::vector<J*>& next)
+    {
+        const long long n = static_cast<long long>(val->size());
+        long long start = s.start_ < 0 ? s.start_ + n : s.start_;
+        if (s.step_ > 0)
+        {
+            long long end = !s.has_end_ ? n : (s.end_ < 0 ? s.end_ + n : s.end_);
+            long long lower = (std::min)((std::max)(start, 0LL), n);
+            long long upper = (std::min)((std::max)(end, 0LL), n);
+            for (long long i = lower; i < upper; i += s.step_)
+            {
+                next.push_back(std::addressof(val->at(static_cast<size_t>(i))));
+            }
+        }
+        else
+        {
+            long long end = !s.has_end_ ? -1 : (s.end_ < 0 ? s.end_ + n : s.end_);
+            long long upper = (std::min)((std::max)(start, -1LL), n - 1);
+            long long lower = (std::min)((std::max)(end, -1LL), n - 1);
+            for (long long i = upper; i > lower; i += s.step_)
+            {
+                next.push_back(std::addressof(val->at(static_cast<size_t>(i))));
+            }
+        }
+    }
+
+    // Negative indices count from the end
+    static bool normalize_index(long long i, size_t n, size_t& index)
+    {
+        if (i < 0)
+        {
+            i += static_cast<long long>(n);
+        }
+        if (i < 0 || static_cast<unsigned long long>(i) >= n)
+        {
+            return false;
+        }
+        index = static_cast<size_t>(i);
+        return true;
+    }
+
+    string_type text_;
+    std::vector<selector_plan> plan_;
+};
+
+// Compiled paths by text, least recently used dropped first, safe to share between threads
+template <class Json>
+class basic_jsonpath_cache
+{
+public:
+    typedef typename basic_jsonpath<Json>::string_type string_type;
+
+    explicit basic_jsonpath_cache(size_t capacity = 1024)
+        : cache_(capacity)
+    {
+    }
+
+    std::shared_ptr<const basic_jsonpath<Json>> get(const string_type& path)
+    {
+        return cache_.get(path, [&](){return basic_jsonpath<Json>::compile(path);});
+    }
+
+    size_t size() const
+    {
+        return cache_.size();
+    }
+
+private:
+    jsoncons::lru_cache<string_type,basic_jsonpath<Json>> cache_;
+};
+
+typedef basic_jsonpath_expression<char> jsonpath_expression;
+typedef basic_jsonpath_expression<wchar_t> wjsonpath_expression;
+typedef basic_jsonpath<jsoncons::json> jsonpath;
+typedef basic_jsonpath<jsoncons::wjson> wjsonpath;
+typedef basic_jsonpath_cache<jsoncons::json> jsonpath_cache;
+typedef basic_jsonpath_cache<jsoncons::wjson> wjsonpath_cache;
+
+}}
+
+#endif
@@ -0,0 +1,429 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_EXT_JSONPATH_JSONPATH_FILTER_HPP
+#define JSONCONS_EXT_JSONPATH_JSONPATH_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json_input_handler.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_filter.hpp"
+#include "jsoncons_ext/jsonpath/jsonpath.hpp"
+
+namespace jsoncons_ext { namespace jsonpath {
+
+// Evaluates a JSONPath expression over parse events, without building the
+// document. Each match is either built into a basic_json and passed to a
+// callback with its normalized path, or forwarded to a downstream input
+// handler as a json text of its own. An output handler instead receives one
+// array per json text, with the matches as its elements, so that a serializer
+// writes valid JSON. Only the containers on the way to a possible match are tracked, one per selector, and everything outside them is
+// skipped by counting depth, so memory is bounded by the path length and
+// the size of the largest match. For that reason expressions with .. or
+// with indices counting from the end of an array are rejected.
+template<typename Char, class Alloc = std::allocator<void>>
+class basic_jsonpath_filter : public jsoncons::basic_json_input_handler<Char>
+{
+public:
+    typedef std::function<void(const std::basic_string<Char>&, jsoncons::basic_json<Char,Alloc>&)> callback_type;
+
+private:
+    struct stack_item
+    {
+        stack_item(bool is_object)
+            : is_object_(is_object), index_(0)
+        {
+        }
+
+        bool is_object_;
+        size_t index_;
+        std::basic_string<Char> name_;
+    };
+
+public:
+    basic_jsonpath_filter(const std::basic_string<Char>& path, callback_type callback)
+        : expr_(compile(path)), callback_(callback), handler_(std::addressof(deserializer_)), output_(nullptr),
+          skip_depth_(0), capture_depth_(0), count_(0)
+    {
+    }
+
+    basic_jsonpath_filter(const std::basic_string<Char>& path, jsoncons::basic_json_input_handler<Char>& handler)
+        : expr_(compile(path)), handler_(std::addressof(handler)), output_(nullptr),
+          skip_depth_(0), capture_depth_(0), count_(0)
+    {
+    }
+
+    basic_jsonpath_filter(const std::basic_string<Char>& path, jsoncons::basic_json_output_handler<Char>& handler)
+        : expr_(compile(path)), input_output_adapter_(handler), handler_(std::addressof(input_output_adapter_)), output_(std::addressof(handler)),
+          skip_depth_(0), capture_depth_(0), count_(0)
+    {
+    }
+
+    // Number of matches in the last json text
+    size_t count() const
+    {
+        return count_;
+    }
+
+private:
+    static basic_jsonpath_expression<Char> compile(const std::basic_string<Char>& path)
+    {
+        basic_jsonpath_expression<Char> expr = basic_jsonpath_expression<Char>::compile(path);
+        if (expr.has_recursive_descent())
+        {
+            JSONCONS_THROW_EXCEPTION_1("Recursive descent is not supported when streaming, in JSONPath %s", path);
+        }
+        if (expr.requires_length())
+        {
+            JSONCONS_THROW_EXCEPTION_1("Indices from the end of an array are not supported when streaming, in JSONPath %s", path);
+        }
+        return expr;
+    }
+
+    virtual void do_begin_json()
+    {
+        stack_.clear();
+        skip_depth_ = 0;
+        capture_depth_ = 0;
+        count_ = 0;
+        if (output_ != nullptr)
+        {
+            output_->begin_json();
+            output_->begin_array();
+        }
+    }
+
+    virtual void do_end_json()
+    {
+        if (output_ != nullptr)
+        {
+            output_->end_array();
+            output_->end_json();
+        }
+    }
+
+    virtual void do_begin_object(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_structure())
+        {
+            handler_->begin_object(context);
+        }
+        else if (skip_depth_ == 0)
+        {
+            stack_.push_back(stack_item(true));
+        }
+    }
+
+    virtual void do_end_object(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (capture_depth_ > 0)
+        {
+            handler_->end_object(context);
+        }
+        end_structure();
+    }
+
+    virtual void do_begin_array(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_structure())
+        {
+            handler_->begin_array(context);
+        }
+        else if (skip_depth_ == 0)
+        {
+            stack_.push_back(stack_item(false));
+        }
+    }
+
+    virtual void do_end_array(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (capture_depth_ > 0)
+        {
+            handler_->end_array(context);
+        }
+        end_structure();
+    }
+
+    virtual void do_name(const Char* p, size_t length, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (capture_depth_ > 0)
+        {
+            handler_->name(p, length, context);
+        }
+        else if (skip_depth_ == 0)
+        {
+            stack_.back().name_.assign(p, length);
+        }
+    }
+
+    virtual void do_null_value(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(jsoncons::null_type(), context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_string_value(const Char* p, size_t length, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(p, length, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_binary_value(const Char* p, size_t length, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->binary(p, length, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_number_value(const Char* p, size_t length, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->number(p, length, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_double_value(double value, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(value, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_longlong_value(long long value, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(value, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_ulonglong_value(unsigned long long value, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(value, context);
+            end_scalar(context);
+        }
+    }
+
+    virtual void do_bool_value(bool value, const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (begin_scalar(context))
+        {
+            handler_->value(value, context);
+            end_scalar(context);
+        }
+    }
+
+    // Whether the value about to start is selected by the last selector,
+    // or, for a container, by the selector at its depth
+    bool selected() const
+    {
+        if (stack_.empty())
+        {
+            return true;
+        }
+        const stack_item& parent = stack_.back();
+        const path_selector<Char>& sel = expr_[stack_.size() - 1];
+        return parent.is_object_
+            ? sel.matches_name(parent.name_.data(), parent.name_.length())
+            : sel.matches_index(parent.index_);
+    }
+
+    // True when the structure is part of a match and its begin event should be forwarded
+    bool begin_structure()
+    {
+        if (capture_depth_ > 0)
+        {
+            ++capture_depth_;
+            return true;
+        }
+        if (skip_depth_ > 0)
+        {
+            ++skip_depth_;
+            return false;
+        }
+        if (!selected())
+        {
+            skip_depth_ = 1;
+            return false;
+        }
+        if (stack_.size() == expr_.size())
+        {
+            begin_match();
+            capture_depth_ = 1;
+            return true;
+        }
+        return false;
+    }
+
+    void end_structure()
+    {
+        if (capture_depth_ > 0)
+        {
+            if (--capture_depth_ == 0)
+            {
+                end_match(false);
+                end_value();
+            }
+        }
+        else if (skip_depth_ > 0)
+        {
+            if (--skip_depth_ == 0)
+            {
+                end_value();
+            }
+        }
+        else
+        {
+            stack_.pop_back();
+            end_value();
+        }
+    }
+
+    // True when the scalar is part of a match and should be forwarded
+    bool begin_scalar(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (capture_depth_ > 0)
+        {
+            return true;
+        }
+        if (skip_depth_ > 0)
+        {
+            return false;
+        }
+        if (stack_.size() == expr_.size() && selected())
+        {
+            begin_match();
+            if (callback_)
+            {
+                // basic_json_deserializer builds containers, so a scalar is 
+                // built as the only element of an array
+                handler_->begin_array(context);
+            }
+            return true;
+        }
+        end_value();
+        return false;
+    }
+
+    void end_scalar(const jsoncons::basic_parsing_context<Char>& context)
+    {
+        if (capture_depth_ == 0)
+        {
+            if (callback_)
+            {
+                handler_->end_array(context);
+            }
+            end_match(true);
+            end_value();
+        }
+    }
+
+    void begin_match()
+    {
+        if (callback_)
+        {
+            path_.clear();
+            path_.push_back('$');
+            for (size_t i = 0; i < stack_.size(); ++i)
+            {
+                append_key(stack_[i]);
+            }
+        }
+        if (output_ == nullptr)
+        {
+            handler_->begin_json();
+        }
+    }
+
+    void end_match(bool scalar)
+    {
+        if (output_ == nullptr)
+        {
+            handler_->end_json();
+        }
+        ++count_;
+        if (callback_)
+        {
+            jsoncons::basic_json<Char,Alloc>& root = deserializer_.root();
+            callback_(path_, scalar ? root[0] : root);
+        }
+    }
+
+    void end_value()
+    {
+        if (!stack_.empty() && !stack_.back().is_object_)
+        {
+            ++stack_.back().index_;
+        }
+    }
+
+    // Normalized path syntax, ['name'] or [index]
+    void append_key(const stack_item& item)
+    {
+        path_.push_back('[');
+        if (item.is_object_)
+        {
+            path_.push_back('\'');
+            for (size_t i = 0; i < item.name_.length(); ++i)
+            {
+                Char c = item.name_[i];
+                if (c == '\'' || c == '\\')
+                {
+                    path_.push_back('\\');
+                }
+                path_.push_back(c);
+            }
+            path_.push_back('\'');
+        }
+        else
+        {
+            Char buf[32];
+            Char* last = buf + 32;
+            Char* first = jsoncons::format_unsigned(static_cast<unsigned long long>(item.index_), last);
+            path_.append(first, last);
+        }
+        path_.push_back(']');
+    }
+
+    basic_jsonpath_expression<Char> expr_;
+    callback_type callback_;
+    jsoncons::basic_json_deserializer<Char,Alloc> deserializer_;
+    jsoncons::basic_json_input_output_adapter<Char> input_output_adapter_;
+    jsoncons::basic_json_input_handler<Char>* handler_;
+    jsoncons::basic_json_output_handler<Char>* output_;
+    std::vector<stack_item> stack_;
+    size_t skip_depth_;
+    size_t capture_depth_;
+    size_t count_;
+    std::basic_string<Char> path_;
+};
+
+typedef basic_jsonpath_filter<char> jsonpath_filter;
+typedef basic_jsonpath_filter<wchar_t> wjsonpath_filter;
+
+}}
+
+#endif
@@ -0,0 +1,172 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://sourceforge.net/projects/jsoncons/files/ for latest version
+// See https://sourceforge.net/p/jsoncons/wiki/Home/ for documentation.
+
+#ifndef JSONCONS_EXT_JSONPOINTER_JSONPOINTER_HPP
+#define JSONCONS_EXT_JSONPOINTER_JSONPOINTER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "jsoncons/jsoncons.hpp"
+#include "jsoncons/json.hpp"
+#include "jsoncons/lru_cache.hpp"
+#include "jsoncons/json_pointer_tokens.hpp"
+
+namespace jsoncons_ext { namespace jsonpointer {
+
+// A JSON Pointer (RFC 6901) compiled for repeated use. Each reference token is
+// unescaped once and kept as a basic_json key, with its hash and the position
+// of the last match, and as an array index if it is one.
+template <class Json>
+class basic_json_pointer
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef typename Json::key key_type;
+
+    // A reference token, unescaped
+    struct token
+    {
+        token(const string_type& name)
+            : key_(name), index_(0), is_index_(false)
+        {
+            is_index_ = jsoncons::json_pointer_index(name, index_);
+        }
+
+        key_type key_;
+        size_t index_;
+        bool is_index_;
+    };
+
+    static basic_json_pointer<Json> compile(const string_type& path)
+    {
+        return compile(path.data(), path.length());
+    }
+
+    static basic_json_pointer<Json> compile(const char_type* p, size_t length)
+    {
+        basic_json_pointer<Json> ptr;
+        std::vector<string_type> names = jsoncons::split_json_pointer(p, length);
+        ptr.text_.assign(p, length);
+        ptr.tokens_.reserve(names.size());
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            ptr.tokens_.push_back(token(names[i]));
+        }
+        return ptr;
+    }
+
+    const string_type& text() const
+    {
+        return text_;
+    }
+
+    // Number of reference tokens
+    size_t size() const
+    {
+        return tokens_.size();
+    }
+
+    const token& operator[](size_t i) const
+    {
+        return tokens_[i];
+    }
+
+    // The value root refers to, or null if there is none
+    Json* find(Json& root) const
+    {
+        return find_in(root);
+    }
+
+    const Json* find(const Json& root) const
+    {
+        return find_in(root);
+    }
+
+    // The value root refers to, throws json_exception if there is none
+    Json& get(Json& root) const
+    {
+        return get_in(root);
+    }
+
+    const Json& get(const Json& root) const
+    {
+        return get_in(root);
+    }
+
+private:
+    template <class J>
+    J* find_in(J& root) const
+    {
+        J* p = std::addressof(root);
+        for (size_t i = 0; i < tokens_.size() && p != nullptr; ++i)
+        {
+            const token& t = tokens_[i];
+            if (p->is_array())
+            {
+                p = t.is_index_ && t.index_ < p->size() ? std::addressof(p->at(t.index_)) : nullptr;
+            }
+            else
+            {
+                p = p->find(t.key_);
+            }
+        }
+        return p;
+    }
+
+    template <class J>
+    J& get_in(J& root) const
+    {
+        typedef char_type Char;
+
+        J* p = find_in(root);
+        if (p == nullptr)
+        {
+            JSONCONS_THROW_EXCEPTION_1("%s not found", text_);
+        }
+        return *p;
+    }
+
+    string_type text_;
+    std::vector<token> tokens_;
+};
+
+// Compiled pointers by text, least recently used dropped first, safe to share between threads
+template <class Json>
+class basic_json_pointer_cache
+{
+public:
+    typedef typename basic_json_pointer<Json>::string_type string_type;
+
+    explicit basic_json_pointer_cache(size_t capacity = 1024)
+        : cache_(capacity)
+    {
+    }
+
+    std::shared_ptr<const basic_json_pointer<Json>> get(const string_type& path)
+    {
+        return cache_.get(path, [&](){return basic_json_pointer<Json>::compile(path);});
+    }
+
+    size_t size() const
+    {
+        return cache_.size();
+    }
+
+private:
+    jsoncons::lru_cache<string_type,basic_json_pointer<Json>> cache_;
+};
+
+typedef basic_json_pointer<jsoncons::json> json_pointer;
+typedef basic_json_pointer<jsoncons::wjson> wjson_pointer;
+typedef basic_json_pointer_cache<jsoncons::json> json_pointer_cache;
+typedef basic_json_pointer_cache<jsoncons::wjson> wjson_pointer_cache;
+
+}}
+
+#endif
@@ -0,0 +1,141 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_filter.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_reader.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+using jsoncons::json_deserializer;
+using jsoncons::json_reader;
+using jsoncons::base64_decoding_filter;
+using jsoncons::base64_encode;
+using jsoncons::base64_decode;
+using jsoncons::base64_encoded_length;
+using jsoncons::base64_decoded_length_bound;
+
+static std::string encode(const std::string& s)
+{
+    std::string result(base64_encoded_length(s.length()), ' ');
+    char* last = base64_encode(s.data(), s.length(), &result[0]);
+    BOOST_CHECK(last == result.data() + result.length());
+    return result;
+}
+
+static bool decode(const std::string& s, std::string& result)
+{
+    result.resize(base64_decoded_length_bound(s.length()));
+    size_t length = 0;
+    bool ok = base64_decode(s.data(), s.length(), &result[0], length);
+    result.resize(length);
+    return ok;
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_encode_decode)
+{
+    // RFC 4648 test vectors
+    const char* plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char* encoded[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    for (size_t i = 0; i < 7; ++i)
+    {
+        BOOST_CHECK_EQUAL(std::string(encoded[i]), encode(plain[i]));
+        std::string decoded;
+        BOOST_CHECK(decode(encoded[i], decoded));
+        BOOST_CHECK_EQUAL(std::string(plain[i]), decoded);
+    }
+
+    // Unpadded input
+    std::string decoded;
+    BOOST_CHECK(decode("Zm9vYg", decoded));
+    BOOST_CHECK_EQUAL(std::string("foob"), decoded);
+
+    // All byte values, through the four group loop
+    std::string bytes;
+    for (int i = 0; i < 256; ++i)
+    {
+        bytes.push_back(static_cast<char>(i));
+    }
+    BOOST_CHECK(decode(encode(bytes), decoded));
+    BOOST_CHECK(bytes == decoded);
+
+    BOOST_CHECK(!decode("Zm9v!mFy", decoded));
+    BOOST_CHECK(!decode("Zm9vY", decoded));
+    BOOST_CHECK(decode("Zm8=", decoded));
+    BOOST_CHECK_EQUAL(std::string("fo"), decoded);
+    BOOST_CHECK(!decode("Zm9vYg=", decoded));
+    BOOST_CHECK(!decode("not base64", decoded));
+}
+
+// Wide text always takes the scalar loops, so it checks the block kernels 
+// used for narrow text when those are compiled in
+BOOST_AUTO_TEST_CASE(test_base64_blocks)
+{
+    std::string bytes;
+    unsigned int seed = 12345;
+    for (size_t length = 0; length <= 200; ++length)
+    {
+        std::string encoded = encode(bytes);
+        std::wstring wide_encoded(base64_encoded_length(bytes.length()), L' ');
+        base64_encode(bytes.data(), bytes.length(), &wide_encoded[0]);
+        BOOST_CHECK(std::wstring(encoded.begin(), encoded.end()) == wide_encoded);
+
+        std::string decoded;
+        BOOST_CHECK(decode(encoded, decoded));
+        BOOST_CHECK(bytes == decoded);
+
+        std::string unpadded = encoded.substr(0, encoded.find('='));
+        BOOST_CHECK(decode(unpadded, decoded));
+        BOOST_CHECK(bytes == decoded);
+
+        // A character outside the alphabet is found wherever it is
+        for (size_t i = 0; i < unpadded.length(); i += 7)
+        {
+            std::string bad = unpadded;
+            bad[i] = i % 2 == 0 ? '-' : '\x80';
+            BOOST_CHECK(!decode(bad, decoded));
+        }
+
+        seed = seed * 1103515245 + 12345;
+        bytes.push_back(static_cast<char>(seed >> 16));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_decoding_filter)
+{
+    std::string blob("\x89PNG\r\n\x1a\n\x00\xff", 10);
+    json original(json::an_object);
+    json items(json::an_array);
+    json item;
+    item.set("name", "thumbnail");
+    item.set("data", json::make_binary(blob.data(), blob.length()));
+    items.add(item);
+    items.add(item);
+    original.set("items", items);
+    original.set("data", "Zm9v");
+
+    std::string text = original.to_string();
+
+    std::vector<std::string> paths;
+    paths.push_back("/items/*/data");
+    paths.push_back("/items/0/name");
+
+    json_deserializer handler;
+    base64_decoding_filter filter(handler, paths);
+    std::istringstream is(text);
+    json_reader reader(is, filter);
+    reader.read();
+    json result = std::move(handler.root());
+
+    BOOST_CHECK(result.at("items").at(0).at("data") == json::make_binary(blob.data(), blob.length()));
+    BOOST_CHECK(result.at("items").at(1).at("data") == json::make_binary(blob.data(), blob.length()));
+    // Not base64, passed on as a string
+    BOOST_CHECK_EQUAL(std::string("thumbnail"), result["items"][0]["name"].as<std::string>());
+    // Not at a listed path
+    BOOST_CHECK_EQUAL(std::string("Zm9v"), result["data"].as<std::string>());
+    BOOST_CHECK_EQUAL(text, result.to_string());
+}
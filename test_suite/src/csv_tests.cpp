@@ -82,3 +82,12 @@ BOOST_AUTO_TEST_CASE(serialize_tab_delimited_file)
 
     employees.to_stream(serializer);
 }
+
+BOOST_AUTO_TEST_CASE(serialize_integers)
+{
+    json val = json::parse_string("[[\"a\",\"b\"],[-9223372036854775807,18446744073709551615],[0,42]]");
+    std::ostringstream os;
+    csv_serializer serializer(os);
+    val.to_stream(serializer);
+    BOOST_CHECK_EQUAL("a,b\n-9223372036854775807,18446744073709551615\n0,42\n", os.str());
+}
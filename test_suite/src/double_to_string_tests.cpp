@@ -143,3 +143,32 @@ BOOST_AUTO_TEST_CASE(test_double_to_wstring)
     BOOST_CHECK(s == std::wstring(L"-11.0"));
 }
 
+
+BOOST_AUTO_TEST_CASE(test_format_float)
+{
+    char buf[64];
+    size_t length = jsoncons::format_float(1.5, 16, buf, sizeof(buf));
+    BOOST_CHECK_EQUAL(std::string("1.5"), std::string(buf, length));
+    length = jsoncons::format_float(-1.0e-100, 16, buf, sizeof(buf));
+    BOOST_CHECK_EQUAL(std::string("-1.0e-100"), std::string(buf, length));
+    BOOST_CHECK_EQUAL(0u, jsoncons::format_float(0.1, 16, buf, 4));
+
+    // The serializer formats doubles on the stack, and falls back to a string past 64 characters
+    json val(json::an_array);
+    val.add(0.1);
+    val.add(123456.789);
+    val.add(-2.5e-300);
+    val.add(1e21);
+    output_format format;
+    BOOST_CHECK_EQUAL(std::string("[0.1,123456.789,-2.5e-300,1.0e+21]"), val.to_string(format));
+    format.precision(17);
+    BOOST_CHECK_EQUAL(std::string("[0.10000000000000001,123456.789,-2.5e-300,1.0e+21]"), val.to_string(format));
+    format.precision(80);
+    std::string expected = "[" + jsoncons::float_to_string<char>(0.1, 80) + "," + jsoncons::float_to_string<char>(123456.789, 80) + "," +
+                           jsoncons::float_to_string<char>(-2.5e-300, 80) + "," + jsoncons::float_to_string<char>(1e21, 80) + "]";
+    BOOST_CHECK(expected.length() > 200);
+    BOOST_CHECK_EQUAL(expected, val.to_string(format));
+
+    wjson wval = wjson::parse_string(L"[0.1,-2.5e-300]");
+    BOOST_CHECK(std::wstring(L"[0.1,-2.5e-300]") == wval.to_string());
+}
@@ -0,0 +1,114 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_aggregator.hpp"
+#include "jsoncons_ext/csv/csv_reader.hpp"
+#include <sstream>
+#include <string>
+
+using jsoncons::json;
+using jsoncons::json_reader;
+using jsoncons::json_aggregator;
+
+BOOST_AUTO_TEST_CASE(test_aggregate_document)
+{
+    std::istringstream is("{\"items\":[{\"price\":2},{\"price\":3.5},{\"price\":\"4\"},{\"price\":\"n/a\"},{\"name\":\"none\"}],\"region\":\"EU\"}");
+    json_aggregator aggregator;
+    size_t count = aggregator.count("/items/*");
+    size_t prices = aggregator.count("/items/*/price");
+    size_t sum = aggregator.sum("/items/*/price");
+    size_t min = aggregator.minimum("/items/*/price");
+    size_t max = aggregator.maximum("/items/*/price");
+    size_t by_region = aggregator.sum("/items/*/price", "/region");
+    size_t missing = aggregator.maximum("/nothing");
+
+    json_reader reader(is, aggregator);
+    reader.read();
+
+    BOOST_CHECK_EQUAL(5, aggregator.result(count).as<int>());
+    BOOST_CHECK_EQUAL(4, aggregator.result(prices).as<int>());
+    BOOST_CHECK_CLOSE(9.5, aggregator.result(sum).as<double>(), 0.0001);
+    BOOST_CHECK_EQUAL(2, aggregator.result(min).as<int>());
+    BOOST_CHECK(aggregator.result(min).is_longlong());
+    BOOST_CHECK_EQUAL(4, aggregator.result(max).as<int>());
+    json grouped = aggregator.result(by_region);
+    BOOST_REQUIRE(grouped.is_object());
+    BOOST_CHECK_EQUAL(1, grouped.size());
+    BOOST_CHECK_CLOSE(9.5, grouped["EU"].as<double>(), 0.0001);
+    BOOST_CHECK(aggregator.result(missing).is_null());
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_records_grouped)
+{
+    // The group key comes after the values in some records
+    std::istringstream is("[{\"region\":\"EU\",\"amount\":10},{\"amount\":5,\"region\":\"US\"},{\"region\":\"EU\",\"amount\":7},"
+                          "{\"amount\":100},{\"region\":1,\"amount\":1},{\"region\":\"US\",\"amount\":-5}]");
+    json_aggregator aggregator("/*");
+    size_t records = aggregator.count("");
+    size_t total = aggregator.sum("/amount");
+    size_t sums = aggregator.sum("/amount", "/region");
+    size_t counts = aggregator.count("", "/region");
+    size_t lows = aggregator.minimum("/amount", "/region");
+
+    json_reader reader(is, aggregator);
+    reader.read();
+
+    BOOST_CHECK_EQUAL(6, aggregator.result(records).as<int>());
+    BOOST_CHECK_EQUAL(118, aggregator.result(total).as<int>());
+
+    json s = aggregator.result(sums);
+    BOOST_CHECK_EQUAL(3, s.size());
+    BOOST_CHECK_EQUAL(17, s["EU"].as<int>());
+    BOOST_CHECK_EQUAL(0, s["US"].as<int>());
+    BOOST_CHECK_EQUAL(1, s["1"].as<int>());
+
+    json c = aggregator.result(counts);
+    BOOST_CHECK_EQUAL(2, c["EU"].as<int>());
+    BOOST_CHECK_EQUAL(2, c["US"].as<int>());
+
+    json low = aggregator.result(lows);
+    BOOST_CHECK_EQUAL(7, low["EU"].as<int>());
+    BOOST_CHECK_EQUAL(-5, low["US"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_csv)
+{
+    std::istringstream is("region,amount\nEU,1.5\nUS,2\nEU,3\n");
+    json_aggregator aggregator("/*");
+    size_t sums = aggregator.sum("/amount", "/region");
+    size_t max = aggregator.maximum("/amount");
+
+    json params;
+    params["has_header"] = true;
+    jsoncons_ext::csv::csv_reader reader(is, aggregator, params);
+    reader.read();
+
+    json s = aggregator.result(sums);
+    BOOST_CHECK_CLOSE(4.5, s["EU"].as<double>(), 0.0001);
+    BOOST_CHECK_EQUAL(2, s["US"].as<int>());
+    BOOST_CHECK_EQUAL(3, aggregator.result(max).as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_max_groups)
+{
+    std::istringstream is("[{\"k\":\"a\"},{\"k\":\"b\"},{\"k\":\"c\"}]");
+    json_aggregator aggregator("/*");
+    aggregator.count("", "/k");
+    aggregator.max_groups(2);
+    json_reader reader(is, aggregator);
+    BOOST_CHECK_THROW(reader.read(), jsoncons::json_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_sum_overflow)
+{
+    std::istringstream is("[9223372036854775807,1,0.5]");
+    json_aggregator aggregator;
+    size_t sum = aggregator.sum("/*");
+    json_reader reader(is, aggregator);
+    reader.read();
+    BOOST_CHECK(aggregator.result(sum).is<double>());
+    BOOST_CHECK_CLOSE(9223372036854775808.5, aggregator.result(sum).as<double>(), 0.0001);
+}
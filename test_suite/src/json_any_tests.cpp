@@ -135,3 +135,44 @@ BOOST_AUTO_TEST_CASE(test_any_add_custom_data)
     std::cout << pretty_print(arr) << std::endl;
 }
 
+
+struct small_timestamp
+{
+    long long seconds;
+    int nanoseconds;
+};
+
+BOOST_AUTO_TEST_CASE(test_any_small_value)
+{
+    small_timestamp ts = {1420070400,5};
+    json::any a(ts);
+
+    const char* begin = reinterpret_cast<const char*>(&a);
+    const char* content = reinterpret_cast<const char*>(a.content_);
+    BOOST_CHECK(content >= begin && content < begin + sizeof(a));
+
+    json::any b(a);
+    content = reinterpret_cast<const char*>(b.content_);
+    begin = reinterpret_cast<const char*>(&b);
+    BOOST_CHECK(content >= begin && content < begin + sizeof(b));
+    BOOST_CHECK_EQUAL(1420070400, b.cast<small_timestamp>().seconds);
+
+    b.cast<small_timestamp>().nanoseconds = 7;
+    BOOST_CHECK_EQUAL(5, a.cast<small_timestamp>().nanoseconds);
+
+    json::any c(std::move(b));
+    BOOST_CHECK_EQUAL(7, c.cast<small_timestamp>().nanoseconds);
+
+    json::any d(std::string("not small"));
+    d = c;
+    BOOST_CHECK_EQUAL(7, d.cast<small_timestamp>().nanoseconds);
+
+    json::any e(std::string("on the heap"));
+    d = e;
+    BOOST_CHECK_EQUAL(std::string("on the heap"), d.cast<std::string>());
+
+    json obj;
+    obj.set("timestamp", json::any(ts));
+    json copy = obj;
+    BOOST_CHECK_EQUAL(5, copy["timestamp"].any_value().cast<small_timestamp>().nanoseconds);
+}
@@ -5,10 +5,13 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include "jsoncons/json.hpp"
 #include "jsoncons/json_serializer.hpp"
+#include "jsoncons_ext/cbor/cbor_serializer.hpp"
+#include "jsoncons_ext/cbor/cbor_reader.hpp"
 #include <sstream>
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <future>
 
 using jsoncons::pretty_print;
 using jsoncons::output_format;
@@ -168,3 +171,111 @@ BOOST_AUTO_TEST_CASE(test_assign_vector)
 
 }
 
+
+BOOST_AUTO_TEST_CASE(test_contiguous_numeric_array)
+{
+    json a = json::parse_string("[1.5,2.5,-3.25]");
+    BOOST_CHECK(a.is_array());
+    BOOST_CHECK_EQUAL(3, a.size());
+
+    std::vector<double> v = a.as_vector<double>();
+    BOOST_CHECK_EQUAL(3, v.size());
+    BOOST_CHECK_EQUAL(-3.25, v[2]);
+
+    std::vector<long long> w = a.as<std::vector<long long>>();
+    BOOST_CHECK_EQUAL(2, w[1]);
+
+    json b(json::an_array);
+    b.add(1.5);
+    b.add(2.5);
+    b.add(-3.25);
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(b.to_string(), a.to_string());
+
+    const json& c = a;
+    BOOST_CHECK_EQUAL(2.5, c[1].as<double>());
+    BOOST_CHECK(c[1].is<double>());
+
+    json d = a;
+    BOOST_CHECK(d == a);
+    d.add("x");
+    BOOST_CHECK_EQUAL(4, d.size());
+    BOOST_CHECK_EQUAL(std::string("x"), d[3].as<std::string>());
+    BOOST_CHECK_EQUAL(3, a.size());
+
+    json e = json::parse_string("[1,-2,3]");
+    BOOST_CHECK(e[0].is<unsigned long long>());
+    BOOST_CHECK(e[1].is<long long>());
+    BOOST_CHECK_EQUAL(std::string("[1,-2,3]"), e.to_string());
+
+    json f = json::parse_string("{\"values\":[10,20,30]}");
+    std::vector<unsigned long long> u = f["values"].as_vector<unsigned long long>();
+    BOOST_CHECK_EQUAL(30, u[2]);
+    f["values"][0] = 5;
+    BOOST_CHECK_EQUAL(std::string("{\"values\":[5,20,30]}"), f.to_string());
+
+    json g = json::parse_string("[10,20,30]");
+    std::ostringstream os;
+    jsoncons_ext::cbor::cbor_serializer serializer(os);
+    g.to_stream(serializer);
+    std::string bytes = os.str();
+    BOOST_CHECK_EQUAL(0x83, static_cast<unsigned char>(bytes[0]));
+
+    std::istringstream is(bytes);
+    jsoncons::json_deserializer handler;
+    jsoncons_ext::cbor::cbor_reader reader(is, handler);
+    reader.read();
+    BOOST_CHECK(handler.root() == g);
+}
+
+BOOST_AUTO_TEST_CASE(test_contiguous_numbers_after_const_access)
+{
+    typedef jsoncons::json_array_impl<char,std::allocator<void>> array_impl;
+
+    json a = json::parse_string("[1.5,2.5,-3.25,4.0,5.0,6.0,7.0,8.0]");
+    json b = a;
+    json general(json::an_array);
+    general.reserve(8);
+    general.add(1.5);
+    general.add(2.5);
+    general.add(-3.25);
+    for (int i = 4; i <= 8; ++i)
+    {
+        general.add(static_cast<double>(i));
+    }
+
+    // Comparing and hashing read the numbers in place
+    BOOST_CHECK(a == general);
+    BOOST_CHECK(general == a);
+    BOOST_CHECK_EQUAL(a.hash(), general.hash());
+    BOOST_CHECK(a.memory_usage().arrays < general.memory_usage().arrays);
+
+    // Const element access converts to elements and releases the numbers
+    const json& c = a;
+    BOOST_CHECK_EQUAL(2.5, c[1].as<double>());
+    BOOST_CHECK_EQUAL(sizeof(array_impl) + 8*sizeof(json), a.memory_usage().arrays);
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(b.to_string(), a.to_string());
+    BOOST_CHECK_EQUAL(-3.25, a.as_vector<double>()[2]);
+
+    // Concurrent const readers, one of which converts the array
+    std::vector<std::future<double>> futures;
+    for (int i = 0; i < 4; ++i)
+    {
+        futures.push_back(std::async(std::launch::async, [&b,i]()
+        {
+            const json& r = b;
+            double sum = 0;
+            for (int k = 0; k < 100; ++k)
+            {
+                sum += (i % 2 == 0) ? r[k % 3].as<double>() : static_cast<double>(r.size() + r.hash() % 2);
+            }
+            return sum;
+        }));
+    }
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].get();
+    }
+    BOOST_CHECK(b == general);
+}
@@ -0,0 +1,164 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_canonical_serializer.hpp"
+#include <sstream>
+#include <string>
+#include <limits>
+#include <clocale>
+
+using jsoncons::json;
+using jsoncons::wjson;
+using jsoncons::xxhash64;
+using jsoncons::to_canonical_string;
+using jsoncons::canonical_hash;
+
+BOOST_AUTO_TEST_CASE(test_xxhash64)
+{
+    BOOST_CHECK_EQUAL(0xef46db3751d8e999ULL, xxhash64().digest());
+
+    xxhash64 h;
+    h.update("abc", 3);
+    BOOST_CHECK_EQUAL(0x44bc2cf5ad770999ULL, h.digest());
+
+    xxhash64 seeded(7);
+    seeded.update("abc", 3);
+    BOOST_CHECK_EQUAL(0x9e755206156676d7ULL, seeded.digest());
+
+    unsigned char data[100];
+    for (size_t i = 0; i < 100; ++i)
+    {
+        data[i] = static_cast<unsigned char>(i);
+    }
+    xxhash64 whole;
+    whole.update(data, 100);
+    BOOST_CHECK_EQUAL(0x6ac1e58032166597ULL, whole.digest());
+
+    xxhash64 pieces;
+    pieces.update(data, 5);
+    pieces.update(data + 5, 40);
+    pieces.update(data + 45, 55);
+    BOOST_CHECK_EQUAL(whole.digest(), pieces.digest());
+}
+
+BOOST_AUTO_TEST_CASE(test_canonical_form)
+{
+    json val = json::parse_string("{ \"b\" : [1, 2.50, true, null], \"a\" : \"x\\u0001\\/\\u007f\\u00e9\\n\" }");
+    BOOST_CHECK_EQUAL(std::string("{\"a\":\"x\\u0001/\x7f\xc3\xa9\\n\",\"b\":[1,2.5,true,null]}"), to_canonical_string(val));
+
+    json empty = json::parse_string("{\"a\":{},\"b\":[]}");
+    BOOST_CHECK_EQUAL(std::string("{\"a\":{},\"b\":[]}"), to_canonical_string(empty));
+}
+
+BOOST_AUTO_TEST_CASE(test_canonical_numbers)
+{
+    // Number serialization samples from RFC 8785
+    BOOST_CHECK_EQUAL(std::string("0"), to_canonical_string(json(-0.0)));
+    BOOST_CHECK_EQUAL(std::string("5e-324"), to_canonical_string(json(4.9406564584124654e-324)));
+    BOOST_CHECK_EQUAL(std::string("1.7976931348623157e+308"), to_canonical_string(json(1.7976931348623157e308)));
+    BOOST_CHECK_EQUAL(std::string("9007199254740992"), to_canonical_string(json(9007199254740992.0)));
+    BOOST_CHECK_EQUAL(std::string("1e+23"), to_canonical_string(json(1e23)));
+    BOOST_CHECK_EQUAL(std::string("295147905179352830000"), to_canonical_string(json(295147905179352825856.0)));
+    BOOST_CHECK_EQUAL(std::string("333333333.3333333"), to_canonical_string(json(333333333.33333329)));
+    BOOST_CHECK_EQUAL(std::string("0.000001"), to_canonical_string(json(0.000001)));
+    BOOST_CHECK_EQUAL(std::string("1e-7"), to_canonical_string(json(0.0000001)));
+    BOOST_CHECK_EQUAL(std::string("-1.5"), to_canonical_string(json(-1.5)));
+    BOOST_CHECK_EQUAL(std::string("0.1"), to_canonical_string(json(0.1)));
+
+    // Integers go through their double value
+    BOOST_CHECK_EQUAL(std::string("[-42,18446744073709552000]"), to_canonical_string(json::parse_string("[-42,18446744073709551615]")));
+
+    BOOST_CHECK_THROW(to_canonical_string(json(std::numeric_limits<double>::infinity())), jsoncons::json_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_canonical_member_order)
+{
+    // Sorting sample from RFC 8785, names above U+FFFF sort before U+E000 to U+FFFF
+    json val = json::parse_string("{\"\\u20ac\":1,\"\\r\":2,\"\\ufb33\":3,\"1\":4,\"\\ud83d\\ude00\":5,\"\\u0080\":6,\"\\u00f6\":7}");
+    BOOST_CHECK_EQUAL(std::string("{\"\\r\":2,\"1\":4,\"\xc2\x80\":6,\"\xc3\xb6\":7,\"\xe2\x82\xac\":1,\"\xf0\x9f\x98\x80\":5,\"\xef\xac\xb3\":3}"), 
+                      to_canonical_string(val));
+
+    json mixed = json::parse_string("{\"\\ue000\":1,\"\\ud800\\udc00\":2,\"\\uffff\":3,\"\\udbff\\udfff\":4,\"a\":5}");
+    BOOST_CHECK_EQUAL(std::string("{\"a\":5,\"\xf0\x90\x80\x80\":2,\"\xf4\x8f\xbf\xbf\":4,\"\xee\x80\x80\":1,\"\xef\xbf\xbf\":3}"), 
+                      to_canonical_string(mixed));
+
+    wjson wide;
+    wide.set(std::wstring(1, static_cast<wchar_t>(0xe000)), 1);
+    wide.set(sizeof(wchar_t) == 2 ? std::wstring(L"\xd83d\xde00") : std::wstring(1, static_cast<wchar_t>(0x1f600)), 2);
+    std::wstring s = to_canonical_string(wide);
+    BOOST_CHECK(s.find(static_cast<wchar_t>(0xe000)) > s.find(L":2"));
+
+    // Members are written as they arrive, those with U+E000 to U+FFFF in their names are held
+    std::string text;
+    jsoncons::string_sink sink(text);
+    {
+        jsoncons::json_canonical_serializer serializer(sink);
+        serializer.begin_object();
+        serializer.name("a", 1);
+        serializer.begin_array();
+        serializer.begin_object();
+        serializer.name("x", 1);
+        serializer.value("two");
+        serializer.name("y", 1);
+        serializer.value(1.0);
+        serializer.end_object();
+        serializer.end_array();
+        serializer.name("\xee\x80\x80", 3);
+        serializer.begin_object();
+        serializer.name("k", 1);
+        serializer.value(true);
+        serializer.name("\xef\xbf\xbf", 3);
+        serializer.value(1);
+        serializer.name("\xf0\x90\x80\x80", 4);
+        serializer.value(2);
+        serializer.end_object();
+        serializer.name("\xf0\x90\x80\x80", 4);
+        serializer.value(jsoncons::null_type());
+        serializer.end_object();
+    }
+    BOOST_CHECK_EQUAL(std::string("{\"a\":[{\"x\":\"two\",\"y\":1}],\"\xf0\x90\x80\x80\":null,"
+                                  "\"\xee\x80\x80\":{\"k\":true,\"\xf0\x90\x80\x80\":2,\"\xef\xbf\xbf\":1}}"), text);
+
+    std::string unordered;
+    jsoncons::string_sink unordered_sink(unordered);
+    jsoncons::json_canonical_serializer serializer(unordered_sink);
+    serializer.begin_object();
+    serializer.name("b", 1);
+    serializer.value(1);
+    BOOST_CHECK_THROW(serializer.name("a", 1), jsoncons::json_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_canonical_numbers_locale)
+{
+    const char* names[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German"};
+    std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    bool found = false;
+    for (size_t i = 0; !found && i < 4; ++i)
+    {
+        found = std::setlocale(LC_NUMERIC, names[i]) != nullptr;
+    }
+    BOOST_CHECK_EQUAL(std::string("[0.1,333333333.3333333,1.5e-7,1e+23]"), 
+                      to_canonical_string(json::parse_string("[0.1,333333333.33333329,1.5e-7,1e23]")));
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_canonical_hash)
+{
+    json a = json::parse_string("{\"b\":[1,2.0],\"a\":\"text\"}");
+    json b = json::parse_string("{ \"a\" : \"text\", \"b\" : [ 1.0, 2 ] }");
+    json c = json::parse_string("{\"a\":\"text\",\"b\":[1,3]}");
+
+    BOOST_CHECK_EQUAL(canonical_hash(a), canonical_hash(b));
+    BOOST_CHECK(canonical_hash(a) != canonical_hash(c));
+    BOOST_CHECK(canonical_hash(a) != canonical_hash(a, 1));
+
+    std::string s = to_canonical_string(a);
+    xxhash64 h;
+    h.update(s.data(), s.length());
+    BOOST_CHECK_EQUAL(h.digest(), canonical_hash(a));
+
+    wjson w = wjson::parse_string(L"{\"b\":[1,2.0],\"a\":\"text\"}");
+    BOOST_CHECK(std::wstring(L"{\"a\":\"text\",\"b\":[1,2]}") == to_canonical_string(w));
+}
@@ -0,0 +1,126 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_cursor.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+using jsoncons::json_cursor;
+namespace json_event_type = jsoncons::json_event_type;
+
+BOOST_AUTO_TEST_CASE(test_cursor_events)
+{
+    std::istringstream is("{\"a\":1,\"b\":[\"x\",-2,2.5,true,null]}");
+    json_cursor cursor(is);
+
+    BOOST_CHECK_EQUAL(json_event_type::begin_object, cursor.next());
+    BOOST_CHECK_EQUAL(1, cursor.depth());
+    BOOST_CHECK_EQUAL(json_event_type::name, cursor.next());
+    BOOST_CHECK_EQUAL("a", cursor.string_value());
+    BOOST_CHECK_EQUAL(json_event_type::ulonglong_value, cursor.next());
+    BOOST_CHECK_EQUAL(1, cursor.as_longlong());
+    BOOST_CHECK_EQUAL(json_event_type::name, cursor.next());
+    BOOST_CHECK_EQUAL("b", cursor.string_value());
+    BOOST_CHECK_EQUAL(json_event_type::begin_array, cursor.next());
+    BOOST_CHECK_EQUAL(2, cursor.depth());
+    BOOST_CHECK_EQUAL(json_event_type::string_value, cursor.next());
+    BOOST_CHECK_EQUAL("x", cursor.string_value());
+    BOOST_CHECK_EQUAL(json_event_type::longlong_value, cursor.next());
+    BOOST_CHECK_EQUAL(-2, cursor.as_longlong());
+    BOOST_CHECK_EQUAL(json_event_type::double_value, cursor.next());
+    BOOST_CHECK_CLOSE(2.5, cursor.as_double(), 0.0001);
+    BOOST_CHECK_EQUAL(json_event_type::bool_value, cursor.next());
+    BOOST_CHECK(cursor.as_bool());
+    BOOST_CHECK_EQUAL(json_event_type::null_value, cursor.next());
+    BOOST_CHECK_EQUAL(json_event_type::end_array, cursor.next());
+    BOOST_CHECK_EQUAL(json_event_type::end_object, cursor.next());
+    BOOST_CHECK_EQUAL(0, cursor.depth());
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+    BOOST_CHECK(cursor.done());
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_skip)
+{
+    std::istringstream is("{\"skip\":{\"s\":\"}]\\\"{\",\"n\":[1,[2,{}]]},\"keep\":7,\"also\":[8,9],\"last\":true}");
+    json_cursor cursor(is);
+    cursor.reader().buffer_capacity(16);
+
+    std::vector<std::string> names;
+    BOOST_CHECK_EQUAL(json_event_type::begin_object, cursor.next());
+    while (cursor.next() == json_event_type::name)
+    {
+        names.push_back(cursor.string_value());
+        if (names.back() == "keep")
+        {
+            BOOST_CHECK_EQUAL(json_event_type::ulonglong_value, cursor.next());
+            BOOST_CHECK_EQUAL(7, cursor.as_longlong());
+        }
+        else
+        {
+            cursor.skip();
+        }
+    }
+    BOOST_CHECK_EQUAL(json_event_type::end_object, cursor.event());
+    BOOST_REQUIRE_EQUAL(4, names.size());
+    BOOST_CHECK_EQUAL("also", names[2]);
+    BOOST_CHECK_EQUAL("last", names[3]);
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_skip_top_level)
+{
+    std::istringstream is("[1,[2,3],{\"a\":[]}]");
+    json_cursor cursor(is);
+    BOOST_CHECK_EQUAL(json_event_type::begin_array, cursor.next());
+    cursor.skip();
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_read_to)
+{
+    std::istringstream is("{\"header\":{\"v\":1},\"rows\":[{\"id\":1,\"tags\":[\"a\",\"b\"]},{\"id\":2,\"tags\":[]},\"three\"]}");
+    json_cursor cursor(is);
+
+    BOOST_CHECK_EQUAL(json_event_type::begin_object, cursor.next());
+    BOOST_CHECK_EQUAL(json_event_type::name, cursor.next());
+    cursor.skip();
+    BOOST_CHECK_EQUAL(json_event_type::name, cursor.next());
+    BOOST_CHECK_EQUAL("rows", cursor.string_value());
+    BOOST_CHECK_EQUAL(json_event_type::begin_array, cursor.next());
+
+    std::vector<json> rows;
+    while (cursor.next() != json_event_type::end_array)
+    {
+        json row;
+        cursor.read_to(row);
+        rows.push_back(std::move(row));
+    }
+    BOOST_REQUIRE_EQUAL(3, rows.size());
+    BOOST_CHECK_EQUAL(1, rows[0]["id"].as<int>());
+    BOOST_CHECK_EQUAL("b", rows[0]["tags"][1].as<std::string>());
+    BOOST_CHECK_EQUAL(0, rows[1]["tags"].size());
+    BOOST_CHECK_EQUAL("three", rows[2].as<std::string>());
+    BOOST_CHECK_EQUAL(1, cursor.depth());
+
+    BOOST_CHECK_EQUAL(json_event_type::end_object, cursor.next());
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_read_to_top_level)
+{
+    std::istringstream is("[{\"a\":1},2]");
+    json_cursor cursor(is);
+    BOOST_CHECK_EQUAL(json_event_type::begin_array, cursor.next());
+    json val;
+    cursor.read_to(val);
+    BOOST_REQUIRE(val.is_array());
+    BOOST_CHECK_EQUAL(2, val.size());
+    BOOST_CHECK_EQUAL(1, val[0]["a"].as<int>());
+    BOOST_CHECK_EQUAL(json_event_type::end_json, cursor.next());
+}
@@ -0,0 +1,120 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_element_reader.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+using jsoncons::json_element_reader;
+
+BOOST_AUTO_TEST_CASE(test_element_reader_top_level)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        if (i > 0)
+        {
+            os << ",";
+        }
+        os << "{\"id\":" << i << ",\"values\":[" << i << "," << i + 1 << "],\"name\":\"" << std::string(i % 50, 'x') << "\"}";
+    }
+    os << "]";
+
+    std::istringstream is(os.str());
+    json_element_reader reader(is);
+    reader.reader().buffer_capacity(256);
+    size_t n = 0;
+    while (reader.next())
+    {
+        json& element = reader.value();
+        BOOST_REQUIRE(element.is_object());
+        BOOST_CHECK_EQUAL(n, element["id"].as<size_t>());
+        BOOST_CHECK_EQUAL(n + 1, element["values"][1].as<size_t>());
+        ++n;
+    }
+    BOOST_CHECK_EQUAL(5000, n);
+    BOOST_CHECK_EQUAL(5000, reader.count());
+    BOOST_CHECK(!reader.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_element_reader_path)
+{
+    std::istringstream is("{\"meta\":{\"items\":[9]},\"data\":{\"rows\":[1,\"two\",[3],{\"four\":4},null,true]},\"after\":[0]}");
+    json_element_reader reader(is, "/data/rows");
+    std::vector<json> elements;
+    for (json& element : reader)
+    {
+        elements.push_back(std::move(element));
+    }
+    BOOST_REQUIRE_EQUAL(6, elements.size());
+    BOOST_CHECK_EQUAL(1, elements[0].as<int>());
+    BOOST_CHECK_EQUAL("two", elements[1].as<std::string>());
+    BOOST_CHECK_EQUAL(3, elements[2][0].as<int>());
+    BOOST_CHECK_EQUAL(4, elements[3]["four"].as<int>());
+    BOOST_CHECK(elements[4].is_null());
+    BOOST_CHECK(elements[5].as<bool>());
+}
+
+BOOST_AUTO_TEST_CASE(test_element_reader_nested_index)
+{
+    std::istringstream is("[[1,2],[3,4,5]]");
+    json_element_reader reader(is, "/1");
+    int sum = 0;
+    while (reader.next())
+    {
+        sum += reader.value().as<int>();
+    }
+    BOOST_CHECK_EQUAL(12, sum);
+}
+
+BOOST_AUTO_TEST_CASE(test_element_reader_no_array)
+{
+    std::istringstream is1("{\"a\":1}");
+    json_element_reader reader1(is1, "/b");
+    BOOST_CHECK(!reader1.next());
+
+    std::istringstream is2("[]");
+    json_element_reader reader2(is2);
+    BOOST_CHECK(reader2.begin() == reader2.end());
+
+    std::istringstream is3("[1,2");
+    json_element_reader reader3(is3);
+    BOOST_CHECK(reader3.next());
+    BOOST_CHECK_THROW(while (reader3.next()) {}, jsoncons::json_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_reader_pause)
+{
+    struct pausing_handler : public jsoncons::empty_basic_json_input_handler<char>
+    {
+        pausing_handler() : reader(nullptr), values(0) {}
+
+        jsoncons::json_reader* reader;
+        size_t values;
+    private:
+        virtual void do_ulonglong_value(unsigned long long, const jsoncons::parsing_context&)
+        {
+            ++values;
+            reader->pause();
+        }
+    };
+
+    std::istringstream is("[1,2,3]");
+    pausing_handler handler;
+    jsoncons::json_reader reader(is, handler);
+    handler.reader = &reader;
+    reader.read();
+    BOOST_CHECK(reader.paused());
+    BOOST_CHECK_EQUAL(1, handler.values);
+    reader.resume();
+    reader.resume();
+    BOOST_CHECK_EQUAL(3, handler.values);
+    reader.resume();
+    BOOST_CHECK(!reader.paused());
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <unordered_set>
 
 using jsoncons::pretty_print;
 using jsoncons::json;
@@ -19,3 +20,81 @@ BOOST_AUTO_TEST_CASE(test_equals)
 {
 }
 
+
+BOOST_AUTO_TEST_CASE(test_structural_hash)
+{
+    json a = json::parse_string("{\"a\":1,\"b\":[true,null,\"x\"],\"c\":{\"d\":2.5}}");
+    json b;
+    b["c"] = json::parse_string("{\"d\":2.5}");
+    b["b"] = json::parse_string("[true,null,\"x\"]");
+    b["a"] = 1;
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+
+    BOOST_CHECK_EQUAL(json(3).hash(), json(3u).hash());
+    BOOST_CHECK_EQUAL(json(3).hash(), json(3.0).hash());
+
+    size_t h = b.hash();
+    b.set("a", 2);
+    BOOST_CHECK(h != b.hash());
+    BOOST_CHECK(a != b);
+
+    std::unordered_set<json> set;
+    set.insert(a);
+    set.insert(b);
+    set.insert(json::parse_string("{\"c\":{\"d\":2.5},\"a\":1,\"b\":[true,null,\"x\"]}"));
+    BOOST_CHECK_EQUAL(2, set.size());
+
+    std::vector<double> v(10000);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        v[i] = static_cast<double>(i) + 0.5;
+    }
+    std::ostringstream os;
+    os << '[';
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        os << (i > 0 ? "," : "") << i << ".5";
+    }
+    os << ']';
+    json typed = json::parse_string(os.str());
+    json general(json::an_array);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        general.add(v[i]);
+    }
+    BOOST_CHECK_EQUAL(typed.hash(), general.hash());
+    BOOST_CHECK_EQUAL(typed.hash(), typed.parallel_hash(4));
+    BOOST_CHECK(typed.parallel_equals(general, 4));
+    general[9999] = -1.0;
+    BOOST_CHECK(!general.parallel_equals(typed, 4));
+}
+
+BOOST_AUTO_TEST_CASE(test_equals_after_nested_change)
+{
+    json a = json::parse_string("{\"k\":{\"v\":[1,2]},\"w\":true}");
+    json b = json::parse_string("{\"k\":{\"v\":[1,3]},\"w\":true}");
+    json& v = a.at("k").at("v");
+    BOOST_CHECK(a.hash() != b.hash());
+    BOOST_CHECK(a != b);
+
+    // Changed through a reference taken before the hashes were computed
+    v[1] = 3;
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a.parallel_equals(b, 4));
+    BOOST_CHECK(a.at("k") == b.at("k"));
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+    BOOST_CHECK_EQUAL(a.parallel_hash(4), b.parallel_hash(4));
+}
+
+BOOST_AUTO_TEST_CASE(test_hash_after_change_in_nested_object)
+{
+    json a = json::parse_string("{\"k\":[{\"x\":1}]}");
+    json b = json::parse_string("{\"k\":[{\"x\":2}]}");
+    json& x = a.at("k")[0].at("x");
+    BOOST_CHECK(a.hash() != b.hash());
+
+    x = 2;
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(a.hash(), b.hash());
+}
@@ -0,0 +1,139 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_serializer.hpp"
+#include "jsoncons/json_filter.hpp"
+#include "jsoncons/json_event_tape.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <limits>
+
+using jsoncons::json;
+using jsoncons::wjson;
+using jsoncons::json_deserializer;
+using jsoncons::json_reader;
+using jsoncons::json_event_tape;
+using jsoncons::json_tape_recorder;
+using jsoncons::json_input_handler;
+
+BOOST_AUTO_TEST_CASE(test_tape_round_trip)
+{
+    std::string text = "{\"name\":\"widget\",\"tags\":[\"a\",\"\",\"\\u00e9\"],\"n\":[0,-1,127,-9223372036854775808,18446744073709551615],"
+                       "\"x\":2.5,\"ok\":true,\"no\":false,\"none\":null,\"empty\":{}}";
+    std::istringstream is(text);
+    json_event_tape tape;
+    json_tape_recorder recorder(tape);
+    json_reader reader(is, recorder);
+    reader.read();
+
+    BOOST_CHECK(!tape.empty());
+    BOOST_CHECK(tape.size() < text.length());
+
+    json_deserializer deserializer;
+    tape.replay(deserializer);
+    json expected = json::parse_string(text);
+    BOOST_CHECK(expected == deserializer.root());
+    BOOST_CHECK_EQUAL(std::numeric_limits<long long>::min(), deserializer.root()["n"][3].as<long long>());
+    BOOST_CHECK_EQUAL(std::numeric_limits<unsigned long long>::max(), deserializer.root()["n"][4].as<unsigned long long>());
+}
+
+BOOST_AUTO_TEST_CASE(test_tape_fan_out)
+{
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        if (i > 0)
+        {
+            os << ",";
+        }
+        os << "{\"id\":" << i << ",\"name\":\"item" << i << "\",\"price\":" << i * 0.5 << "}";
+    }
+    os << "]";
+    std::istringstream is(os.str());
+    json_event_tape tape;
+    json_tape_recorder recorder(tape);
+    json_reader reader(is, recorder);
+    reader.read();
+    json expected = json::parse_string(os.str());
+
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+        json_deserializer d1;
+        json_deserializer d2;
+        std::ostringstream out;
+        jsoncons::json_serializer serializer(out);
+        jsoncons::basic_json_input_output_adapter<char> adapter(serializer);
+
+        std::vector<json_input_handler*> handlers;
+        handlers.push_back(&d1);
+        handlers.push_back(&d2);
+        handlers.push_back(&adapter);
+        tape.replay(handlers, parallel != 0);
+
+        BOOST_CHECK(expected == d1.root());
+        BOOST_CHECK(expected == d2.root());
+        BOOST_CHECK(expected == json::parse_string(out.str()));
+    }
+}
+
+namespace {
+
+class throwing_handler : public jsoncons::json_input_handler
+{
+    virtual void do_begin_json() {}
+    virtual void do_end_json() {}
+    virtual void do_begin_object(const jsoncons::parsing_context&) {}
+    virtual void do_end_object(const jsoncons::parsing_context&) {}
+    virtual void do_begin_array(const jsoncons::parsing_context&) {}
+    virtual void do_end_array(const jsoncons::parsing_context&) {}
+    virtual void do_name(const char*, size_t, const jsoncons::parsing_context&) {}
+    virtual void do_null_value(const jsoncons::parsing_context&) {}
+    virtual void do_string_value(const char*, size_t, const jsoncons::parsing_context&) {}
+    virtual void do_binary_value(const char*, size_t, const jsoncons::parsing_context&) {}
+    virtual void do_double_value(double, const jsoncons::parsing_context&) {}
+    virtual void do_longlong_value(long long, const jsoncons::parsing_context&) {}
+    virtual void do_ulonglong_value(unsigned long long, const jsoncons::parsing_context&)
+    {
+        throw std::runtime_error("stop");
+    }
+    virtual void do_bool_value(bool, const jsoncons::parsing_context&) {}
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_tape_parallel_exception)
+{
+    std::istringstream is("[\"a\",1]");
+    json_event_tape tape;
+    json_tape_recorder recorder(tape);
+    json_reader reader(is, recorder);
+    reader.read();
+
+    json_deserializer deserializer;
+    throwing_handler thrower;
+    std::vector<json_input_handler*> handlers;
+    handlers.push_back(&deserializer);
+    handlers.push_back(&thrower);
+    BOOST_CHECK_THROW(tape.replay(handlers, true), std::runtime_error);
+    BOOST_CHECK_EQUAL(2, deserializer.root().size());
+}
+
+BOOST_AUTO_TEST_CASE(test_wtape)
+{
+    std::wistringstream is(L"{\"k\":[\"v\",1]}");
+    jsoncons::wjson_event_tape tape;
+    jsoncons::wjson_tape_recorder recorder(tape);
+    jsoncons::wjson_reader reader(is, recorder);
+    reader.read();
+
+    jsoncons::wjson_deserializer deserializer;
+    tape.replay(deserializer);
+    BOOST_CHECK(deserializer.root()[L"k"][0].as<std::wstring>() == L"v");
+    BOOST_CHECK_EQUAL(1, deserializer.root()[L"k"][1].as<int>());
+}
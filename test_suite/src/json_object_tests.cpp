@@ -9,6 +9,7 @@
 #include <utility>
 #include <ctime>
 #include <map>
+#include <thread>
 
 using jsoncons::pretty_print;
 using jsoncons::output_format;
@@ -297,3 +298,109 @@ BOOST_AUTO_TEST_CASE(test_json_object_iterator_3)
 }
 
 
+
+BOOST_AUTO_TEST_CASE(test_key_lookup)
+{
+    const json::key city("city");
+    const json::key country("country");
+    const json::key zip("zip");
+
+    json a = json::parse_string("{\"city\":\"Toronto\",\"country\":\"Canada\",\"province\":\"Ontario\"}");
+    json b = json::parse_string("{\"area\":630,\"city\":\"Montreal\",\"country\":\"Canada\"}");
+
+    BOOST_CHECK(a.has_member(city));
+    BOOST_CHECK(!a.has_member(zip));
+    BOOST_CHECK_EQUAL(a.at(city).as<std::string>(), "Toronto");
+    BOOST_CHECK_EQUAL(a.at(country).as<std::string>(), "Canada");
+
+    // The key's cached position from a is stale for b
+    BOOST_CHECK_EQUAL(b.at(city).as<std::string>(), "Montreal");
+    BOOST_CHECK_EQUAL(a.at(city).as<std::string>(), "Toronto");
+    BOOST_CHECK(b.get(zip).is_null());
+    BOOST_CHECK_THROW(b.at(zip), json_exception);
+
+    json::key city2(std::string("city"));
+    BOOST_CHECK(city == city2);
+    BOOST_CHECK(city != country);
+    BOOST_CHECK_EQUAL(city.hash(), city2.hash());
+    BOOST_CHECK_EQUAL(city.length(), 4);
+
+    json empty;
+    BOOST_CHECK(!empty.has_member(city));
+    BOOST_CHECK(empty.get(city).is_null());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_lookup_index)
+{
+    json o;
+    std::vector<json::key> keys;
+    for (int i = 0; i < 40; ++i)
+    {
+        std::string name = "m" + std::to_string(i);
+        o[name] = i;
+        keys.push_back(json::key(name));
+    }
+    const json& c = o;
+    const json::key missing("m40");
+
+    // Alternating keys miss their hints, so the object builds its index
+    for (int round = 0; round < 3; ++round)
+    {
+        for (size_t i = 0; i < keys.size(); i += 3)
+        {
+            BOOST_CHECK_EQUAL(static_cast<int>(i), c.at(keys[i]).as<int>());
+            BOOST_CHECK(!c.has_member(missing));
+        }
+    }
+    size_t indexed = o.memory_usage().objects;
+
+    // Adding or removing members drops the index
+    o["m40"] = 40;
+    o.remove_member("m0");
+    BOOST_CHECK(o.memory_usage().objects < indexed);
+    BOOST_CHECK_EQUAL(40, c.at(missing).as<int>());
+    BOOST_CHECK(!c.has_member(keys[0]));
+    for (size_t i = 1; i < keys.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<int>(i), c.at(keys[i]).as<int>());
+    }
+    BOOST_CHECK_EQUAL(40, c.at(missing).as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_lookup_const_concurrent)
+{
+    json o;
+    std::vector<json::key> keys;
+    for (int i = 0; i < 40; ++i)
+    {
+        std::string name = "m" + std::to_string(i);
+        o[name] = i;
+        keys.push_back(json::key(name));
+    }
+    const json& c = o;
+
+    // Const lookups only read the members, so threads may share the object
+    std::vector<std::thread> threads;
+    std::vector<int> sums(4, 0);
+    for (size_t t = 0; t < sums.size(); ++t)
+    {
+        threads.push_back(std::thread([&c, &keys, &sums, t]()
+        {
+            for (size_t i = t; i < keys.size(); i += 2)
+            {
+                if (c.has_member(keys[i]))
+                {
+                    sums[t] += c.at(keys[i]).as<int>() - c.get(keys[i]).as<int>() + 1;
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    for (size_t t = 0; t < sums.size(); ++t)
+    {
+        BOOST_CHECK_EQUAL(static_cast<int>((keys.size() - t + 1) / 2), sums[t]);
+    }
+}
@@ -9,6 +9,7 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <cmath>
 
 using jsoncons::parsing_context;
 using jsoncons::json_deserializer;
@@ -95,3 +96,241 @@ BOOST_AUTO_TEST_CASE(test_expected_value)
 
 
 
+
+BOOST_AUTO_TEST_CASE(test_lazy_numbers)
+{
+    std::istringstream is("{\"id\":123456789012345678901234567890,\"price\":1.10,\"count\":-7,\"n\":3}");
+
+    json_deserializer handler;
+    json_reader reader(is,handler);
+    reader.lazy_numbers(true);
+    reader.read();
+    json val = handler.root();
+
+    BOOST_CHECK(val["count"].is_number());
+    BOOST_CHECK(val["count"].is_longlong());
+    BOOST_CHECK_EQUAL(-7, val["count"].as<int>());
+    BOOST_CHECK(val["n"].is_ulonglong());
+    BOOST_CHECK_EQUAL(3, val["n"].as<long long>());
+    BOOST_CHECK(val["price"].is_double());
+    BOOST_CHECK_CLOSE(1.1, val["price"].as<double>(), 0.000001);
+    BOOST_CHECK(val["id"].is_double());
+
+    json n = val["n"];
+    BOOST_CHECK(n == json(3));
+    BOOST_CHECK(json(3.0) == n);
+
+    val["n"] = 4;
+    BOOST_CHECK_EQUAL(std::string("{\"count\":-7,\"id\":123456789012345678901234567890,\"n\":4,\"price\":1.10}"), val.to_string());
+
+    json copy = val;
+    BOOST_CHECK(copy == val);
+
+    json lazy = json::make_number("1e3",3);
+    BOOST_CHECK_EQUAL(1000.0, lazy.as<double>());
+    BOOST_CHECK_THROW(json::make_number("1e",2), jsoncons::json_exception);
+
+    std::istringstream bad("[1.]");
+    json_deserializer handler2;
+    json_reader reader2(bad,handler2);
+    reader2.lazy_numbers(true);
+    BOOST_CHECK_THROW(reader2.read(), json_parse_exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_number_storage)
+{
+    json small = json::make_number("-1.5e3",6);
+    BOOST_CHECK_EQUAL(size_t(0), small.memory_usage().strings);
+    BOOST_CHECK(small.is_double());
+    BOOST_CHECK_EQUAL(-1500.0, small.as<double>());
+    BOOST_CHECK_EQUAL(std::string("-1.5e3"), small.to_string());
+
+    json full = json::make_number("12345678",8);
+    BOOST_CHECK_EQUAL(size_t(0), full.memory_usage().strings);
+    BOOST_CHECK_EQUAL(std::string("12345678"), full.to_string());
+    BOOST_CHECK_EQUAL(12345678ULL, full.as<unsigned long long>());
+
+    json large = json::make_number("3.14159265358979",16);
+    BOOST_CHECK(large.memory_usage().strings > 0);
+    BOOST_CHECK_EQUAL(3.14159265358979, large.as<double>());
+    BOOST_CHECK_EQUAL(3.14159265358979, large.as<double>());
+    json large_copy = large;
+    BOOST_CHECK_EQUAL(3.14159265358979, large_copy.as<double>());
+    BOOST_CHECK(large_copy == large);
+    BOOST_CHECK_EQUAL(std::string("3.14159265358979"), large_copy.to_string());
+
+    json big = json::make_number("-123456789012345678901234567890",31);
+    BOOST_CHECK(big.is_double());
+    BOOST_CHECK_EQUAL(-1.2345678901234568e29, big.as<double>());
+    BOOST_CHECK(big == json(-1.2345678901234568e29));
+
+    json negative_zero = json::make_number("-0.0",4);
+    BOOST_CHECK(std::signbit(negative_zero.as<double>()));
+    BOOST_CHECK_EQUAL(0.1, json::make_number("1e-1",4).as<double>());
+    BOOST_CHECK_EQUAL(1.7976931348623157e308, json::make_number("1.7976931348623157e308",22).as<double>());
+
+    BOOST_CHECK(json::make_number("1.50",4) == json::make_number("1.5",3));
+    BOOST_CHECK(json::make_number("1.5",3) == json::make_number("15e-1",5));
+    BOOST_CHECK(json::make_number("10000000000",11) == json::make_number("1e10",4));
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_usage)
+{
+    std::string input = "{\"a rather long member name that is not a small string\":\"a rather long string value that is not small either\","
+                        "\"b\":[1,2,3],\"c\":[true,\"x\",{\"d\":null}]}";
+
+    jsoncons::json_allocation_counter counter;
+    jsoncons::json_allocation_counter::install(&counter);
+    json val = json::parse_string(input);
+    jsoncons::json_allocation_counter::uninstall();
+
+    jsoncons::json_memory_usage usage = val.memory_usage();
+    BOOST_CHECK(usage.strings > 0);
+    BOOST_CHECK(usage.keys > 0);
+    BOOST_CHECK(usage.objects > 0);
+    BOOST_CHECK(usage.arrays > 0);
+    BOOST_CHECK(usage.unused_capacity <= usage.arrays + usage.objects);
+    BOOST_CHECK_EQUAL(usage.total(), usage.strings + usage.arrays + usage.objects + usage.keys + usage.anys);
+
+    BOOST_CHECK(counter.count() > 0);
+    BOOST_CHECK(counter.bytes() >= usage.strings + usage.keys);
+
+    size_t count = counter.count();
+    json::parse_string(input);
+    BOOST_CHECK_EQUAL(count, counter.count());
+
+    json s("short");
+    BOOST_CHECK_EQUAL(0, json(1).memory_usage().total());
+    BOOST_CHECK(s.memory_usage().strings > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocation_counter_growth)
+{
+    typedef jsoncons::json_array_impl<char,std::allocator<char>> array_impl;
+    typedef jsoncons::json_object_impl<char,std::allocator<char>> object_impl;
+    const std::string long_name("a member name too long for the small string buffer");
+    const size_t long_name_size = long_name.capacity() + 1;
+
+    jsoncons::json_allocation_counter counter;
+    jsoncons::json_allocation_counter::install(&counter);
+
+    // Array construction, resize and insertion
+    json a = json::make_array(3);
+    BOOST_CHECK_EQUAL(2u, counter.count());
+    BOOST_CHECK_EQUAL(sizeof(array_impl) + 3*sizeof(json), counter.bytes());
+    a.resize_array(5);
+    size_t resized = a.capacity();
+    BOOST_CHECK_EQUAL(3u, counter.count());
+    BOOST_CHECK_EQUAL(sizeof(array_impl) + (3 + resized)*sizeof(json), counter.bytes());
+    a.add(0, json(true));
+    size_t added1 = a.capacity() != resized ? a.capacity() : 0;
+    a.add(0, json(false));
+    size_t added2 = a.capacity() != resized && a.capacity() != added1 ? a.capacity() : 0;
+    BOOST_CHECK(added1 != 0 || added2 != 0);
+    BOOST_CHECK_EQUAL(3u + (added1 != 0) + (added2 != 0), counter.count());
+    BOOST_CHECK_EQUAL(sizeof(array_impl) + (3 + resized + added1 + added2)*sizeof(json), counter.bytes());
+
+    // Object creation and member insertion, each insertion growing the members
+    counter.reset();
+    json o;
+    o.set(long_name, 1);
+    size_t members1 = o.capacity();
+    o.set("b", 2);
+    size_t members2 = o.capacity();
+    o.set("a", 3);
+    size_t members3 = o.capacity();
+    BOOST_CHECK(members1 < members2 && members2 < members3);
+    BOOST_CHECK_EQUAL(5u, counter.count());
+    BOOST_CHECK_EQUAL(sizeof(object_impl) + (members1 + members2 + members3)*sizeof(json::member_type) + long_name_size, counter.bytes());
+
+    // A copy of a known document allocates exactly what memory_usage reports
+    json doc = json::parse_string("{\"a member name too long for the small string buffer\":[1,true,\"x\"],\"b\":\"a string value\"}");
+    counter.reset();
+    json copy = doc;
+    jsoncons::json_memory_usage usage = copy.memory_usage();
+    BOOST_CHECK_EQUAL(0u, usage.unused_capacity);
+    BOOST_CHECK_EQUAL(sizeof(object_impl) + 2*sizeof(json::member_type), usage.objects);
+    BOOST_CHECK_EQUAL(long_name_size, usage.keys);
+    BOOST_CHECK_EQUAL(sizeof(array_impl) + 3*sizeof(json), usage.arrays);
+    BOOST_CHECK_EQUAL(usage.total(), counter.bytes());
+    // object, members, long name, array, elements and the two strings
+    BOOST_CHECK_EQUAL(7u, counter.count());
+
+    // Lookups that build an index of member names
+    json wide;
+    for (int i = 0; i < 10; ++i)
+    {
+        wide.set(std::string(1, static_cast<char>('a' + i)), i);
+    }
+    size_t objects = wide.memory_usage().objects;
+    counter.reset();
+    const json& c = wide;
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL(9, c.at(json::key("j")).as<int>());
+    }
+    BOOST_CHECK_EQUAL(2u, counter.count());
+    BOOST_CHECK_EQUAL(wide.memory_usage().objects - objects, counter.bytes());
+
+    jsoncons::json_allocation_counter::uninstall();
+}
+
+BOOST_AUTO_TEST_CASE(test_compact)
+{
+    json a(json::an_array);
+    a.reserve(100);
+    json o;
+    o.reserve(50);
+    o.set("x", 1);
+    a.add(o);
+    a.add(json::parse_string("[1,2,3]"));
+    BOOST_CHECK(a.memory_usage().unused_capacity > 0);
+    a.compact();
+    BOOST_CHECK_EQUAL(0, a.memory_usage().unused_capacity);
+    BOOST_CHECK(a == json::parse_string("[{\"x\":1},[1,2,3]]"));
+
+    json b(json::an_array);
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        json c(json::an_array);
+        c.reserve(10);
+        c.add(i);
+        b.add(std::move(c));
+    }
+    b.parallel_compact(4);
+    BOOST_CHECK_EQUAL(0, b.memory_usage().unused_capacity);
+    BOOST_CHECK_EQUAL(9999, b[9999][0].as<int>());
+
+    std::istringstream is("{\"a\":[1,2,3,4,5,6,7,8,9],\"b\":[\"x\",{\"c\":true}]}");
+    json_deserializer handler;
+    handler.shrink_to_fit(true);
+    json_reader reader(is, handler);
+    reader.read();
+    json d = std::move(handler.root());
+    BOOST_CHECK_EQUAL(0, d.memory_usage().unused_capacity);
+    BOOST_CHECK_EQUAL(9, d["a"].size());
+}
+
+BOOST_AUTO_TEST_CASE(test_static_dispatch)
+{
+    std::string text = "{\"a\":[1,-2,3.5,\"x\",true,false,null,{}],\"b\":{\"c\":[]}}";
+
+    json_deserializer handler;
+    std::istringstream is(text);
+    jsoncons::basic_json_reader<char,json_deserializer> reader(is, handler);
+    reader.read();
+    json val = std::move(handler.root());
+
+    json_deserializer virtual_handler;
+    std::istringstream is2(text);
+    json_reader virtual_reader(is2, virtual_handler);
+    virtual_reader.read();
+    BOOST_CHECK(val == virtual_handler.root());
+
+    std::ostringstream os;
+    {
+        jsoncons::json_serializer serializer(os);
+        val.walk(serializer);
+    }
+    BOOST_CHECK_EQUAL(text, os.str());
+}
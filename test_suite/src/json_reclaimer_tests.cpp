@@ -0,0 +1,63 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reclaimer.hpp"
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using jsoncons::json;
+using jsoncons::json_reclaimer;
+
+BOOST_AUTO_TEST_CASE(test_deeply_nested_destruction)
+{
+    json root(json::an_array);
+    json* p = &root;
+    for (size_t i = 0; i < 500000; ++i)
+    {
+        json val(json::an_object);
+        val["a"] = json(json::an_array);
+        p->add(std::move(val));
+        p = &p->at(0).at("a");
+    }
+    // root goes out of scope here, which must not exhaust the stack
+}
+
+BOOST_AUTO_TEST_CASE(test_nested_destruction_of_mixed_tree)
+{
+    // Containers before, between and after scalars, in arrays and objects
+    json root = json::parse_string("[{\"a\":[1,[],{}],\"b\":2,\"c\":{\"d\":[[3],4]}},[5,[6,[7]],\"e\"],{}]");
+    json* p = &root;
+    for (size_t i = 0; i < 100000; ++i)
+    {
+        json val = json::parse_string("[{\"x\":[1]},2,[]]");
+        p->add(std::move(val));
+        p->add(json(json::an_array));
+        p = &p->at(p->size() - 2);
+    }
+    BOOST_CHECK_EQUAL(5, root.size());
+    // root goes out of scope here, freeing every value once
+}
+
+BOOST_AUTO_TEST_CASE(test_json_reclaimer)
+{
+    json_reclaimer reclaimer;
+
+    json val = json::parse_string("{\"a\":[1,2,{\"b\":[3]}],\"c\":\"d\"}");
+    reclaimer.reclaim(val);
+    BOOST_CHECK(val.is_null());
+
+    json s("text");
+    reclaimer.reclaim(s);
+    BOOST_CHECK(s.is_null());
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        json a(json::an_array);
+        a.add(json::parse_string("{\"x\":[1,2,3]}"));
+        reclaimer.reclaim(std::move(a));
+    }
+    reclaimer.wait();
+}
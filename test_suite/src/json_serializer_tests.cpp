@@ -10,6 +10,7 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <cstdio>
 
 using jsoncons::json_serializer;
 using jsoncons::output_format;
@@ -43,3 +44,219 @@ BOOST_AUTO_TEST_CASE(test_direct_serialization)
 }
 
 
+
+BOOST_AUTO_TEST_CASE(test_output_sinks)
+{
+    json val = json::parse_string("{\"a\":[1,-2,3.5,\"x\\ny\"],\"b\":{\"c\":null,\"d\":true},\"e\":18446744073709551615}");
+    std::ostringstream os;
+    val.to_stream(os);
+    std::string expected = os.str();
+    BOOST_CHECK_EQUAL(expected, val.to_string());
+
+    std::string s;
+    jsoncons::string_sink ssink(s);
+    {
+        json_serializer serializer(ssink, true);
+        val.to_stream(serializer);
+    }
+    std::ostringstream pretty;
+    pretty << jsoncons::pretty_print(val);
+    BOOST_CHECK_EQUAL(pretty.str(), s);
+
+    char buf[16];
+    jsoncons::fixed_buffer_sink fsink(buf, sizeof(buf));
+    {
+        json_serializer serializer(fsink);
+        val.to_stream(serializer);
+    }
+    BOOST_CHECK(fsink.overflow());
+    BOOST_CHECK_EQUAL(sizeof(buf), fsink.length());
+    BOOST_CHECK_EQUAL(expected.substr(0, sizeof(buf)), std::string(buf, sizeof(buf)));
+
+    std::FILE* f = std::tmpfile();
+    BOOST_REQUIRE(f != nullptr);
+    jsoncons::fd_sink dsink(fileno(f));
+    {
+        json_serializer serializer(dsink);
+        val.to_stream(serializer);
+    }
+    std::rewind(f);
+    std::string read(expected.length() + 1, ' ');
+    size_t n = std::fread(&read[0], 1, read.length(), f);
+    std::fclose(f);
+    BOOST_CHECK_EQUAL(expected, read.substr(0, n));
+}
+
+BOOST_AUTO_TEST_CASE(test_output_buffer_growth)
+{
+    std::string s;
+    jsoncons::string_sink sink(s);
+    jsoncons::basic_output_buffer<char> buffer(sink);
+    std::string expected;
+
+    buffer.put('[');
+    expected.push_back('[');
+    buffer.flush();
+    BOOST_CHECK_EQUAL(expected, s);
+
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::string item = std::to_string(i) + ",";
+        buffer.write(item);
+        expected += item;
+    }
+    buffer.fill(' ', 20000);
+    expected.append(20000, ' ');
+    std::string big(40000, 'x');
+    buffer.write(big);
+    expected += big;
+    buffer.put(']');
+    expected.push_back(']');
+    buffer.flush();
+    BOOST_CHECK(expected == s);
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer_flushes_complete_values)
+{
+    std::ostringstream os;
+    json_serializer serializer(os);
+    json::parse_string("[1,2,3]").to_stream(serializer);
+    BOOST_CHECK_EQUAL("[1,2,3]", os.str());
+
+    std::string text(100000, 'a');
+    json(text).to_stream(serializer);
+    BOOST_CHECK_EQUAL(std::string("[1,2,3]\"") + text + "\"", os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_escape_string_runs)
+{
+    output_format format;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        std::string s(40, 'a');
+        s[i] = '"';
+        std::string expected = "\"" + std::string(i, 'a') + "\\\"" + std::string(39 - i, 'a') + "\"";
+        BOOST_CHECK_EQUAL(expected, json(s).to_string(format));
+
+        s[i] = '\x01';
+        expected = "\"" + std::string(i, 'a') + "\\u0001" + std::string(39 - i, 'a') + "\"";
+        BOOST_CHECK_EQUAL(expected, json(s).to_string(format));
+    }
+
+    std::string s = std::string(20, 'x') + "/\x7f\\\n\t" + std::string(20, 'y') + "\xc3\xa9";
+    BOOST_CHECK_EQUAL("\"" + std::string(20, 'x') + "/\\u007F\\\\\\n\\t" + std::string(20, 'y') + "\xc3\xa9\"", json(s).to_string(format));
+
+    format.escape_solidus(true);
+    format.escape_all_non_ascii(true);
+    BOOST_CHECK_EQUAL("\"" + std::string(20, 'x') + "\\/\\u007F\\\\\\n\\t" + std::string(20, 'y') + "\\u00E9\"", json(s).to_string(format));
+
+    jsoncons::woutput_format wformat;
+    std::wstring ws = std::wstring(20, L'x') + L"\"\x01" + std::wstring(20, L'y');
+    BOOST_CHECK(std::wstring(L"\"") + std::wstring(20, L'x') + L"\\\"\\u0001" + std::wstring(20, L'y') + L"\"" == wjson(ws).to_string(wformat));
+}
+
+BOOST_AUTO_TEST_CASE(test_integer_formatting)
+{
+    const long long values[] = {0, 7, -7, 10, 99, -100, 12345, 1000000007, 
+                                (std::numeric_limits<long long>::max)(), (std::numeric_limits<long long>::min)()};
+    for (long long v : values)
+    {
+        std::ostringstream os;
+        os << v;
+        BOOST_CHECK_EQUAL(os.str(), json(v).to_string());
+    }
+    BOOST_CHECK_EQUAL("18446744073709551615", json((std::numeric_limits<unsigned long long>::max)()).to_string());
+    BOOST_CHECK_EQUAL("[1,-22,333]", json::parse_string("[1,-22,333]").to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_to_stream)
+{
+    json a(json::an_array);
+    json o;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            a.add(json::parse_string("{\"x\":[1,2],\"y\":{\"z\":\"w\"}}"));
+        }
+        else if (i % 3 == 1)
+        {
+            a.add(json::parse_string("[true,null]"));
+        }
+        else
+        {
+            a.add(i);
+        }
+        o.set("k" + std::to_string(i), i % 2 == 0 ? json(json::an_array) : json(i * 0.5));
+    }
+    output_format format;
+    for (int indenting = 0; indenting <= 1; ++indenting)
+    {
+        std::ostringstream sequential;
+        a.to_stream(sequential, format, indenting != 0);
+        std::ostringstream parallel;
+        a.parallel_to_stream(parallel, format, indenting != 0, 4);
+        BOOST_CHECK(sequential.str() == parallel.str());
+
+        std::ostringstream sequential_object;
+        o.to_stream(sequential_object, format, indenting != 0);
+        std::ostringstream parallel_object;
+        o.parallel_to_stream(parallel_object, format, indenting != 0, 4);
+        BOOST_CHECK(sequential_object.str() == parallel_object.str());
+
+        // More chunks than the workers may hold ahead of the output at once
+        for (size_t threads = 2; threads <= 16; threads *= 2)
+        {
+            std::ostringstream windowed;
+            a.parallel_to_stream(windowed, format, indenting != 0, threads);
+            BOOST_CHECK(sequential.str() == windowed.str());
+        }
+    }
+
+    std::ostringstream small;
+    json::parse_string("[1,2,3]").parallel_to_stream(small, format, true, 4);
+    BOOST_CHECK_EQUAL("[1,2,3]", small.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_static_serializer_options)
+{
+    json val = json::parse_string("{\"a\":[1,2.5,\"x/\\u00e9\\n\"],\"b\":{\"c\":null,\"d\":[]}}");
+
+    std::ostringstream compact_expected;
+    {
+        json_serializer serializer(compact_expected, false);
+        val.to_stream(serializer);
+    }
+    std::ostringstream compact;
+    {
+        jsoncons::compact_json_serializer serializer(compact);
+        val.to_stream(serializer);
+    }
+    BOOST_CHECK_EQUAL(compact_expected.str(), compact.str());
+
+    std::ostringstream pretty_expected;
+    {
+        json_serializer serializer(pretty_expected, true);
+        val.to_stream(serializer);
+    }
+    std::ostringstream pretty;
+    {
+        jsoncons::pretty_json_serializer serializer(pretty);
+        val.to_stream(serializer);
+    }
+    BOOST_CHECK_EQUAL(pretty_expected.str(), pretty.str());
+
+    std::ostringstream ascii;
+    {
+        jsoncons::basic_json_serializer<char,jsoncons::static_serializer_options<false,true,true>> serializer(ascii);
+        val.to_stream(serializer);
+    }
+    BOOST_CHECK_EQUAL(std::string("{\"a\":[1,2.5,\"x\\/\\u00E9\\n\"],\"b\":{\"c\":null,\"d\":[]}}"), ascii.str());
+
+    // to_string and to_stream pick the variant matching the format
+    output_format format;
+    format.escape_all_non_ascii(true);
+    format.escape_solidus(true);
+    BOOST_CHECK_EQUAL(ascii.str(), val.to_string(format));
+    BOOST_CHECK_EQUAL(compact.str(), val.to_string());
+}
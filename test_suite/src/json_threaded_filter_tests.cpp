@@ -0,0 +1,111 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_serializer.hpp"
+#include "jsoncons/json_threaded_filter.hpp"
+#include <sstream>
+#include <string>
+
+using jsoncons::json;
+using jsoncons::json_reader;
+using jsoncons::json_deserializer;
+using jsoncons::json_serializer;
+using jsoncons::json_threaded_filter;
+using jsoncons::parsing_context;
+
+static std::string make_document()
+{
+    std::ostringstream os;
+    os << "{\"items\":[";
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        if (i > 0)
+        {
+            os << ",";
+        }
+        os << "{\"id\":" << i << ",\"neg\":-" << (i + 1) << ",\"x\":" << i << ".5,\"ok\":" << (i % 2 ? "true" : "false") 
+           << ",\"none\":null,\"name\":\"" << std::string(i % 300, 'a') << "\"}";
+    }
+    os << "]}";
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_threaded_filter_deserialize)
+{
+    std::string text = make_document();
+
+    json_deserializer handler;
+    json_threaded_filter filter(handler, 256); // small ring, so that strings wrap and both sides wait
+    std::istringstream is(text);
+    json_reader reader(is, filter);
+    reader.read();
+    filter.finish();
+
+    BOOST_CHECK(json::parse_string(text) == handler.root());
+}
+
+BOOST_AUTO_TEST_CASE(test_threaded_filter_serialize)
+{
+    std::string text = make_document();
+
+    std::ostringstream os;
+    {
+        json_serializer serializer(os);
+        json_threaded_filter filter(serializer);
+        std::istringstream is(text);
+        json_reader reader(is, filter);
+        reader.read();
+        filter.finish();
+    }
+    BOOST_CHECK_EQUAL(text, os.str());
+}
+
+class throwing_handler : public jsoncons::json_input_handler
+{
+private:
+    virtual void do_begin_json() {}
+    virtual void do_end_json() {}
+    virtual void do_begin_object(const parsing_context&) {}
+    virtual void do_end_object(const parsing_context&) {}
+    virtual void do_begin_array(const parsing_context&) {}
+    virtual void do_end_array(const parsing_context&) {}
+    virtual void do_name(const char*, size_t, const parsing_context&) {}
+    virtual void do_null_value(const parsing_context&) {}
+    virtual void do_string_value(const char*, size_t, const parsing_context&) {}
+    virtual void do_binary_value(const char*, size_t, const parsing_context&) {}
+    virtual void do_double_value(double, const parsing_context&) {}
+    virtual void do_longlong_value(long long, const parsing_context&) {}
+    virtual void do_ulonglong_value(unsigned long long value, const parsing_context&) 
+    {
+        if (value == 1000)
+        {
+            throw std::runtime_error("downstream failure");
+        }
+    }
+    virtual void do_bool_value(bool, const parsing_context&) {}
+};
+
+BOOST_AUTO_TEST_CASE(test_threaded_filter_downstream_exception)
+{
+    std::string text = make_document();
+
+    throwing_handler handler;
+    bool thrown = false;
+    try
+    {
+        json_threaded_filter filter(handler, 256);
+        std::istringstream is(text);
+        json_reader reader(is, filter);
+        reader.read();
+        filter.finish();
+    }
+    catch (const std::runtime_error& e)
+    {
+        thrown = std::string(e.what()) == "downstream failure";
+    }
+    BOOST_CHECK(thrown);
+}
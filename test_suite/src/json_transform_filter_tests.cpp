@@ -0,0 +1,99 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_deserializer.hpp"
+#include "jsoncons/json_serializer.hpp"
+#include "jsoncons/json_transform_filter.hpp"
+#include <sstream>
+#include <string>
+
+using jsoncons::json;
+using jsoncons::json_reader;
+using jsoncons::json_deserializer;
+using jsoncons::json_serializer;
+using jsoncons::json_transform_rules;
+using jsoncons::json_transform_filter;
+
+static json transform(const std::string& text, const json_transform_rules& rules)
+{
+    json_deserializer handler;
+    json_transform_filter filter(handler, rules);
+    std::istringstream is(text);
+    json_reader reader(is, filter);
+    reader.read();
+    return std::move(handler.root());
+}
+
+BOOST_AUTO_TEST_CASE(test_transform_rename_drop)
+{
+    json_transform_rules rules;
+    rules.rename("/records/*/cust_id", "customer_id")
+         .drop("/records/*/debug")
+         .drop("/meta");
+
+    json result = transform("{\"meta\":{\"a\":[1,{\"b\":2}]},\"records\":["
+                            "{\"cust_id\":1,\"debug\":{\"trace\":[1,2,3]},\"x\":\"a\"},"
+                            "{\"debug\":null,\"cust_id\":2}]}", rules);
+
+    BOOST_CHECK(!result.has_member("meta"));
+    BOOST_REQUIRE_EQUAL(2, result["records"].size());
+    BOOST_CHECK_EQUAL(1, result["records"][0]["customer_id"].as<int>());
+    BOOST_CHECK(!result["records"][0].has_member("cust_id"));
+    BOOST_CHECK(!result["records"][0].has_member("debug"));
+    BOOST_CHECK_EQUAL("a", result["records"][0]["x"].as<std::string>());
+    BOOST_CHECK_EQUAL(2, result["records"][1]["customer_id"].as<int>());
+    BOOST_CHECK_EQUAL(1, result["records"][1].size());
+}
+
+BOOST_AUTO_TEST_CASE(test_transform_to_number)
+{
+    json_transform_rules rules;
+    rules.to_number("/*/amount");
+
+    json result = transform("[{\"amount\":\"12.50\",\"id\":\"7\"},{\"amount\":\"n/a\"},{\"amount\":3}]", rules);
+    BOOST_CHECK(result[0]["amount"].is_number());
+    BOOST_CHECK_EQUAL(12.5, result[0]["amount"].as<double>());
+    BOOST_CHECK(result[0]["id"].is_string());
+    BOOST_CHECK(result[1]["amount"].is_string());
+    BOOST_CHECK_EQUAL(3, result[2]["amount"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_transform_flatten_inject)
+{
+    json_transform_rules rules;
+    rules.flatten("/address")
+         .flatten("/address/geo", "_")
+         .rename("/address/zip", "postcode")
+         .drop("/address/geo/accuracy")
+         .inject("", "version", json(2))
+         .inject("/address", "country", json("NZ"));
+
+    std::ostringstream os;
+    {
+        json_serializer serializer(os);
+        json_transform_filter filter(serializer, rules);
+        std::istringstream is("{\"name\":\"x\",\"address\":{\"city\":\"Wellington\",\"zip\":\"6011\","
+                              "\"geo\":{\"lat\":-41.3,\"accuracy\":5,\"lon\":174.8},\"lines\":[\"a\",\"b\"]},\"tags\":[]}");
+        json_reader reader(is, filter);
+        reader.read();
+    }
+    BOOST_CHECK_EQUAL("{\"name\":\"x\",\"address.city\":\"Wellington\",\"address.postcode\":\"6011\","
+                      "\"address.geo_lat\":-41.3,\"address.geo_lon\":174.8,\"address.lines\":[\"a\",\"b\"],"
+                      "\"address.country\":\"NZ\",\"tags\":[],\"version\":2}", os.str());
+
+    // Values other than objects are kept at a flatten path
+    json result = transform("{\"address\":\"unknown\"}", rules);
+    BOOST_CHECK_EQUAL("unknown", result["address"].as<std::string>());
+    BOOST_CHECK_EQUAL(2, result["version"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_transform_rule_errors)
+{
+    json_transform_rules rules;
+    BOOST_CHECK_THROW(rules.drop(""), jsoncons::json_exception);
+    BOOST_CHECK_THROW(rules.rename("a/b", "c"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(rules.drop("/a~2"), jsoncons::json_exception);
+}
@@ -0,0 +1,216 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons_ext/jsonpatch/jsonpatch.hpp"
+#include <string>
+#include <sstream>
+
+using jsoncons::json;
+using jsoncons::wjson;
+using jsoncons_ext::jsonpatch::apply_patch;
+using jsoncons_ext::jsonpatch::apply_merge_patch;
+
+BOOST_AUTO_TEST_CASE(test_patch_operations)
+{
+    json target = json::parse_string("{\"foo\":[\"bar\",\"baz\"],\"obj\":{\"a\":1,\"b\":2},\"x\":{\"y\":0}}");
+    json patch = json::parse_string(
+        "[{\"op\":\"add\",\"path\":\"/foo/1\",\"value\":\"qux\"},"
+        "{\"op\":\"add\",\"path\":\"/foo/-\",\"value\":\"end\"},"
+        "{\"op\":\"remove\",\"path\":\"/foo/0\"},"
+        "{\"op\":\"replace\",\"path\":\"/obj/a\",\"value\":10},"
+        "{\"op\":\"add\",\"path\":\"/obj/c\",\"value\":[1,2]},"
+        "{\"op\":\"remove\",\"path\":\"/obj/b\"},"
+        "{\"op\":\"move\",\"from\":\"/x/y\",\"path\":\"/obj/y\"},"
+        "{\"op\":\"copy\",\"from\":\"/obj/c\",\"path\":\"/copied\"},"
+        "{\"op\":\"test\",\"path\":\"/copied/1\",\"value\":2}]");
+    apply_patch(target, patch);
+
+    json expected = json::parse_string("{\"foo\":[\"qux\",\"baz\",\"end\"],\"obj\":{\"a\":10,\"c\":[1,2],\"y\":0},\"x\":{},\"copied\":[1,2]}");
+    BOOST_CHECK(expected == target);
+    // The patch was only read
+    BOOST_CHECK_EQUAL("qux", patch[0]["value"].as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(test_patch_batched_members)
+{
+    json target = json::parse_string("{\"config\":{\"m\":0,\"c\":0,\"x\":0}}");
+    json patch = json::make_array();
+    for (int i = 0; i < 26; ++i)
+    {
+        json op;
+        op["op"] = i % 5 == 0 ? "replace" : "add";
+        std::string name(1, static_cast<char>('z' - i));
+        if (i % 5 == 0)
+        {
+            name = i == 0 ? "m" : (i == 5 ? "c" : "x");
+        }
+        op["path"] = "/config/" + name;
+        op["value"] = i;
+        patch.add(op);
+    }
+    // The same name twice, and a path through a member set in the same run
+    patch.add(json::parse_string("{\"op\":\"add\",\"path\":\"/config/z\",\"value\":\"again\"}"));
+    patch.add(json::parse_string("{\"op\":\"add\",\"path\":\"/config/nested\",\"value\":{}}"));
+    patch.add(json::parse_string("{\"op\":\"add\",\"path\":\"/config/nested/k\",\"value\":true}"));
+    apply_patch(target, std::move(patch));
+
+    const json& config = target["config"];
+    BOOST_CHECK_EQUAL("again", config["z"].as<std::string>());
+    BOOST_CHECK_EQUAL(13, config["m"].as<int>());
+    BOOST_CHECK_EQUAL(23, config["c"].as<int>());
+    BOOST_CHECK_EQUAL(25, config["x"].as<int>());
+    BOOST_CHECK(config["nested"]["k"].as<bool>());
+    std::string previous;
+    for (auto it = config.begin_members(); it != config.end_members(); ++it)
+    {
+        BOOST_CHECK(previous < it->name());
+        previous = it->name();
+    }
+    BOOST_CHECK(config.has_member("b"));
+    BOOST_CHECK_EQUAL(22, config.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_patch_errors)
+{
+    json target = json::parse_string("{\"a\":{\"b\":1}}");
+
+    json missing = json::parse_string("[{\"op\":\"add\",\"path\":\"/a/c\",\"value\":2},{\"op\":\"replace\",\"path\":\"/a/nope\",\"value\":3}]");
+    BOOST_CHECK_THROW(apply_patch(target, missing), jsoncons::json_exception);
+    // The patch is applied as a whole or not at all
+    BOOST_CHECK(json::parse_string("{\"a\":{\"b\":1}}") == target);
+
+    json failed_test = json::parse_string("[{\"op\":\"test\",\"path\":\"/a/b\",\"value\":2}]");
+    BOOST_CHECK_THROW(apply_patch(target, failed_test), jsoncons::json_exception);
+
+    json into_itself = json::parse_string("[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a/b/c\"}]");
+    BOOST_CHECK_THROW(apply_patch(target, into_itself), jsoncons::json_exception);
+
+    // A move to a place that cannot be added to leaves the source in place
+    json bad_move = json::parse_string("[{\"op\":\"move\",\"from\":\"/a/b\",\"path\":\"/nope/b\"}]");
+    BOOST_CHECK_THROW(apply_patch(target, bad_move), jsoncons::json_exception);
+    BOOST_CHECK_EQUAL(1, target["a"]["b"].as<int>());
+
+    json bad_index = json::parse_string("[{\"op\":\"add\",\"path\":\"/list/01\",\"value\":2}]");
+    target["list"] = json::make_array();
+    BOOST_CHECK_THROW(apply_patch(target, bad_index), jsoncons::json_exception);
+
+    // Indexes at the destination are those after the source is removed
+    target["list"] = json::parse_string("[1,2,3]");
+    json past_end = json::parse_string("[{\"op\":\"move\",\"from\":\"/list/0\",\"path\":\"/list/3\"}]");
+    BOOST_CHECK_THROW(apply_patch(target, past_end), jsoncons::json_exception);
+    BOOST_CHECK(target.at("list") == json::parse_string("[1,2,3]"));
+    json to_end = json::parse_string("[{\"op\":\"move\",\"from\":\"/list/0\",\"path\":\"/list/2\"}]");
+    apply_patch(target, to_end);
+    BOOST_CHECK(target.at("list") == json::parse_string("[2,3,1]"));
+    target["list"] = json::parse_string("[1,{\"x\":2},[3]]");
+    json through_shift = json::parse_string("[{\"op\":\"move\",\"from\":\"/list/0\",\"path\":\"/list/1/0\"}]");
+    apply_patch(target, through_shift);
+    BOOST_CHECK(target.at("list") == json::parse_string("[{\"x\":2},[1,3]]"));
+
+    json unknown = json::parse_string("[{\"op\":\"frobnicate\",\"path\":\"/a\"}]");
+    BOOST_CHECK_THROW(apply_patch(target, unknown), jsoncons::json_exception);
+
+    json escaped = json::parse_string("[{\"op\":\"add\",\"path\":\"/a~1b\",\"value\":1},{\"op\":\"add\",\"path\":\"/m~0n\",\"value\":2}]");
+    apply_patch(target, escaped);
+    BOOST_CHECK_EQUAL(1, target["a/b"].as<int>());
+    BOOST_CHECK_EQUAL(2, target["m~n"].as<int>());
+
+    json root = json::parse_string("[{\"op\":\"replace\",\"path\":\"\",\"value\":[1]}]");
+    apply_patch(target, root);
+    BOOST_CHECK(target.is_array());
+}
+
+BOOST_AUTO_TEST_CASE(test_patch_rolled_back)
+{
+    const std::string original = 
+        "{\"list\":[1,{\"x\":2},[3]],\"obj\":{\"a\":1,\"b\":{\"c\":[4,5]}},\"s\":\"text\"}";
+    json target = json::parse_string(original);
+
+    // Every kind of operation, then a test that fails
+    json patch = json::parse_string(
+        "[{\"op\":\"add\",\"path\":\"/list/1\",\"value\":\"new\"},"
+        "{\"op\":\"add\",\"path\":\"/list/-\",\"value\":9},"
+        "{\"op\":\"remove\",\"path\":\"/list/0\"},"
+        "{\"op\":\"replace\",\"path\":\"/obj/a\",\"value\":10},"
+        "{\"op\":\"add\",\"path\":\"/obj/z\",\"value\":11},"
+        "{\"op\":\"add\",\"path\":\"/obj/a\",\"value\":12},"
+        "{\"op\":\"move\",\"from\":\"/obj/b/c\",\"path\":\"/list/1/x\"},"
+        "{\"op\":\"move\",\"from\":\"/s\",\"path\":\"/obj/b/s\"},"
+        "{\"op\":\"copy\",\"from\":\"/obj\",\"path\":\"/copy\"},"
+        "{\"op\":\"remove\",\"path\":\"/obj/b\"},"
+        "{\"op\":\"test\",\"path\":\"/copy/a\",\"value\":0}]");
+    BOOST_CHECK_THROW(apply_patch(target, patch), jsoncons::json_exception);
+    BOOST_CHECK(json::parse_string(original) == target);
+
+    // Without the failing test the same operations are applied
+    patch.remove_range(patch.size() - 1, patch.size());
+    apply_patch(target, patch);
+    BOOST_CHECK(json::parse_string("{\"list\":[\"new\",{\"x\":[4,5]},[3],9],\"obj\":{\"a\":12,\"z\":11},"
+                                   "\"copy\":{\"a\":12,\"b\":{\"s\":\"text\"},\"z\":11}}") == target);
+
+    // A replaced root and a move out of it are restored
+    target = json::parse_string(original);
+    json root = json::parse_string(
+        "[{\"op\":\"move\",\"from\":\"/obj/b\",\"path\":\"\"},"
+        "{\"op\":\"remove\",\"path\":\"/nope\"}]");
+    BOOST_CHECK_THROW(apply_patch(target, root), jsoncons::json_exception);
+    BOOST_CHECK(json::parse_string(original) == target);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_patch)
+{
+    // The example of RFC 7386
+    json target = json::parse_string(
+        "{\"title\":\"Goodbye!\",\"author\":{\"givenName\":\"John\",\"familyName\":\"Doe\"},"
+        "\"tags\":[\"example\",\"sample\"],\"content\":\"This will be unchanged\"}");
+    json patch = json::parse_string(
+        "{\"title\":\"Hello!\",\"phoneNumber\":\"+01-555-1234\",\"author\":{\"familyName\":null},"
+        "\"tags\":[\"example\"],\"extra\":{\"keep\":1,\"drop\":null}}");
+    apply_merge_patch(target, patch);
+
+    json expected = json::parse_string(
+        "{\"title\":\"Hello!\",\"author\":{\"givenName\":\"John\"},\"tags\":[\"example\"],"
+        "\"content\":\"This will be unchanged\",\"phoneNumber\":\"+01-555-1234\",\"extra\":{\"keep\":1}}");
+    BOOST_CHECK(expected == target);
+
+    json scalar = json::parse_string("{\"a\":[1]}");
+    apply_merge_patch(scalar, json(json::parse_string("[2]")));
+    BOOST_CHECK(scalar.is_array());
+
+    json not_object(1);
+    apply_merge_patch(not_object, json::parse_string("{\"a\":{\"b\":null,\"c\":2}}"));
+    BOOST_CHECK(json::parse_string("{\"a\":{\"c\":2}}") == not_object);
+}
+
+BOOST_AUTO_TEST_CASE(test_wjson_patch)
+{
+    wjson target = wjson::parse_string(L"{\"a\":1}");
+    apply_patch(target, wjson::parse_string(L"[{\"op\":\"add\",\"path\":\"/b\",\"value\":2},{\"op\":\"remove\",\"path\":\"/a\"}]"));
+    apply_merge_patch(target, wjson::parse_string(L"{\"c\":3}"));
+    BOOST_CHECK(wjson::parse_string(L"{\"b\":2,\"c\":3}") == target);
+}
+
+BOOST_AUTO_TEST_CASE(test_set_and_remove_members)
+{
+    json obj = json::parse_string("{\"b\":1,\"d\":2,\"f\":3}");
+    std::vector<std::pair<std::string,json>> members;
+    members.push_back(std::make_pair(std::string("e"), json(5)));
+    members.push_back(std::make_pair(std::string("a"), json(0)));
+    members.push_back(std::make_pair(std::string("d"), json(20)));
+    members.push_back(std::make_pair(std::string("a"), json(1)));
+    obj.set_members(std::move(members));
+    BOOST_CHECK(json::parse_string("{\"a\":1,\"b\":1,\"d\":20,\"e\":5,\"f\":3}") == obj);
+
+    std::vector<std::string> names;
+    names.push_back("f");
+    names.push_back("a");
+    names.push_back("zz");
+    obj.remove_members(names);
+    BOOST_CHECK(json::parse_string("{\"b\":1,\"d\":20,\"e\":5}") == obj);
+
+    // A name that is not there removes nothing
+    obj.remove_member("c");
+    BOOST_CHECK_EQUAL(3, obj.size());
+}
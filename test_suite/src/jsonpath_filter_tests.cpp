@@ -0,0 +1,192 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons/json_reader.hpp"
+#include "jsoncons/json_serializer.hpp"
+#include "jsoncons_ext/jsonpath/jsonpath_filter.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jsoncons::json;
+using jsoncons::json_reader;
+using jsoncons::json_serializer;
+using jsoncons_ext::jsonpath::jsonpath_filter;
+using jsoncons_ext::jsonpath::jsonpath_expression;
+
+static const std::string store = 
+    "{\"store\":{\"book\":["
+    "{\"category\":\"reference\",\"author\":\"Nigel Rees\",\"price\":8.95},"
+    "{\"category\":\"fiction\",\"author\":\"Evelyn Waugh\",\"price\":12.99},"
+    "{\"category\":\"fiction\",\"author\":\"Herman Melville\",\"isbn\":\"0-553-21311-3\",\"price\":8.99},"
+    "{\"category\":\"fiction\",\"author\":\"J. R. R. Tolkien\",\"isbn\":\"0-395-19395-8\",\"price\":22.99}"
+    "],\"bicycle\":{\"color\":\"red\",\"price\":19.95}}}";
+
+struct match_collector
+{
+    std::vector<std::string> paths;
+    std::vector<json> values;
+
+    void operator()(const std::string& path, json& val)
+    {
+        paths.push_back(path);
+        values.push_back(std::move(val));
+    }
+};
+
+static match_collector select(const std::string& text, const std::string& path)
+{
+    match_collector matches;
+    jsonpath_filter filter(path, [&](const std::string& p, json& val){matches(p, val);});
+    std::istringstream is(text);
+    json_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK_EQUAL(matches.values.size(), filter.count());
+    return matches;
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_child)
+{
+    match_collector m = select(store, "$.store.bicycle.color");
+    BOOST_REQUIRE_EQUAL(1, m.values.size());
+    BOOST_CHECK_EQUAL("$['store']['bicycle']['color']", m.paths[0]);
+    BOOST_CHECK_EQUAL("red", m.values[0].as<std::string>());
+
+    m = select(store, "$['store']['bicycle']");
+    BOOST_REQUIRE_EQUAL(1, m.values.size());
+    BOOST_CHECK_CLOSE(19.95, m.values[0]["price"].as<double>(), 0.000001);
+
+    m = select(store, "$.store.missing");
+    BOOST_CHECK_EQUAL(0, m.values.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_wildcard)
+{
+    match_collector m = select(store, "$.store.book[*].author");
+    BOOST_REQUIRE_EQUAL(4, m.values.size());
+    BOOST_CHECK_EQUAL("Nigel Rees", m.values[0].as<std::string>());
+    BOOST_CHECK_EQUAL("J. R. R. Tolkien", m.values[3].as<std::string>());
+    BOOST_CHECK_EQUAL("$['store']['book'][3]['author']", m.paths[3]);
+
+    m = select(store, "$.store.*");
+    BOOST_REQUIRE_EQUAL(2, m.values.size());
+    BOOST_CHECK(m.values[0].is_array());
+    BOOST_CHECK(m.values[1].is_object());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_index_slice_union)
+{
+    match_collector m = select(store, "$.store.book[2].isbn");
+    BOOST_REQUIRE_EQUAL(1, m.values.size());
+    BOOST_CHECK_EQUAL("0-553-21311-3", m.values[0].as<std::string>());
+
+    m = select(store, "$.store.book[1:3].price");
+    BOOST_REQUIRE_EQUAL(2, m.values.size());
+    BOOST_CHECK_CLOSE(12.99, m.values[0].as<double>(), 0.000001);
+    BOOST_CHECK_CLOSE(8.99, m.values[1].as<double>(), 0.000001);
+
+    m = select(store, "$.store.book[::2].author");
+    BOOST_REQUIRE_EQUAL(2, m.values.size());
+    BOOST_CHECK_EQUAL("Herman Melville", m.values[1].as<std::string>());
+
+    m = select(store, "$.store.book[0,3]['author','price']");
+    BOOST_REQUIRE_EQUAL(4, m.values.size());
+    BOOST_CHECK_EQUAL("$['store']['book'][3]['price']", m.paths[3]);
+
+    m = select("[[1,2],[3,4],[5,6]]", "$[*][1]");
+    BOOST_REQUIRE_EQUAL(3, m.values.size());
+    BOOST_CHECK_EQUAL(6, m.values[2].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_root)
+{
+    match_collector m = select(store, "$");
+    BOOST_REQUIRE_EQUAL(1, m.values.size());
+    BOOST_CHECK_EQUAL("$", m.paths[0]);
+    BOOST_CHECK(m.values[0] == json::parse_string(store));
+
+    m = select("\"text\"", "$");
+    BOOST_REQUIRE_EQUAL(1, m.values.size());
+    BOOST_CHECK_EQUAL("text", m.values[0].as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_forward)
+{
+    std::ostringstream os;
+    json_serializer serializer(os);
+    jsonpath_filter filter("$.store.book[*].category", serializer);
+    std::istringstream is(store);
+    json_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK_EQUAL(4, filter.count());
+    BOOST_CHECK_EQUAL("[\"reference\",\"fiction\",\"fiction\",\"fiction\"]", os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_output_handler)
+{
+    std::ostringstream os;
+    json_serializer serializer(os);
+    jsonpath_filter filter("$.a[*]", serializer);
+    std::istringstream is("{\"a\":[1,2,{\"b\":3},\"x\"]}");
+    json_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK_EQUAL(4, filter.count());
+    BOOST_CHECK_EQUAL("[1,2,{\"b\":3},\"x\"]", os.str());
+    BOOST_CHECK(json::parse_string(os.str()) == json::parse_string("[1,2,{\"b\":3},\"x\"]"));
+
+    std::ostringstream none;
+    json_serializer empty_serializer(none);
+    jsonpath_filter no_match("$.b", empty_serializer);
+    std::istringstream is2("{\"a\":[1,2]}");
+    json_reader reader2(is2, no_match);
+    reader2.read();
+    BOOST_CHECK_EQUAL(0, no_match.count());
+    BOOST_CHECK_EQUAL("[]", none.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_filter_large_array)
+{
+    std::ostringstream os;
+    os << "{\"rows\":[";
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        if (i > 0)
+        {
+            os << ",";
+        }
+        os << "{\"id\":" << i << ",\"tags\":[\"a\",\"b\"],\"nested\":{\"id\":-1}}";
+    }
+    os << "]}";
+
+    size_t count = 0;
+    long long sum = 0;
+    jsonpath_filter filter("$.rows[100:200:10].id", [&](const std::string&, json& val)
+    {
+        ++count;
+        sum += val.as<long long>();
+    });
+    std::istringstream is(os.str());
+    json_reader reader(is, filter);
+    reader.read();
+    BOOST_CHECK_EQUAL(10, count);
+    BOOST_CHECK_EQUAL(1450, sum);
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_compile_errors)
+{
+    BOOST_CHECK_THROW(jsonpath_expression::compile("store.book"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath_expression::compile("$.store[1"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath_expression::compile("$[::0]"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath_expression::compile("$[?(@.price < 10)]"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath_expression::compile("$['a"), jsoncons::json_exception);
+
+    jsonpath_expression expr = jsonpath_expression::compile("$..book[-1:]");
+    BOOST_CHECK_EQUAL(2, expr.size());
+    BOOST_CHECK(expr.has_recursive_descent());
+    BOOST_CHECK(expr.requires_length());
+
+    BOOST_CHECK_THROW(jsonpath_filter("$..author", [](const std::string&, json&){}), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath_filter("$.book[-1]", [](const std::string&, json&){}), jsoncons::json_exception);
+}
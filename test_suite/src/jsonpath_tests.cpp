@@ -0,0 +1,163 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include "jsoncons/json.hpp"
+#include "jsoncons_ext/jsonpath/jsonpath.hpp"
+#include "jsoncons_ext/jsonpointer/jsonpointer.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+
+using jsoncons::json;
+using jsoncons_ext::jsonpath::jsonpath;
+using jsoncons_ext::jsonpath::jsonpath_cache;
+using jsoncons_ext::jsonpointer::json_pointer;
+using jsoncons_ext::jsonpointer::json_pointer_cache;
+
+static json make_store()
+{
+    return json::parse_string(
+        "{\"store\":{\"book\":["
+        "{\"category\":\"reference\",\"author\":\"Nigel Rees\",\"price\":8.95},"
+        "{\"category\":\"fiction\",\"author\":\"Evelyn Waugh\",\"price\":12.99},"
+        "{\"category\":\"fiction\",\"author\":\"Herman Melville\",\"isbn\":\"0-553-21311-3\",\"price\":8.99},"
+        "{\"category\":\"fiction\",\"author\":\"J. R. R. Tolkien\",\"isbn\":\"0-395-19395-8\",\"price\":22.99}"
+        "],\"bicycle\":{\"color\":\"red\",\"price\":19.95}},"
+        "\"a/b\":1,\"m~n\":2,\"\":3}");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_pointer)
+{
+    json doc = make_store();
+
+    BOOST_CHECK(&json_pointer::compile("").get(doc) == &doc);
+    BOOST_CHECK_EQUAL("red", json_pointer::compile("/store/bicycle/color").get(doc).as<std::string>());
+    BOOST_CHECK_EQUAL("Herman Melville", json_pointer::compile("/store/book/2/author").get(doc).as<std::string>());
+    BOOST_CHECK_EQUAL(1, json_pointer::compile("/a~1b").get(doc).as<int>());
+    BOOST_CHECK_EQUAL(2, json_pointer::compile("/m~0n").get(doc).as<int>());
+    BOOST_CHECK_EQUAL(3, json_pointer::compile("/").get(doc).as<int>());
+
+    BOOST_CHECK(json_pointer::compile("/store/book/4").find(doc) == nullptr);
+    BOOST_CHECK(json_pointer::compile("/store/book/-").find(doc) == nullptr);
+    BOOST_CHECK(json_pointer::compile("/store/book/01").find(doc) == nullptr);
+    BOOST_CHECK(json_pointer::compile("/store/bicycle/color/x").find(doc) == nullptr);
+    BOOST_CHECK_THROW(json_pointer::compile("/store/missing").get(doc), jsoncons::json_exception);
+    BOOST_CHECK_THROW(json_pointer::compile("store"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(json_pointer::compile("/a~2"), jsoncons::json_exception);
+
+    // Results refer into the document
+    json_pointer price = json_pointer::compile("/store/bicycle/price");
+    price.get(doc) = 15.0;
+    BOOST_CHECK_EQUAL(15.0, doc["store"]["bicycle"]["price"].as<double>());
+
+    const json& cdoc = doc;
+    BOOST_CHECK(price.find(cdoc) == &cdoc.at("store").at("bicycle").at("price"));
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_select)
+{
+    json doc = make_store();
+
+    std::vector<json*> authors = jsonpath::compile("$.store.book[*].author").select(doc);
+    BOOST_REQUIRE_EQUAL(4, authors.size());
+    BOOST_CHECK_EQUAL("Nigel Rees", authors[0]->as<std::string>());
+    BOOST_CHECK(authors[3] == &doc.at("store").at("book").at(3).at("author"));
+
+    BOOST_CHECK_EQUAL(5, jsonpath::compile("$..price").select(doc).size());
+    BOOST_CHECK_EQUAL(2, jsonpath::compile("$..isbn").select(doc).size());
+
+    std::vector<json*> last = jsonpath::compile("$.store.book[-1].author").select(doc);
+    BOOST_REQUIRE_EQUAL(1, last.size());
+    BOOST_CHECK_EQUAL("J. R. R. Tolkien", last[0]->as<std::string>());
+
+    std::vector<json*> reversed = jsonpath::compile("$.store.book[::-1].price").select(doc);
+    BOOST_REQUIRE_EQUAL(4, reversed.size());
+    BOOST_CHECK_EQUAL(22.99, reversed[0]->as<double>());
+    BOOST_CHECK_EQUAL(8.95, reversed[3]->as<double>());
+
+    std::vector<json*> tail = jsonpath::compile("$.store.book[-2:].price").select(doc);
+    BOOST_REQUIRE_EQUAL(2, tail.size());
+    BOOST_CHECK_EQUAL(8.99, tail[0]->as<double>());
+
+    BOOST_CHECK_EQUAL(2, jsonpath::compile("$.store.book[0:10:2]").select(doc).size());
+    BOOST_CHECK_EQUAL(2, jsonpath::compile("$.store['bicycle','missing','book']").select(doc).size());
+    BOOST_CHECK_EQUAL(0, jsonpath::compile("$.store.bicycle[0]").select(doc).size());
+
+    // Writes through the selected references
+    std::vector<json*> prices = jsonpath::compile("$.store.book[*].price").select(doc);
+    for (size_t i = 0; i < prices.size(); ++i)
+    {
+        *prices[i] = 1.0;
+    }
+    BOOST_CHECK_EQUAL(1.0, doc["store"]["book"][2]["price"].as<double>());
+
+    const json& cdoc = doc;
+    std::vector<const json*> colors = jsonpath::compile("$.store.*.color").select(cdoc);
+    BOOST_REQUIRE_EQUAL(1, colors.size());
+    BOOST_CHECK_EQUAL("red", colors[0]->as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_select_first)
+{
+    json doc = make_store();
+
+    jsonpath path = jsonpath::compile("$.store.book[2].isbn");
+    BOOST_REQUIRE(path.select_first(doc) != nullptr);
+    BOOST_CHECK_EQUAL("0-553-21311-3", path.select_first(doc)->as<std::string>());
+    BOOST_CHECK(jsonpath::compile("$.store.book[0].isbn").select_first(doc) == nullptr);
+    BOOST_CHECK_EQUAL("Evelyn Waugh", jsonpath::compile("$..author").select(doc)[1]->as<std::string>());
+    BOOST_CHECK_EQUAL("Nigel Rees", jsonpath::compile("$..author").select_first(doc)->as<std::string>());
+}
+
+BOOST_AUTO_TEST_CASE(test_jsonpath_index_out_of_range)
+{
+    BOOST_CHECK_THROW(jsonpath::compile("$.a[20000000000000000000]"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath::compile("$.a[9223372036854775808]"), jsoncons::json_exception);
+    BOOST_CHECK_THROW(jsonpath::compile("$.a[-9223372036854775808:]"), jsoncons::json_exception);
+    jsonpath::compile("$.a[9223372036854775807]");
+    jsonpath::compile("$.a[-9223372036854775807:]");
+}
+
+BOOST_AUTO_TEST_CASE(test_path_caches)
+{
+    json doc = make_store();
+
+    jsonpath_cache paths(2);
+    std::shared_ptr<const jsonpath> p1 = paths.get("$.store.bicycle.color");
+    BOOST_CHECK(p1 == paths.get("$.store.bicycle.color"));
+    paths.get("$.store.book[*]");
+    paths.get("$..price");
+    BOOST_CHECK_EQUAL(2, paths.size());
+    BOOST_CHECK(p1 != paths.get("$.store.bicycle.color"));
+    BOOST_CHECK_EQUAL("red", p1->select_first(doc)->as<std::string>());
+    BOOST_CHECK_THROW(paths.get("$["), jsoncons::json_exception);
+
+    json_pointer_cache pointers;
+    std::vector<std::thread> threads;
+    std::vector<size_t> found(4, 0);
+    const json& cdoc = doc;
+    for (size_t t = 0; t < found.size(); ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                std::string path = "/store/book/" + std::to_string(i % 4) + "/price";
+                if (pointers.get(path)->find(cdoc) != nullptr)
+                {
+                    ++found[t];
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    for (size_t t = 0; t < found.size(); ++t)
+    {
+        BOOST_CHECK_EQUAL(1000, found[t]);
+    }
+    BOOST_CHECK_EQUAL(4, pointers.size());
+}